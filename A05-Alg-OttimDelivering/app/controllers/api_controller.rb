@@ -1,10 +1,8 @@
 require 'rubygems'
 require 'sii_mobility_api'
-require 'rosemary'
 
 
 class ApiController < ApplicationController
-  @@semaphore = Mutex.new
   module Validator
     def validate_input
       controller_name = params['controller'].split('/').last
@@ -111,20 +109,11 @@ class ApiController < ApplicationController
     c * 6371 * 1000
   end
 
-  def find_nid(lon, lat)
-    api = Rosemary::Api.new
-    epsilon = 0.002
-    bb = api.find_bounding_box(lon - epsilon, lat - epsilon, lon + epsilon, lat + epsilon)
-    nd = []
-    bb.ways.each do |way|
-      if way.tags.key?("highway")
-         nd += way.nodes
-      end
-    end
-    nodes = bb.nodes.select{ |node| nd.include?(node.id) }
-    dists = nodes.map{ |node| distance_between([node.lon, lon, node.lat, lat]) }
-    nidx  = dists.index( dists.min )
-    nodes[nidx].id.to_s
+  # node of the model of optimization nearest to lon, lat, nil when no
+  # road of the model is near
+  def find_nid(lon, lat, optimization)
+    nearest = $routePlanner.nearest(lon.to_f, lat.to_f, optimization)
+    nearest && nearest["node_id"]
   end
 
   def to_geojson(routes)
@@ -162,34 +151,35 @@ class ApiController < ApplicationController
   end
 
   def route_optimization
-    @@semaphore.synchronize do
-      #routePlanner = RoutePlanner.new
-
-      if @json_data[:journey][:source_node].key?("node_id")
-        source = @json_data[:journey][:source_node][:node_id]
-      else
-        source = find_nid(
-          @json_data[:journey][:source_node][:lon],
-          @json_data[:journey][:source_node][:lat])
-      end
-
-      if @json_data[:journey][:destination_node].key?("node_id")
-        target = @json_data[:journey][:destination_node][:node_id]
-      else
-        target = find_nid(
-          @json_data[:journey][:destination_node][:lon],
-          @json_data[:journey][:destination_node][:lat])
-      end
-
-      routes = Array.new
-      routes = $routePlanner.route_optimization(
-          @json_data[:journey][:search_route_type],
-          source,
-          target,
-          @json_data[:journey][:start_datetime],
-          "data/osm/pbf/bounding_box_tuscany.pbf",
-          "data/gtfs/filename.gtfs")
+    # $routePlanner is thread-safe, searches run outside the GVL
+    #routePlanner = RoutePlanner.new
+
+    journey      = @json_data[:journey]
+    optimization = journey[:search_route_type]
+    source_node  = journey[:source_node]
+    target_node  = journey[:destination_node]
+
+    unless source_node.key?("node_id") || target_node.key?("node_id")
+      return $routePlanner.route_optimization_by_coordinates(
+        optimization,
+        source_node[:lon].to_f, source_node[:lat].to_f,
+        target_node[:lon].to_f, target_node[:lat].to_f,
+        journey[:start_datetime])
     end
+
+    source = source_node.key?("node_id") ? source_node[:node_id] :
+      find_nid(source_node[:lon], source_node[:lat], optimization)
+    target = target_node.key?("node_id") ? target_node[:node_id] :
+      find_nid(target_node[:lon], target_node[:lat], optimization)
+    return [] if source.nil? || target.nil?
+
+    $routePlanner.route_optimization(
+        optimization,
+        source,
+        target,
+        journey[:start_datetime],
+        "data/osm/pbf/bounding_box_tuscany.pbf",
+        "data/gtfs/filename.gtfs")
   end
 
   def shortest_path
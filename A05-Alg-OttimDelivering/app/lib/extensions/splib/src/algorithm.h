@@ -34,6 +34,7 @@
 #include "graph/graph_edge_weight_traits.h" 
 #include "graph/graph_stopping_criteria.h"
 #include "graph/graph_heuristic.h"
+#include "graph/graph_search_workspace.h"
 
 namespace gol {
 
@@ -53,8 +54,7 @@ template <
   typename GraphT,
   typename Vertex, 
   //typename Heuristic, 
-  typename PredMap, 
-  typename DistanceMap, 
+  typename Workspace, 
   typename WeightMap,
   //typename Compare,  
   typename Visitor,  
@@ -64,12 +64,27 @@ template <
       Vertex       s, 
       Vertex       t, 
       //Heuristic    h, 
-      PredMap&     pred_map, 
-      DistanceMap& distance_map, 
+      Workspace&   workspace, 
       WeightMap&   weight_map,
       Visitor&     visitor,  
       Stats&       stats);
 
+  // label-setting search from s, only the vertices reached are 
+  // initialized; true when the visitor stopped it, see 
+  // graph_stopping_criteria.h
+  template < 
+    typename GraphT, 
+    typename Vertex, 
+    typename Workspace, 
+    typename WeightMap, 
+    typename Visitor >
+  static bool search(
+      GraphT&     g, 
+      Vertex      s,
+      Workspace&  workspace,
+      WeightMap&  weight,
+      Visitor&    vis);  
+
  private:
   dijkstra_algorithm();
   ~dijkstra_algorithm();
@@ -86,8 +101,7 @@ template <
   typename GraphT,
   typename Vertex, 
   //typename Heuristic, 
-  typename PredMap, 
-  typename DistanceMap, 
+  typename Workspace, 
   typename WeightMap,
   //typename Compare,  
   typename Visitor,  
@@ -97,8 +111,7 @@ template <
       Vertex              s, 
       std::vector<Vertex> t_vec, 
       //Heuristic           h, 
-      PredMap&            pred_map, 
-      DistanceMap&        distance_map, 
+      Workspace&          workspace, 
       WeightMap&          weight_map,
       Visitor&            visitor, 
       Stats&              stats);
@@ -119,10 +132,8 @@ class compact_graph_dijkstra_algorithm
     typename GraphT,
     typename Vertex, 
     //typename Heuristic, 
-    typename PredMap, 
-    typename DistanceMap, 
+    typename Workspace, 
     typename WeightMap,
-    typename IndexMap,
     typename Visitor,  
     typename Stats>
   static void compute(
@@ -130,31 +141,38 @@ class compact_graph_dijkstra_algorithm
       Vertex       s,
       Vertex       t,  
       //Heuristic    h, 
-      PredMap&     pred_map, 
-      DistanceMap& distance_map, 
+      Workspace&   workspace, 
       WeightMap&   weight_map,
-      IndexMap&    edge_index_map,
       Visitor&     visitor,  
       Stats&       stats);
 
+  // labels are edge indexes, only the edges reached are initialized;
+  // labels dominated by one settled at the same vertex are stalled. 
+  // true when the visitor stopped the search
   template < 
     typename GraphT, 
     typename Vertex, 
-    typename PredMap, 
-    typename DistanceMap, 
+    typename Workspace, 
     typename WeightMap, 
-    typename IndexMap,
-    typename ColorMap, 
-    typename Visitor >
-  static void arc_based_search(
+    typename Visitor,
+    typename Stats >
+  static bool arc_based_search(
       GraphT&     g, 
       Vertex      s,
-      PredMap     predecessor,
-      DistanceMap distance,
+      Workspace&  workspace,
       WeightMap&  weight,
-      IndexMap&   index_map,
-      ColorMap    color,
-      Visitor&    vis);  
+      Visitor&    vis,
+      Stats&      stats);  
+
+  // true if an in-edge of target(e) settled before e reaches every
+  // out-edge at no greater cost than e
+  template < 
+    typename GraphT, 
+    typename Workspace >
+  static bool stalled(
+      const GraphT&     g, 
+      typename boost::graph_traits<GraphT>::edge_descriptor e,
+      const Workspace&  workspace);
 
  private:
   compact_graph_dijkstra_algorithm();
@@ -162,6 +180,123 @@ class compact_graph_dijkstra_algorithm
 
 };
 
+class bidirectional_dijkstra_algorithm 
+{
+ public:
+  static std::string get_name() { 
+    return "Bidirectional Dijkstra"; }
+
+  // returns the vertex where the searches meet on a shortest path and
+  // its length, parents lead back to s in forward and on to t in 
+  // backward
+  template <
+    typename GraphT,
+    typename Vertex, 
+    typename Workspace, 
+    typename WeightMap,
+    typename Stats>
+  static std::pair<Vertex, typename Workspace::distance_type> compute(
+      const GraphT&     g, 
+      Vertex            s, 
+      Vertex            t, 
+      Workspace&        forward, 
+      Workspace&        backward, 
+      const WeightMap&  weight_map,
+      Stats&            stats);
+
+ private:
+  bidirectional_dijkstra_algorithm();
+  ~bidirectional_dijkstra_algorithm();
+
+};
+
+class compact_graph_bidirectional_dijkstra_algorithm 
+{
+ public:
+  static std::string get_name() { 
+    return "Turn Costs Arc-Based Bidirectional Dijkstra"; }
+
+  // as bidirectional_dijkstra_algorithm, labels and the meeting point
+  // are edge indexes
+  template <
+    typename GraphT,
+    typename Vertex, 
+    typename Workspace, 
+    typename WeightMap,
+    typename Stats>
+  static std::pair<
+    typename Workspace::key_type, 
+    typename Workspace::distance_type> compute(
+      const GraphT&     g, 
+      Vertex            s, 
+      Vertex            t, 
+      Workspace&        forward, 
+      Workspace&        backward, 
+      const WeightMap&  weight_map,
+      Stats&            stats);
+
+ private:
+  compact_graph_bidirectional_dijkstra_algorithm();
+  ~compact_graph_bidirectional_dijkstra_algorithm();
+
+};
+
+class phantom_dijkstra_algorithm
+{
+ public:
+  static std::string get_name() {
+    return "Phantom Node Dijkstra"; }
+
+  // Dijkstra from several sources with initial distances to the best
+  // of several targets with final distances, i.e. between points on
+  // edges (see phantom_node); stops once no target can cost less than
+  // bound. Returns the index in targets of the best one (targets.size()
+  // if none beats bound) and its cost, parents lead back to a source
+  template <
+    typename GraphT,
+    typename Workspace,
+    typename WeightMap,
+    typename Stats>
+  static std::pair<size_t, typename Workspace::distance_type> compute(
+      const GraphT&     g,
+      const std::vector<
+        std::pair<typename Workspace::key_type,
+          typename Workspace::distance_type> >& sources,
+      const std::vector<
+        std::pair<typename Workspace::key_type,
+          typename Workspace::distance_type> >& targets,
+      typename Workspace::distance_type         bound,
+      Workspace&        workspace,
+      const WeightMap&  weight_map,
+      Stats&            stats);
+
+  // as compute, labels are edge indexes holding the cost at the head
+  // of the edge; turns forbidden by the turn tables are never taken
+  template <
+    typename GraphT,
+    typename Workspace,
+    typename WeightMap,
+    typename Stats>
+  static std::pair<size_t, typename Workspace::distance_type>
+  arc_based_compute(
+      const GraphT&     g,
+      const std::vector<
+        std::pair<typename Workspace::key_type,
+          typename Workspace::distance_type> >& sources,
+      const std::vector<
+        std::pair<typename Workspace::key_type,
+          typename Workspace::distance_type> >& targets,
+      typename Workspace::distance_type         bound,
+      Workspace&        workspace,
+      const WeightMap&  weight_map,
+      Stats&            stats);
+
+ private:
+  phantom_dijkstra_algorithm();
+  ~phantom_dijkstra_algorithm();
+
+};
+
 class pruning_based_dijkstra_algorithm 
 {
  public:
@@ -172,9 +307,9 @@ class pruning_based_dijkstra_algorithm
     typename GraphT,
     typename Vertex, 
     //typename Heuristic, 
-    typename PredMap, 
-    typename DistanceMap, 
+    typename Workspace, 
     typename WeightMap, 
+    typename Pruning,  
     typename Visitor,  
     typename Stats>
   static void compute(
@@ -182,31 +317,31 @@ class pruning_based_dijkstra_algorithm
       Vertex       s,
       Vertex       t,  
       //Heuristic    h, 
-      PredMap&     pred_map, 
-      DistanceMap& distance_map, 
+      Workspace&   workspace, 
       WeightMap&   weight_map,
+      Pruning&     pruning,  
       Visitor&     visitor,  
       Stats&       stats);
 
-  // Dijkstra algorithm with pruning on relaxed edges
+  // Dijkstra algorithm with pruning on relaxed edges, edges the 
+  // predicate prunes are not relaxed, see graph_pruning.h; true when 
+  // the visitor stopped the search
   template < 
     typename GraphT, 
     typename Vertex, 
-    typename PredMap, 
-    typename DistanceMap, 
+    typename Workspace, 
     typename WeightMap, 
-    typename IndexMap,
-    typename ColorMap, 
-    typename Visitor >
-  static void pruning_based_search(
+    typename Pruning, 
+    typename Visitor,
+    typename Stats >
+  static bool pruning_based_search(
       GraphT&     g, 
       Vertex      s,
-      PredMap     predecessor,
-      DistanceMap distance,
+      Workspace&  workspace,
       WeightMap&  weight,
-      IndexMap    index_map,
-      ColorMap    color,
-      Visitor&    vis);  
+      Pruning&    pruning,
+      Visitor&    vis,
+      Stats&      stats);  
 
  private:
   pruning_based_dijkstra_algorithm();
@@ -214,51 +349,318 @@ class pruning_based_dijkstra_algorithm
 
 };
 
+class alt_algorithm 
+{
+ public:
+  static std::string get_name() { 
+    return "ALT (A*, Landmarks, Triangle inequality)"; }
+
+  // A* from s to t with an admissible heuristic, true if t is settled;
+  // distances and parents are left in distance
+  template <
+    typename GraphT,
+    typename Vertex, 
+    typename Heuristic, 
+    typename Workspace, 
+    typename WeightMap,
+    typename Stats>
+  static bool compute(
+      const GraphT&     g, 
+      Vertex            s, 
+      Vertex            t, 
+      const Heuristic&  h, 
+      Workspace&        distance, 
+      Workspace&        queue, 
+      const WeightMap&  weight_map,
+      Stats&            stats);
+
+ private:
+  alt_algorithm();
+  ~alt_algorithm();
+
+};
+
+class contraction_hierarchy_algorithm 
+{
+ public:
+  static std::string get_name() { 
+    return "Contraction Hierarchies"; }
+
+  // bidirectional search on the upward arcs of a hierarchy, sources
+  // and targets come with their initial distances; returns the node
+  // where the two searches meet and the distance through it
+  template <
+    typename HierarchyT,
+    typename Workspace,
+    typename Stats>
+  static std::pair<uint32_t, typename Workspace::distance_type> compute(
+      const HierarchyT&  h,
+      const std::vector<
+        std::pair<uint32_t, 
+          typename Workspace::distance_type> >& sources,
+      const std::vector<
+        std::pair<uint32_t, 
+          typename Workspace::distance_type> >& targets,
+      Workspace&         forward,
+      Workspace&         backward,
+      Stats&             stats);
+
+  // input arcs of the path through meet, in path order
+  template <
+    typename HierarchyT,
+    typename Workspace,
+    typename OutputIterator>
+  static void unpack_path(
+      const HierarchyT&  h,
+      uint32_t           meet,
+      const Workspace&   forward,
+      const Workspace&   backward,
+      OutputIterator     out);
+
+ private:
+  contraction_hierarchy_algorithm();
+  ~contraction_hierarchy_algorithm();
+
+};
+
+// label of a many-to-many search: a node of the hierarchy reached at
+// weight, with the length and duration of its path; index is the
+// target column of bucket entries
+template <typename WeightT>
+struct many_to_many_label
+{
+  uint32_t node;
+  uint32_t index;
+  WeightT  weight;
+  double   length;
+  double   duration;
+};
+
+class many_to_many_algorithm 
+{
+ public:
+  static std::string get_name() { 
+    return "Many-to-Many Contraction Hierarchies"; }
+
+  // bucket-based many-to-many search: the backward search from every
+  // target leaves an entry in the bucket of each node it settles, the
+  // forward search from every source scans the buckets of the nodes it
+  // settles. Searches run on all cores; weights, lengths and durations
+  // are row-major by source and target, infinite when unreachable. 
+  // arc_lengths and arc_durations are indexed by arc of the hierarchy
+  template <
+    typename HierarchyT,
+    typename WeightT,
+    typename Stats>
+  static void compute(
+      const HierarchyT&  h,
+      const std::vector<
+        std::vector<many_to_many_label<WeightT> > >& sources,
+      const std::vector<
+        std::vector<many_to_many_label<WeightT> > >& targets,
+      const std::vector<double>&  arc_lengths,
+      const std::vector<double>&  arc_durations,
+      std::vector<WeightT>&       weights,
+      std::vector<double>&        lengths,
+      std::vector<double>&        durations,
+      Stats&                      stats);
+
+ private:
+  many_to_many_algorithm();
+  ~many_to_many_algorithm();
+
+  // upward search from seeds, up arcs if forward and down arcs 
+  // reversed otherwise; appends the settled labels in settle order
+  template <
+    typename HierarchyT,
+    typename WeightT,
+    typename Workspace>
+  static void search(
+      const HierarchyT&  h,
+      const std::vector<many_to_many_label<WeightT> >& seeds,
+      bool               forward,
+      const std::vector<double>&  arc_lengths,
+      const std::vector<double>&  arc_durations,
+      Workspace&         ws,
+      std::vector<many_to_many_label<WeightT> >& settled);
+
+};
+
+class phast_algorithm 
+{
+ public:
+  static std::string get_name() { 
+    return "PHAST (one-to-all Contraction Hierarchies)"; }
+
+  // one-to-all distances bounded by limit: an upward search from the 
+  // sources, with their initial distances, then a single sweep of the 
+  // nodes in descending rank pulling distances down the down arcs. 
+  // distances is indexed by node of the hierarchy, infinite (max) 
+  // beyond limit
+  template <
+    typename HierarchyT,
+    typename Workspace,
+    typename Stats>
+  static void compute(
+      const HierarchyT&  h,
+      const std::vector<
+        std::pair<uint32_t, 
+          typename Workspace::distance_type> >& sources,
+      typename Workspace::distance_type         limit,
+      Workspace&         workspace,
+      std::vector<typename Workspace::distance_type>& distances,
+      Stats&             stats);
+
+ private:
+  phast_algorithm();
+  ~phast_algorithm();
+
+};
+
+// step of an overlay search: an edge or a clique of the cell of u at
+// the given level
+template <typename WeightT>
+struct overlay_step
+{
+  uint32_t u;
+  uint32_t v;
+  uint32_t level;
+  WeightT  du;
+  WeightT  dv;
+};
+
+class customizable_route_planning_algorithm 
+{
+ public:
+  static std::string get_name() { 
+    return "Customizable Route Planning"; }
+
+  // unidirectional search from s on the overlay, true if t is settled
+  template <
+    typename OverlayT,
+    typename Workspace,
+    typename WeightMap,
+    typename Stats>
+  static bool compute(
+      const OverlayT&    og,
+      uint32_t           s,
+      uint32_t           t,
+      Workspace&         workspace,
+      const WeightMap&   weight_map,
+      Stats&             stats);
+
+  // edge slots of the path s -> t, in path order
+  template <
+    typename OverlayT,
+    typename Workspace,
+    typename WeightMap,
+    typename OutputIterator>
+  static void unpack_path(
+      const OverlayT&    og,
+      uint32_t           s,
+      uint32_t           t,
+      const Workspace&   workspace,
+      const WeightMap&   weight_map,
+      OutputIterator     out);
+
+ private:
+  customizable_route_planning_algorithm();
+  ~customizable_route_planning_algorithm();
+
+  template <
+    typename OverlayT,
+    typename WeightMap,
+    typename WeightT,
+    typename OutputIterator>
+  static void unpack_step(
+      const OverlayT&               og,
+      const WeightMap&              weight_map,
+      const overlay_step<WeightT>&  step,
+      OutputIterator                out);
+
+};
+
+// label of the bicriterion search: cost of a path from the source, the
+// label it extends (none at the source) by edge; open until propagated
+template <typename WeightT, typename Edge>
+struct bicriterion_label
+{
+  static const uint32_t none = std::numeric_limits<uint32_t>::max();
+
+  WeightT  cost;
+  uint32_t parent;
+  Edge     edge;
+  bool     open;
+};
+
 class bicriterion_epsMOA_star_algorithm 
 {
  public:
   static std::string get_name() { 
     return "MOA* Stewart + epsilon-approximation"; }
 
+  // labels of a vertex as indexes of the label arena, by increasing 
+  // first and decreasing second criterion: no label dominates another
+  typedef std::vector<uint32_t> label_bag;
+
+  // the search stays within region, e.g. an ellipse_region; H bounds
+  // from below both criteria to t, e.g. bicriterion_bound_heuristic.
+  // With epsilon 0 the Pareto set is exact, see config.h
   template <
     typename BiGraphT, 
     typename Vertex, 
+    typename Region, 
     typename Heuristic, 
     typename ParetoSet, 
     typename WeightMap, 
     typename Stats>
   static void compute(
-      BiGraphT&  g, 
-      Vertex     s, 
-      Vertex     t, 
-      Heuristic  H, 
-      ParetoSet& pareto_set,
-      WeightMap& weight_map,  
-      Stats&     stats);
+      BiGraphT&     g, 
+      Vertex        s, 
+      Vertex        t, 
+      const Region& region, 
+      Heuristic&    H, 
+      ParetoSet&    pareto_set,
+      WeightMap&    weight_map,  
+      Stats&        stats,
+      double        epsilon = EPLSILON_PARETO);
 
  private:
   bicriterion_epsMOA_star_algorithm();
   ~bicriterion_epsMOA_star_algorithm();
 
-  template <typename LabelSet, typename WeightT>
+  // merges the candidate labels X, ordered as a bag, into Y: those
+  // epsilon-dominated by Y are dropped, those of Y dominated by the
+  // others are removed. True when a label of X was added
+  template <typename Label>
   static bool epsilon_approximation_merge(
-      LabelSet&       Y, 
-      const LabelSet& X, 
-      const WeightT&  len, 
-      double          epsilon);
-
-  template <typename LabelSet>
+      std::vector<Label>&       arena,
+      label_bag&                Y, 
+      const std::vector<Label>& X, 
+      double                    epsilon,
+      label_bag&                merged);
+
+  // true when the target labels dominate every open label of X plus h
+  template <typename Label, typename WeightT>
   static bool target_pruning(
-      const LabelSet& target, 
-      const LabelSet& X);
-
-  template <typename WeightT, typename LabelSet>
-  static bool contains(
-      const WeightT&  elem, 
-      const LabelSet& s);
-
-  template <typename LabelSet, typename Stats>
-  static void dump(LabelSet& Gt, Stats& stats);  
+      const std::vector<Label>& arena,
+      const label_bag&          target, 
+      const label_bag&          X,
+      const WeightT&            h);
+
+  // true when a target label dominates x, a bound of the labels 
+  // through a candidate
+  template <typename Label, typename WeightT>
+  static bool dominated_by_target(
+      const std::vector<Label>& arena,
+      const label_bag&          target, 
+      const WeightT&            x);
+
+  template <typename Label, typename Stats>
+  static void dump(
+      const std::vector<Label>& arena, 
+      const label_bag&          Gt, 
+      Stats&                    stats);  
 
 }; 
 
@@ -291,6 +693,17 @@ class RAPTOR_algorithm {
   static void raptor_resource_release(
       data_Rt& rdata);
 
+  static void raptor_resource_reset(
+      data_Rt& rdata, 
+      timetable_Rt& timetable);
+
+  static data_Rt& thread_raptor_data();
+
+  static void reach_stop(
+      data_Rt& rdata, 
+      uint32_t sidx, 
+      time_Rt time);
+
   static uint32_t get_route_stops_index(
       timetable_Rt& timetable, 
       uint32_t ridx, 
@@ -350,6 +763,8 @@ class RAPTOR_algorithm {
 
 // workaround waiting for template compilation
 #include "algorithm/dijkstra_based_algorithm.cc"
+#include "algorithm/hierarchy_based_algorithm.cc"
+#include "algorithm/overlay_based_algorithm.cc"
 #include "algorithm/bicriterion_epsMOA_star_algorithm.cc"
 
 // algorithm.cc 
@@ -2,6 +2,7 @@
 #define GOL_BASIC_RAPTOR_ALGORITHM_H_
 
 // std
+#include <algorithm>
 #include <vector>
 #include <string>
 #include <list>
@@ -12,23 +13,42 @@
 
 namespace gol { 
 
+// a stop state that was never reached, the time fields record when 
+// stops have been reached, when times are UNREACHED the other fields 
+// in the same round state should never be read.
+static const label_Rt unreached_label_Rt = {
+  UNREACHED, UNDEFINED, UNDEFINED, UNDEFINED, UNREACHED, 
+  UNREACHED, UNDEFINED, UNREACHED, UNREACHED };
+
 void RAPTOR_algorithm::raptor_resource_allocation(
       data_Rt& rdata, 
       timetable_Rt& timetable, 
       uint8_t n_rounds)
 {
-  // allocate static memory blocks
+  // allocate static memory blocks, for all the rounds so that 
+  // later queries can reuse them
   rdata.n_rounds = n_rounds;
+  rdata.n_stops  = timetable.n_stops;
   rdata.minimun_arrival_times = 
       (time_Rt*) malloc(sizeof(time_Rt) * timetable.n_stops);
   rdata.round_earliest_arrival_times =
-      ((label_Rt*) malloc(sizeof(label_Rt) * (n_rounds * timetable.n_stops))); 
+      ((label_Rt*) malloc(sizeof(label_Rt) * (RAPTOR_MAX_ROUNDS * timetable.n_stops))); 
   rdata.marked_stops = bitset_new(timetable.n_stops);
 
   if ( ! (rdata.minimun_arrival_times        && 
           rdata.round_earliest_arrival_times && 
           rdata.marked_stops)) 
-      throw solver_exception(" Failed allocate static memory blocks for raptor ");         
+  {
+    raptor_resource_release(rdata);
+    throw solver_exception(" Failed allocate static memory blocks for raptor ");         
+  }
+
+  for (uint32_t sidx = 0; sidx < timetable.n_stops; ++sidx) 
+    rdata.minimun_arrival_times[sidx] = UNREACHED;
+  std::fill(
+    rdata.round_earliest_arrival_times, 
+    rdata.round_earliest_arrival_times + RAPTOR_MAX_ROUNDS * timetable.n_stops, 
+    unreached_label_Rt);
 }
 
 void RAPTOR_algorithm::raptor_resource_release(data_Rt& rdata) 
@@ -36,7 +56,59 @@ void RAPTOR_algorithm::raptor_resource_release(data_Rt& rdata)
   // free static memory blocks
   free(rdata.minimun_arrival_times);
   free(rdata.round_earliest_arrival_times);
-  bitset_destroy(rdata.marked_stops);
+  if (rdata.marked_stops)
+    bitset_destroy(rdata.marked_stops);
+  rdata.minimun_arrival_times        = nullptr;
+  rdata.round_earliest_arrival_times = nullptr;
+  rdata.marked_stops                 = nullptr;
+  rdata.n_stops                      = 0;
+}
+
+// restores the states written by the previous query only
+void RAPTOR_algorithm::raptor_resource_reset(
+      data_Rt& rdata, 
+      timetable_Rt& timetable)
+{
+  label_Rt (*round_earliest_arrival_times)[timetable.n_stops] = 
+    (label_Rt(*)[timetable.n_stops]) rdata.round_earliest_arrival_times;
+
+  for (auto stops : {&rdata.reached, &rdata.targets}) 
+  {
+    for (uint32_t sidx : *stops) 
+    {
+      rdata.minimun_arrival_times[sidx] = UNREACHED;
+      bitset_unset(rdata.marked_stops, sidx);
+      for (uint8_t rnd = 0; rnd < RAPTOR_MAX_ROUNDS; ++rnd) 
+        round_earliest_arrival_times[rnd][sidx] = unreached_label_Rt;
+    }
+  }
+  rdata.reached.clear();
+  rdata.sources.clear();
+  rdata.targets.clear();
+  rdata.Q.clear();
+  rdata.route_sources.clear();
+}
+
+// raptor states of the calling thread, reused by its queries
+data_Rt& RAPTOR_algorithm::thread_raptor_data()
+{
+  struct holder_t 
+  {
+    data_Rt rdata;
+    ~holder_t() { raptor_resource_release(rdata); }
+  };
+  static thread_local holder_t holder;
+  return holder.rdata;
+}
+
+void RAPTOR_algorithm::reach_stop(
+      data_Rt& rdata, 
+      uint32_t sidx, 
+      time_Rt time) 
+{
+  if (rdata.minimun_arrival_times[sidx] == UNREACHED)
+    rdata.reached.push_back(sidx);
+  rdata.minimun_arrival_times[sidx] = time;
 }
 
 uint32_t RAPTOR_algorithm::get_route_stops_index(
@@ -136,7 +208,7 @@ void RAPTOR_algorithm::look_at_foot_paths(
         // stop improve by walk transfer
         slbl_to->walk_time = earliest_arrival_time + transfer_time;
         slbl_to->walk_from = msidx;
-        rdata.minimun_arrival_times[sidx_to] = earliest_arrival_time + transfer_time;;
+        reach_stop(rdata, sidx_to, earliest_arrival_time + transfer_time);
         accumulate_routes_for_stop(rdata, timetable, sidx_to);
         // unflag_banned_routes  
       }
@@ -308,7 +380,7 @@ void RAPTOR_algorithm::round(
         round_earliest_arrival_times[round][sidx].back_stop  = board_stop;
         round_earliest_arrival_times[round][sidx].board_time = board_time;
 
-        rdata.minimun_arrival_times[sidx] = trip_arrival_time;
+        reach_stop(rdata, sidx, trip_arrival_time);
         bitset_set(rdata.marked_stops, sidx); // mark stop for next round.
       }
 
@@ -386,7 +458,7 @@ void RAPTOR_algorithm::raptor_initialization(
     //*/
 
     // initialization of states
-    rdata.minimun_arrival_times[sidx]               = time_to_reach_stop;    
+    reach_stop(rdata, sidx, time_to_reach_stop);    
     round_earliest_arrival_times[1][sidx].time      = time_to_reach_stop;
     round_earliest_arrival_times[1][sidx].walk_time = time_to_reach_stop;
     round_earliest_arrival_times[1][sidx].walk_from = sidx;
@@ -438,34 +510,16 @@ void RAPTOR_algorithm::compute (
   if (n_rounds > RAPTOR_MAX_ROUNDS)
     n_rounds = RAPTOR_MAX_ROUNDS;
 
-  data_Rt rdata; 
-  raptor_resource_allocation(rdata, timetable, n_rounds);
-
-  // algorithm associates with each stop a multilabel where ith element 
-  // rapresents the earliest known arrival time at stop with up to i trips
-  label_Rt (*round_earliest_arrival_times)[timetable.n_stops] = 
-    (label_Rt(*)[timetable.n_stops]) rdata.round_earliest_arrival_times; // cast to [round][stop] 
+  // states are allocated once per thread and timetable size, the 
+  // previous query is undone on the stops it reached only
+  data_Rt& rdata = thread_raptor_data(); 
+  if (rdata.n_stops != timetable.n_stops) {
+    raptor_resource_release(rdata);
+    raptor_resource_allocation(rdata, timetable, n_rounds);
+  } else
+    raptor_resource_reset(rdata, timetable);
+  rdata.n_rounds = n_rounds;
 
-  // initialization of the algorithm
-  for (uint32_t sidx = 0; sidx < timetable.n_stops; ++sidx) rdata.minimun_arrival_times[sidx] = UNREACHED;
-  for (uint8_t rnd = 0; rnd < n_rounds; ++rnd) 
-  {
-    for (uint32_t sidx = 0; sidx < timetable.n_stops; ++sidx) 
-    { 
-      // we use the time fields to record when stops have been reached,
-      // when times are UNREACHED the other fields in the same round state should never be read.
-      round_earliest_arrival_times[rnd][sidx].time       = UNREACHED;
-      round_earliest_arrival_times[rnd][sidx].walk_time  = UNREACHED;
-      round_earliest_arrival_times[rnd][sidx].walk_from  = UNDEFINED;
-      round_earliest_arrival_times[rnd][sidx].back_stop  = UNDEFINED;
-      round_earliest_arrival_times[rnd][sidx].back_route = UNDEFINED;
-      round_earliest_arrival_times[rnd][sidx].back_trip  = UNDEFINED;
-      round_earliest_arrival_times[rnd][sidx].board_time = UNREACHED;
-      // from previus road-network phase
-      round_earliest_arrival_times[rnd][sidx].from_location_time = UNREACHED;
-      round_earliest_arrival_times[rnd][sidx].to_location_time   = UNREACHED;
-    }
-  }
   // multi-source multi-target initialization    
   raptor_initialization(rdata, timetable, near_stops_src, near_stops_trg);
 
@@ -479,7 +533,6 @@ void RAPTOR_algorithm::compute (
 #ifdef DEBUG  
   dump(pareto_set, timetable);
 #endif  
-  raptor_resource_release(rdata);
   
 };
 
@@ -14,322 +14,237 @@
 //
 // You should have received a copy of the GNU General Public License
 // along with This program.  If not, see <http://www.gnu.org/licenses/>.
-
 #ifndef GOL_EMOASTAR_ALGORITHM_H_
 #define GOL_EMOASTAR_ALGORITHM_H_
 
 namespace gol {
 
-template <typename LabelSet, typename WeightT>
+// Both sides are ordered bags, so each step is a linear merge. A 
+// candidate x is epsilon-dominated when a label y of Y has 
+// y <= (1 + epsilon) x on both criteria: among the labels of Y with 
+// first criterion within bound, the last one has the least second.
+template <typename Label>
 bool bicriterion_epsMOA_star_algorithm::epsilon_approximation_merge(
-     LabelSet& Y, 
-     const LabelSet& X, 
-     const WeightT& len, 
-     double epsilon) 
+    std::vector<Label>&       arena,
+    label_bag&                Y, 
+    const std::vector<Label>& X, 
+    double                    epsilon,
+    label_bag&                merged) 
 {  
-  bool merged = false;
+  bool changed = false;
 
-  // pruning epsilon-dominated components of X 
-  LabelSet epsilon_pruned_X;
-  typename LabelSet::const_iterator iit = X.begin();
-  typename LabelSet::iterator jit = Y.begin();
-  while(iit != X.end() && jit != Y.end()) { // bicriterion-ordered sets
-    WeightT lbl = *iit + len;
-    WeightT eps_lbl = lbl * (1 + epsilon);    
-    if (eps_lbl.first < jit->first) { 
-      while (jit != Y.end() && eps_lbl.second <= jit->second) {
-        typename LabelSet::iterator del = jit++;
-      }
-      epsilon_pruned_X.insert(lbl);
-      ++iit;
-    }
-    else if (eps_lbl.first > jit->first) {
-      while (eps_lbl.second >= jit->second) {
-        assert(eps_lbl.first > jit->first);
-        if (++iit == X.end()) 
-          break;
-        lbl = (*iit) + len;
-        eps_lbl =  lbl * (1 + epsilon); 
-      }
-      ++jit;
-    }
-    // the first components are equal
-    else {
-      if (eps_lbl.second < jit->second) {
-        while (jit != Y.end() && eps_lbl.second <= jit->second) {
-          assert(eps_lbl.first <= jit->first); 
-          typename LabelSet::iterator del = jit++;
-        }
-      epsilon_pruned_X.insert(lbl);
-      ++iit;
-      }
-      else if (eps_lbl.second > jit->second) {
-        while(eps_lbl.second >= jit->second) {
-          if (++iit == X.end()) 
-            break;
-        lbl = (*iit) + len;
-        eps_lbl =  lbl * (1 + epsilon); 
-        }
-        ++jit;
-      }
-      // both components are equal
-      else {
-        ++iit; 
-        ++jit;
-      }
-    }
-  } 
-  for ( ; iit != X.end(); ++iit) { 
-    WeightT lbl = *iit + len;
-    epsilon_pruned_X.insert(lbl);
-  }
+  merged.clear();
+  size_t j = 0, k = 0;
+  for (const Label& x : X)
+  {
+    // pruning epsilon-dominated candidates
+    while (k < Y.size() && 
+           arena[Y[k]].cost.first <= x.cost.first * (1 + epsilon))
+      ++k;
+    if (k > 0 && arena[Y[k - 1]].cost.second <= x.cost.second * (1 + epsilon))
+      continue;
 
-  // merge sets 
-  iit = epsilon_pruned_X.begin();
-  jit = Y.begin();
-  while(iit != epsilon_pruned_X.end() && jit != Y.end()) { // bicriterion-ordered sets
-    WeightT lbl = *iit;    
-    if (lbl.first < jit->first) { 
-      while (jit != Y.end() && lbl.second <= jit->second) {
-        typename LabelSet::iterator del = jit++;
-        Y.erase(del); // dominated
-      }
-      Y.insert(lbl);
-      merged = true;
-      ++iit;
+    // labels of Y before x, those dominated by x are removed
+    while (j < Y.size() && 
+           (arena[Y[j]].cost.first < x.cost.first ||
+            (arena[Y[j]].cost.first == x.cost.first && 
+             arena[Y[j]].cost.second <= x.cost.second)))
+    {
+      if (merged.empty() || 
+          arena[Y[j]].cost.second < arena[merged.back()].cost.second)
+        merged.push_back(Y[j]);
+      ++j;
     }
-    else if (lbl.first > jit->first) {
-      while (lbl.second >= jit->second) {
-        assert(lbl.first > jit->first);
-        if (++iit == epsilon_pruned_X.end()) 
-          break;
-        lbl = (*iit); 
-      }
-      ++jit;
+    if (merged.empty() || x.cost.second < arena[merged.back()].cost.second) 
+    {
+      merged.push_back(arena.size());
+      arena.push_back(x);
+      changed = true;
     }
-    // the first components are equal
-    else {
-      if (lbl.second < jit->second) {
-        while (jit != Y.end() && lbl.second <= jit->second) {
-          assert(lbl.first <= jit->first); 
-          typename LabelSet::iterator del = jit++;
-          Y.erase(del); // dominated
-        }
-        Y.insert(lbl);
-        merged = true;
-        ++iit;
-      }
-      else if (lbl.second > jit->second) {
-        while(lbl.second >= jit->second) {
-          if (++iit == epsilon_pruned_X.end()) 
-            break;
-          lbl = (*iit); 
-        }
-        ++jit;
-      }
-      // both components are equal
-      else {
-        ++iit; 
-        ++jit;
-      }
-    }
-  } 
-  // when Y is empty, overtaking
-  for ( ; iit != epsilon_pruned_X.end(); ++iit) { 
-    WeightT lbl = *iit;
-    Y.insert(lbl);
-    merged = true;
   }
-
-  return merged;
+  if (!changed)
+    return false;
+  for ( ; j < Y.size(); ++j)
+    if (arena[Y[j]].cost.second < arena[merged.back()].cost.second)
+      merged.push_back(Y[j]);
+  Y.swap(merged);
+  return true;
 }
 
-template <typename LabelSet>
+template <typename Label, typename WeightT>
 bool bicriterion_epsMOA_star_algorithm::target_pruning(
-    const LabelSet& target, 
-    const LabelSet& X) 
+    const std::vector<Label>& arena,
+    const label_bag&          target, 
+    const label_bag&          X,
+    const WeightT&            h) 
 {
-  bool merged = false;
-
-  typename LabelSet::const_iterator iit = X.begin();
-  typename LabelSet::iterator jit = target.begin();
-  while (iit != X.end() && jit != target.end()) { // ordered sets   
-    if (iit->first < jit->first) {
-      while (jit != target.end() && iit->second <= jit->second)
-        jit++;
-      merged = true;
-      ++iit;
-    }
-    else if (iit->first > jit->first) {
-      while (iit->second >= jit->second) {
-        assert(iit->first > jit->first);
-        if (++iit == X.end()) 
-          break;
-      }
-      ++jit;
-    }
-    // the first components are equal
-    else {
-      if (iit->second < jit->second) {
-        while (jit != target.end() && iit->second <= jit->second) {
-          assert(iit->first <= jit->first); 
-          jit++;
-        }
-        merged = true;
-        ++iit;
-      }
-      else if (iit->second > jit->second) {
-        while (iit->second >= jit->second) {
-          if (++iit == X.end()) 
-            break;
-        }
-        ++jit;
-      }
-      // both components are equal
-      else {
-        ++iit; 
-        ++jit;
-      }
-    }
-  }
-  for ( ; iit != X.end(); ++iit) {
-    merged = true;
+  size_t k = 0;
+  for (uint32_t i : X)
+  {
+    if (!arena[i].open)
+      continue;
+    WeightT x = arena[i].cost + h;
+    while (k < target.size() && arena[target[k]].cost.first <= x.first)
+      ++k;
+    if (k == 0 || arena[target[k - 1]].cost.second > x.second)
+      return false;
   }
-  return !merged;
+  return true;
 }
 
-template <typename WeightT, typename LabelSet>
-bool bicriterion_epsMOA_star_algorithm::contains(const WeightT& elem, const LabelSet& s) {
-  typename LabelSet::const_iterator cit = s.find(elem);
-  if (cit == s.end()) return false;
-  else return (cit->second == elem.second);
-}  
+template <typename Label, typename WeightT>
+bool bicriterion_epsMOA_star_algorithm::dominated_by_target(
+    const std::vector<Label>& arena,
+    const label_bag&          target, 
+    const WeightT&            x) 
+{
+  // the last label with first criterion within x has the least second
+  auto it = std::upper_bound(target.begin(), target.end(), x.first,
+    [&arena](const typename WeightT::first_type& c, uint32_t i) { 
+      return c < arena[i].cost.first; });
+  return it != target.begin() && arena[*(it - 1)].cost.second <= x.second;
+}
 
-template <typename BiGraphT, typename VertexDescriptor, typename Heuristic, 
-          typename ParetoSet, typename WeightMap, typename Stats>
+// Stewart's multi-objective A*, with epsilon-dominance to bound the 
+// labels kept. Labels live in an arena and never move, bags hold their
+// indexes. The open vertices are in an indexed heap keyed by their 
+// least open label plus heuristic, lexicographically; an expansion
+// propagates the open labels of the vertex, which are then closed.
+// A candidate label is dropped when, plus the bound of H, it is 
+// dominated by a label of t: no path it extends is Pareto optimal.
+template <typename BiGraphT, typename VertexDescriptor, typename Region,
+          typename Heuristic, typename ParetoSet, typename WeightMap, 
+          typename Stats>
 void bicriterion_epsMOA_star_algorithm::compute(
     BiGraphT&        g, 
     VertexDescriptor s, 
     VertexDescriptor t, 
-    Heuristic        H, 
+    const Region&    region, 
+    Heuristic&       H, 
     ParetoSet&       pareto_set,
     WeightMap&       weight_map,  
-    Stats&           stats) 
+    Stats&           stats,
+    double           epsilon) 
 {
   typedef boost::graph_traits<BiGraphT>      Traits;
   typedef typename Traits::out_edge_iterator out_edge_iterator;
-  typedef typename Traits::in_edge_iterator  in_edge_iterator;
   typedef typename Traits::edge_descriptor   edge_descriptor;
   typedef typename WeightMap::value_type     WeightT;
-
-  typedef std::set<WeightT, bicriteria_ord<WeightT> > LabelSet;
-
-  typedef std::pair<unsigned int, WeightT> HeuristicEvaluetion;
-  typedef std::set<HeuristicEvaluetion, 
-      bicriteria_heuristic_evaluation_ord<WeightT> > HeuristicEvaluetionSet;
+  typedef bicriterion_label<
+    WeightT, edge_descriptor>                Label;
+  typedef search_workspace<
+    VertexDescriptor, WeightT>               Workspace;
+  typedef boost::color_traits<
+    boost::default_color_type>               Color;
 
   stopwatch chrono;
 
-  // heuristic check
-  //assert(H(t) == std::make_pair(0,0));
-
   unsigned int n = boost::num_vertices(g);
-  std::vector<LabelSet> G(n);
-  std::vector<unsigned int> open;
-  std::vector<bool> is_open(n, false);
+  std::vector<Label>     arena;
+  std::vector<label_bag> G(n);
+  label_bag              labels;   // propagated by an expansion
+  std::vector<Label>     X;        // candidates through an edge
+  label_bag              merged;
+  Workspace& open = thread_search_workspace<
+    VertexDescriptor, WeightT, bicriterion_epsMOA_star_algorithm>();
+  open.reset(n);
+
+  // least open label of v plus heuristic
+  auto key = [&](VertexDescriptor v) {
+    for (uint32_t i : G[v])
+      if (arena[i].open)
+        return arena[i].cost + H(v);
+    return WeightT(); // not reached, open vertices have open labels
+  };
 
-  double epsilon = EPLSILON_PARETO; 
-  double focus_euclidean_distance = 
-    distance(g[s].geo.lon, g[s].geo.lat, g[t].geo.lon, g[t].geo.lat);
-  // ellipse periapsis, peripheral distance from focus on the main axis
-  double periapsis = ELLIPSE_PERIPHERAL_DISTANCE_PERCENT * (focus_euclidean_distance/100); 
-  
   // initialization step
-  G[s].insert(std::make_pair(0, 0));
-  G[s].insert(WeightT()); // label (0, 0)
-  open.push_back(s);
-  is_open[s] = true; 
+  arena.push_back(Label{WeightT(), Label::none, edge_descriptor(), true});
+  G[s].push_back(0); // label (0, 0)
+  open.set_distance(s, key(s));
+  open.set_color(s, Color::gray());
+  open.push(s);
   
   while(!open.empty()) 
   {
     (stats.expansions)++;
 
-    HeuristicEvaluetionSet F; 
-    // select a vertex with nd-label in open, 
-    // choosing among all the first labels in bags  
-    for (unsigned int k = 0; k < open.size(); ++k) {
-        F.insert(std::make_pair(k, *(G[open[k]].begin()) + H(open[k])));
-    }
-    VertexDescriptor i = open[F.begin()->first]; 
+    VertexDescriptor i = open.top(); open.pop();
+    open.set_color(i, Color::black());
 
-    open.erase(open.begin() + F.begin()->first);
-    is_open[i] = false;
+    // the open labels of i, closed before a loop may reopen i
+    labels.clear();
+    for (uint32_t l : G[i])
+      if (arena[l].open) {
+        labels.push_back(l);
+        arena[l].open = false;
+      }
 
     out_edge_iterator ei, ei_end;
     for (boost::tie(ei, ei_end) = boost::out_edges(i, g); ei != ei_end; ++ei) 
     { 
       VertexDescriptor j = boost::target(*ei, g); 
-      bool changed = 
-        epsilon_approximation_merge(G[j], G[i], get(weight_map, *ei), epsilon);      
-      
-      // if distance source/target over threshold allow pruning
-      if (focus_euclidean_distance > ELLIPSE_PRUNING_THRESHOLD) 
-      { 
-        if (distance(g[s].geo.lon, g[s].geo.lat, g[j].geo.lon, g[j].geo.lat) 
-                + distance(g[j].geo.lon, g[j].geo.lat, g[t].geo.lon, g[t].geo.lat) > 
-              focus_euclidean_distance + 2*periapsis)
+
+      if (!region.contains(j)) {
+        ++stats.pruned_edges;
+        continue;
+      }
+
+      WeightT len = get(weight_map, *ei);
+      WeightT h   = H(j);
+      X.clear();
+      for (uint32_t l : labels) 
+      {
+        WeightT cost = arena[l].cost + len;
+        if (j != t && dominated_by_target(arena, G[t], cost + h)) {
+          ++stats.pruned_labels;
           continue;
-      } 
-      else 
-      { 
-        if (distance(g[s].geo.lon, g[s].geo.lat, g[j].geo.lon, g[j].geo.lat) 
-                + distance(g[j].geo.lon, g[j].geo.lat, g[t].geo.lon, g[t].geo.lat) > 
-              (1.5)*ELLIPSE_PRUNING_THRESHOLD) 
+        }
+        X.push_back(Label{cost, l, *ei, true});
+      }
+      if (X.empty())
+        continue;
+      bool changed = 
+        epsilon_approximation_merge(arena, G[j], X, epsilon, merged);      
+      if (!changed || j == t)
         continue;
-      }    
-      if (changed && !is_open[j] && j != t) 
+
+      if (open.color(j) == Color::gray()) 
+      {
+        WeightT k = key(j);
+        if (k < open.distance(j)) {
+          open.set_distance(j, k);
+          open.update(j);
+        }
+      }
+      else if (!target_pruning(arena, G[t], G[j], h))
       { 
-        if (!target_pruning(G[t], G[j] + H(j))) { // TODO cost_pruning?
-          open.push_back(j);
-          is_open[j] = true;
-        }  
+        open.set_distance(j, key(j));
+        open.set_color(j, Color::gray());
+        open.push(j);
       }
-
     } 
   } // end while 
   chrono.lap();
   stats.run_time = chrono.partial_wall_time(); 
  
-  for (auto it = G[t].begin(); it != G[t].end(); ++it) 
+  // backward recostruction along the parents of the labels
+  for (uint32_t l : G[t]) 
   {
-    WeightT label = *it;
-    // backward recostruction 
-    VertexDescriptor v = t;
     std::list<edge_descriptor> path;
-    while (v != s) 
-    {      
-      in_edge_iterator ei, ei_end;
-      for (std::tie(ei, ei_end) = boost::in_edges(v, g); ei != ei_end; ++ei) 
-      {
-        VertexDescriptor u = boost::source(*ei, g);
-        if (contains(label - get(weight_map, *ei), G[u])) 
-        {
-          v = u;          
-          label = label - get(weight_map, *ei);
-          path.push_front(*ei);
-          break;
-        }
-      }      
-    } 
-    pareto_set.push_back(std::make_pair(*it, path));  
+    for (uint32_t p = l; arena[p].parent != Label::none; p = arena[p].parent)
+      path.push_front(arena[p].edge);
+    pareto_set.push_back(std::make_pair(arena[l].cost, path));  
   } 
 #ifdef DEBUG 
-  dump(G[t], stats);
+  dump(arena, G[t], stats);
 #endif
 }
 
-template <typename LabelSet, typename Stats>
-void bicriterion_epsMOA_star_algorithm::dump(LabelSet& Gt, Stats& stats) 
+template <typename Label, typename Stats>
+void bicriterion_epsMOA_star_algorithm::dump(
+    const std::vector<Label>& arena, 
+    const label_bag&          Gt, 
+    Stats&                    stats) 
 {
   logger(logDEBUG) 
     << left("[emoa*]", 14) 
@@ -339,6 +254,11 @@ void bicriterion_epsMOA_star_algorithm::dump(LabelSet& Gt, Stats& stats)
     << left(">", 3) 
     << center("Node Expansions:", 20) 
     << " | " << stats.expansions;
+  logger(logDEBUG) 
+    << left("[emoa*]", 14) 
+    << left(">", 3) 
+    << center("Pruned Labels:", 20) 
+    << " | " << stats.pruned_labels;
   logger(logDEBUG) 
     << left("[emoa*]", 14) 
     << left(">", 3) 
@@ -347,14 +267,13 @@ void bicriterion_epsMOA_star_algorithm::dump(LabelSet& Gt, Stats& stats)
     << "# " 
     << Gt.size();
   
-  for (typename LabelSet::const_iterator it = Gt.begin(); 
-        it != Gt.end();  ++it)
+  for (uint32_t l : Gt)
     logger(logDEBUG) 
       << left("[emoa*]", 14) 
       << left(">", 3) 
       << center("-", 20) 
       << " | " 
-      << right(prd(*it, 0), 40);    
+      << right(prd(arena[l].cost, 0), 40);    
   
   logger(logDEBUG) 
     << left("[emoa*]", 14) 
@@ -370,4 +289,3 @@ void bicriterion_epsMOA_star_algorithm::dump(LabelSet& Gt, Stats& stats)
 } // namespace gol
 
 #endif // GOL_EMOASTAR_ALGORITHM_H_
-
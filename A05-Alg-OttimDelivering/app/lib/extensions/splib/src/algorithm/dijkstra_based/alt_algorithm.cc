@@ -0,0 +1,104 @@
+// This file is part of Sii-Mobility - Algorithms Optimized Delivering.
+//
+// Copyright (C) 2017 GOL Lab http://webgol.dinfo.unifi.it/ - University of Florence
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with This program.  If not, see <http://www.gnu.org/licenses/>.
+
+#ifndef GOL_ALT_ALGORITHM_H_
+#define GOL_ALT_ALGORITHM_H_
+
+namespace gol {
+
+// A* keyed by distance plus the heuristic of the vertex: distances
+// live in one workspace, keys and the queue in the other. A vertex is 
+// queued again if its distance drops after it was settled, so the 
+// heuristic only has to be admissible.
+template <
+  typename GraphT,
+  typename Vertex, 
+  typename Heuristic, 
+  typename Workspace, 
+  typename WeightMap,
+  typename Stats>
+bool alt_algorithm::compute(
+    const GraphT&     g, 
+    Vertex            s, 
+    Vertex            t, 
+    const Heuristic&  h, 
+    Workspace&        distance, 
+    Workspace&        queue, 
+    const WeightMap&  weight_map,
+    Stats&            stats)
+{
+  typedef boost::default_color_type          ColorValue;
+  typedef boost::color_traits<ColorValue>    Color;
+  typedef typename Workspace::distance_type  Distance;
+
+  stopwatch chrono;
+  distance.set_distance(s, Distance());
+  queue.set_distance(s, h(s));
+  queue.set_color(s, Color::gray());
+  queue.push(s);
+
+  bool found = false;
+  while (!queue.empty())
+  {
+    Vertex u = queue.top(); queue.pop();
+    queue.set_color(u, Color::black());
+    ++stats.visited_nodes;
+    if (u == t) {
+      found = true;
+      break;
+    }
+    Distance du = distance.distance(u);
+
+    auto r = boost::out_edges(u, g);
+    for (auto it = r.first; it != r.second; ++it)
+    {
+      Vertex   v  = boost::target(*it, g);
+      Distance dv = du + get(weight_map, *it);
+      if (!(dv < distance.distance(v)))
+        continue;
+      distance.set_distance(v, dv);
+      distance.set_parent(v, u);
+      queue.set_distance(v, dv + h(v));
+      if (queue.color(v) == Color::gray())
+        queue.update(v);
+      else {
+        queue.set_color(v, Color::gray());
+        queue.push(v);
+      }
+    }
+  }
+
+  chrono.lap();
+  stats.run_time = chrono.partial_wall_time();
+#ifdef DEBUG
+  logger(logDEBUG) 
+    << left("[alt]", 14) 
+    << left(">", 3) 
+    << center("Visited Nodes:", 20) 
+    << " | " << stats.visited_nodes;
+  logger(logDEBUG) 
+    << left("[alt]", 14) 
+    << left(">", 3) 
+    << center(" ", 20) << "  " 
+    << right("run-time: " + prd(stats.run_time, 5) + "s", 40);    
+#endif 
+  return found;
+}
+
+}  // namespace gol
+
+#endif // GOL_ALT_ALGORITHM_H_
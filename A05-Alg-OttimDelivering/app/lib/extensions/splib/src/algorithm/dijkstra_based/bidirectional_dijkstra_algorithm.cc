@@ -20,7 +20,99 @@
 
 namespace gol {
 
-// TODO
+// Forward search from s on the out-edges, backward search from t on
+// the in-edges, the direction with the smaller key goes next. Every
+// relaxation reaching a vertex labelled by the other direction is a
+// candidate path; the search stops once the two keys add up to the
+// best candidate.
+template <
+  typename GraphT,
+  typename Vertex, 
+  typename Workspace, 
+  typename WeightMap,
+  typename Stats>
+std::pair<Vertex, typename Workspace::distance_type>
+bidirectional_dijkstra_algorithm::compute(
+    const GraphT&     g, 
+    Vertex            s, 
+    Vertex            t, 
+    Workspace&        forward, 
+    Workspace&        backward, 
+    const WeightMap&  weight_map,
+    Stats&            stats)
+{
+  typedef typename Workspace::distance_type  Distance;
+
+  const Distance infinity = std::numeric_limits<Distance>::max();
+
+  stopwatch chrono;
+  forward.set_distance(s, Distance());
+  forward.push(s);
+  backward.set_distance(t, Distance());
+  backward.push(t);
+
+  Distance mu   = (s == t) ? Distance() : infinity;
+  Vertex   meet = (s == t) ? s : GraphT::null_vertex();
+
+  // relaxes x -> y in ws, y is the head for the forward search and the
+  // tail for the backward one
+  auto relax = [&](Workspace& ws, Workspace& other, Vertex x, Vertex y, Distance d) {
+    if (d < ws.distance(y)) {
+      bool queued = ws.reached(y);
+      ws.set_distance(y, d);
+      ws.set_parent(y, x);
+      if (queued) ws.update(y); else ws.push(y);
+      if (other.reached(y) && d + other.distance(y) < mu) {
+        mu   = d + other.distance(y);
+        meet = y;
+      }
+    }
+  };
+
+  for (;;)
+  {
+    Distance f_key = forward.empty()  ? 
+      infinity : forward.distance(forward.top());
+    Distance b_key = backward.empty() ? 
+      infinity : backward.distance(backward.top());
+    if (f_key == infinity || b_key == infinity || f_key + b_key >= mu)
+      break;
+
+    ++stats.visited_nodes;
+    if (f_key <= b_key) 
+    {
+      Vertex u = forward.top(); forward.pop();
+      auto r = boost::out_edges(u, g);
+      for (auto it = r.first; it != r.second; ++it)
+        relax(forward, backward, u, boost::target(*it, g), 
+              f_key + get(weight_map, *it));
+    } 
+    else 
+    {
+      Vertex u = backward.top(); backward.pop();
+      auto r = boost::in_edges(u, g);
+      for (auto it = r.first; it != r.second; ++it)
+        relax(backward, forward, u, boost::source(*it, g), 
+              b_key + get(weight_map, *it));
+    }
+  }
+
+  chrono.lap();
+  stats.run_time = chrono.partial_wall_time();
+#ifdef DEBUG
+  logger(logDEBUG) 
+    << left("[bidijkstra]", 14) 
+    << left(">", 3) 
+    << center("Visited Nodes:", 20) 
+    << " | " << stats.visited_nodes;
+  logger(logDEBUG) 
+    << left("[bidijkstra]", 14) 
+    << left(">", 3) 
+    << center(" ", 20) << "  " 
+    << right("run-time: " + prd(stats.run_time, 5) + "s", 40);    
+#endif 
+  return std::make_pair(meet, mu);
+}
 
 } // namespace gol
 
@@ -0,0 +1,155 @@
+// This file is part of Sii-Mobility - Algorithms Optimized Delivering.
+//
+// Copyright (C) 2017 GOL Lab http://webgol.dinfo.unifi.it/ - University of Florence
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with This program.  If not, see <http://www.gnu.org/licenses/>.
+
+#ifndef GOL_ARCB_BID_DIJKSTRA_ALGORITHM_H_
+#define GOL_ARCB_BID_DIJKSTRA_ALGORITHM_H_
+
+namespace gol {
+
+// Bidirectional search on edge labels. Forward labels are those of the
+// arc-based search: out-edges of s start at 0 and an edge costs its 
+// weight plus the turn into it. Backward labels start at 0 on the
+// in-edges of t and hold the cost of the rest of the path after the
+// edge, so the two add up on the edge where the searches meet. Turns
+// forbidden by the turn tables are never taken.
+template <
+  typename GraphT,
+  typename Vertex, 
+  typename Workspace, 
+  typename WeightMap,
+  typename Stats>
+std::pair<typename Workspace::key_type, typename Workspace::distance_type>
+compact_graph_bidirectional_dijkstra_algorithm::compute(
+    const GraphT&     g, 
+    Vertex            s, 
+    Vertex            t, 
+    Workspace&        forward, 
+    Workspace&        backward, 
+    const WeightMap&  weight_map,
+    Stats&            stats)
+{
+  typedef typename Workspace::key_type       EdgeIndex;
+  typedef typename Workspace::distance_type  Distance;
+
+  const Distance  infinity = std::numeric_limits<Distance>::max();
+  const EdgeIndex none     = std::numeric_limits<EdgeIndex>::max();
+
+  // cost of turning at the head of in into out, infinite if forbidden
+  auto turn = [&g](EdgeIndex in, EdgeIndex out) {
+    auto     e_in  = edge_at(in, g);
+    auto     e_out = edge_at(out, g);
+    Vertex   u     = boost::target(e_in, g);
+    return g.has_turn_table(u) ?
+      g.turn_cost(u, g[e_in].entry_point, g[e_out].exit_point) : Distance();
+  };
+
+  auto relax = [&](Workspace& ws, Workspace& other, 
+                   EdgeIndex x, EdgeIndex y, Distance d, 
+                   Distance& mu, EdgeIndex& meet) {
+    if (d < ws.distance(y)) {
+      bool queued = ws.reached(y);
+      ws.set_distance(y, d);
+      ws.set_parent(y, x);
+      if (queued) ws.update(y); else ws.push(y);
+      if (other.reached(y) && d + other.distance(y) < mu) {
+        mu   = d + other.distance(y);
+        meet = y;
+      }
+    }
+  };
+
+  stopwatch chrono;
+  auto sr = boost::out_edges(s, g);
+  for (auto it = sr.first; it != sr.second; ++it) {
+    EdgeIndex idx = g[*it].edge_index;
+    forward.set_distance(idx, Distance());
+    forward.push(idx);
+  }
+  auto tr = boost::in_edges(t, g);
+  for (auto it = tr.first; it != tr.second; ++it) {
+    EdgeIndex idx = g[*it].edge_index;
+    backward.set_distance(idx, Distance());
+    backward.push(idx);
+  }
+
+  // an edge seeded by both is a path of one edge, that the arc-based
+  // search does not report either
+  Distance  mu   = infinity;
+  EdgeIndex meet = none;
+  for (;;)
+  {
+    Distance f_key = forward.empty()  ? 
+      infinity : forward.distance(forward.top());
+    Distance b_key = backward.empty() ? 
+      infinity : backward.distance(backward.top());
+    if (f_key == infinity || b_key == infinity || f_key + b_key >= mu)
+      break;
+
+    ++stats.visited_nodes;
+    if (f_key <= b_key) 
+    {
+      EdgeIndex in = forward.top(); forward.pop();
+      Vertex    u  = boost::target(edge_at(in, g), g);
+      auto r = boost::out_edges(u, g);
+      for (auto it = r.first; it != r.second; ++it)
+      {
+        EdgeIndex out = g[*it].edge_index;
+        Distance  c   = turn(in, out);
+        if (c == infinity)
+          continue; // restricted manoeuvre
+        relax(forward, backward, in, out, 
+              f_key + get(weight_map, *it) + c, mu, meet);
+      }
+    } 
+    else 
+    {
+      EdgeIndex out = backward.top(); backward.pop();
+      auto      e   = edge_at(out, g);
+      Vertex    u   = boost::source(e, g);
+      Distance  w   = get(weight_map, e);
+      auto r = boost::in_edges(u, g);
+      for (auto it = r.first; it != r.second; ++it)
+      {
+        EdgeIndex in = g[*it].edge_index;
+        Distance  c  = turn(in, out);
+        if (c == infinity)
+          continue; // restricted manoeuvre
+        relax(backward, forward, out, in, b_key + w + c, mu, meet);
+      }
+    }
+  }
+
+  chrono.lap();
+  stats.run_time = chrono.partial_wall_time();
+#ifdef DEBUG
+  logger(logDEBUG)
+    << left("[bidijkstra]", 14)
+    << left(">", 3)
+    << center("Visited Edges:", 20)
+    << " | " << stats.visited_nodes; // labels are edges
+  logger(logDEBUG)
+    << left("[bidijkstra]", 14)
+    << left(">", 3)
+    << center(" ", 20) << "  "
+    << right("run-time: " + prd(stats.run_time, 5) + "s", 40);
+#endif
+  return std::make_pair(meet, mu);
+}
+
+}  // namespace gol
+
+#endif // GOL_ARCB_BID_DIJKSTRA_ALGORITHM_H_
@@ -18,67 +18,41 @@
 #ifndef GOL_ARCB_DIJKSTRA_ALGORITHM_H_
 #define GOL_ARCB_DIJKSTRA_ALGORITHM_H_
 
-#include <boost/graph/reverse_graph.hpp>
-#include <boost/pending/mutable_queue.hpp>
-
 #include "../../graph/graph_compact_relax.h"
-#include "../../graph/graph_edge_index_indirect_cmp.h"
 
 namespace gol {
 
 template <
   typename GraphT,
   typename Vertex,
-  typename PredMap,
-  typename DistanceMap,
+  typename Workspace,
   typename WeightMap,
-  typename IndexMap,
-  typename ColorMap,
-  typename Visitor >
-void compact_graph_dijkstra_algorithm::arc_based_search(
+  typename Visitor,
+  typename Stats >
+bool compact_graph_dijkstra_algorithm::arc_based_search(
     GraphT&      g,
     Vertex       s,
-    PredMap      predecessor,
-    DistanceMap  distance,
+    Workspace&   workspace,
     WeightMap&   weight,
-    IndexMap&    index_map,
-    ColorMap     color,
-    Visitor&     vis)
+    Visitor&     vis,
+    Stats&       stats)
 {
   typedef boost::graph_traits<GraphT>        Traits;
   typedef typename Traits::edge_descriptor   Edge;
-  typedef typename Traits::vertex_iterator   VertexIterator;
-  typedef typename Traits::edge_iterator     EdgeIterator;
   typedef typename Traits::out_edge_iterator OutEdgeIterator;
-  typedef typename Traits::in_edge_iterator  InEdgeIterator;
-  typedef typename
-    boost::property_traits<ColorMap>
-      ::value_type                           ColorValue;
-  typedef typename
-    boost::color_traits<ColorValue>          Color;
-  typedef typename
-    boost::property_traits<DistanceMap>
-      ::value_type                           Distance;
-
-  EdgeIterator ei, ei_end;
-  for (tie(ei, ei_end) = boost::edges(g); ei != ei_end; ++ei)
-  {
-    put(distance, g[*ei].edge_index, std::numeric_limits<Distance>::max());
-    put(predecessor, g[*ei].edge_index, g[*ei].edge_index);
-    put(color, g[*ei].edge_index, Color::white());
-  }
+  typedef typename Workspace::key_type       EdgeIndex;
+  typedef boost::default_color_type          ColorValue;
+  typedef boost::color_traits<ColorValue>    Color;
+  typedef typename Workspace::distance_type  Distance;
 
   typedef typename std::less<Distance>          Compare;
   typedef typename boost::closed_plus<Distance> Combine;
-  typedef edge_index_indirect_cmp<
-                  GraphT, DistanceMap, Compare> IndirectCmp;
-  typedef typename boost::relaxed_heap<
-                 Edge, IndirectCmp, IndexMap>   MutableQueue;
+
+  workspace_predecessor_map<Workspace> predecessor(workspace);
+  workspace_distance_map<Workspace>    distance(workspace);
 
   Compare      compare;
   Combine      combine;
-  IndirectCmp  icmp(g, distance, compare);
-  MutableQueue Q(boost::num_edges(g), icmp, index_map);
 
   /*InEdgeIterator iei, iei_end;
   tie(iei, iei_end) = boost::in_edges(s, g);
@@ -94,22 +68,34 @@ void compact_graph_dijkstra_algorithm::arc_based_search(
   Q.push(source_incoming_e);*/
 
   OutEdgeIterator soei, soei_end;
-  for (tie(soei, soei_end) = out_edges(s, g); soei != soei_end; ++soei) 
+  for (boost::tie(soei, soei_end) = out_edges(s, g); soei != soei_end; ++soei) 
   {
-    put(distance, g[*soei].edge_index, 0);
-    put(color, g[*soei].edge_index, Color::gray());
+    EdgeIndex idx = g[*soei].edge_index;
+    workspace.set_distance(idx, Distance());
+    workspace.set_color(idx, Color::gray());
     vis.discover_vertex(s, g);             // <<
-    Q.push(*soei);
+    workspace.push(idx);
   }
 
-  while (! Q.empty())
+  while (! workspace.empty())
   {
-    Edge incoming_e = Q.top(); Q.pop();
+    EdgeIndex incoming_idx = workspace.top(); workspace.pop();
+    Edge      incoming_e   = edge_at(incoming_idx, g);
     Vertex u = boost::target(incoming_e, g);
-    vis.examine_vertex(u, g);              // <<
+    if (stalled(g, incoming_e, workspace))
+    {
+      // every out-edge of u was already relaxed at no greater cost
+      ++stats.stalled_nodes;
+      workspace.set_color(incoming_idx, Color::black());
+      continue;
+    }
+    // a seed reaching u is no route to it, see arc_based_gsolver
+    if (workspace.parent(incoming_idx) != incoming_idx &&
+        vis.examine_vertex(u, g) == stop_search)  // <<
+      return true;
 
     OutEdgeIterator oei, oei_end;
-    for (tie(oei, oei_end) = out_edges(u, g); oei != oei_end; ++oei)
+    for (boost::tie(oei, oei_end) = out_edges(u, g); oei != oei_end; ++oei)
     {
       Vertex v = boost::target(*oei, g);
 
@@ -118,7 +104,8 @@ void compact_graph_dijkstra_algorithm::arc_based_search(
 
       vis.examine_edge(*oei, g);           // <<
 
-      ColorValue v_color = get(color, g[*oei].edge_index);
+      EdgeIndex  v_idx   = g[*oei].edge_index;
+      ColorValue v_color = workspace.color(v_idx);
 
       bool decreased = false;
       if (v_color == Color::white())
@@ -130,19 +117,18 @@ void compact_graph_dijkstra_algorithm::arc_based_search(
         else
           vis.edge_not_relaxed(*oei, g);   // <<
 
-        put(color, g[*oei].edge_index, Color::gray());
+        workspace.set_color(v_idx, Color::gray());
         vis.discover_vertex(v, g);         // <<
-        Q.push(*oei);
+        workspace.push(v_idx);
       }
       else {
         if (v_color == Color::gray())
         {
           decreased = compact_relax( incoming_e, *oei, g, weight,
                                     predecessor, distance, combine, compare);
-          // TODO insert stalling pruning
           if (decreased)
           {
-            Q.update(*oei);
+            workspace.update(v_idx);
             vis.edge_relaxed(*oei, g);     // <<
           } else
             vis.edge_not_relaxed(*oei, g); // <<
@@ -150,20 +136,61 @@ void compact_graph_dijkstra_algorithm::arc_based_search(
         //else vis.black_target(*oei, g);
       }
     } // end for
-    put(color, g[incoming_e].edge_index, Color::black());
+    workspace.set_color(incoming_idx, Color::black());
     vis.finish_vertex(u, g);               // <<
   } // end while
 
+  return false;
+}
+
+template <
+  typename GraphT,
+  typename Workspace >
+bool compact_graph_dijkstra_algorithm::stalled(
+    const GraphT&      g,
+    typename boost::graph_traits<GraphT>::edge_descriptor e,
+    const Workspace&   workspace)
+{
+  typedef boost::graph_traits<GraphT>        Traits;
+  typedef typename Traits::in_edge_iterator  InEdgeIterator;
+  typedef typename Traits::out_edge_iterator OutEdgeIterator;
+  typedef typename Workspace::key_type       EdgeIndex;
+  typedef boost::default_color_type          ColorValue;
+  typedef boost::color_traits<ColorValue>    Color;
+
+  typename Traits::vertex_descriptor u = boost::target(e, g);
+  EdgeIndex e_idx = g[e].edge_index;
+
+  InEdgeIterator iei, iei_end;
+  for (boost::tie(iei, iei_end) = boost::in_edges(u, g); iei != iei_end; ++iei)
+  {
+    EdgeIndex f_idx = g[*iei].edge_index;
+    if (f_idx == e_idx
+        || workspace.color(f_idx) != Color::black()
+        || workspace.distance(e_idx) < workspace.distance(f_idx))
+      continue;
+    if (!g.has_turn_table(u))
+      return true;
+    // f dominates e only if no turn out of f costs more than from e
+    bool dominates = true;
+    OutEdgeIterator oei, oei_end;
+    for (boost::tie(oei, oei_end) = out_edges(u, g); 
+         dominates && oei != oei_end; ++oei)
+      dominates = 
+        g.turn_cost(u, g[*iei].entry_point, g[*oei].exit_point) <=
+        g.turn_cost(u, g[e].entry_point, g[*oei].exit_point);
+    if (dominates)
+      return true;
+  }
+  return false;
 }
 
 template <
   typename GraphT,
   typename Vertex,
   //typename Heuristic,
-  typename PredMap,
-  typename DistanceMap,
+  typename Workspace,
   typename WeightMap,
-  typename IndexMap,
   typename Visitor,
   typename Stats>
 void compact_graph_dijkstra_algorithm::compute(
@@ -171,33 +198,16 @@ void compact_graph_dijkstra_algorithm::compute(
      Vertex       s,
      Vertex       t,
      //Heuristic    h,
-     PredMap&     pred_map,
-     DistanceMap& distance_map,
+     Workspace&   workspace,
      WeightMap&   weight_map,
-     IndexMap&    index_map,
      Visitor&     visitor,
      Stats&       stats)
 {
-  typedef typename WeightMap::value_type WeightT;
-
   stopwatch chrono;
-  std::vector<boost::default_color_type>
-    color_map(boost::num_edges(g));
-
-  try {
-    arc_based_search (
-        g, s,
-        &pred_map[0],
-	      &distance_map[0],
-	      weight_map,
-        index_map,
-        &color_map[0],
-	      visitor);
-    throw target_not_found();
-  } catch (target_found& tf) {
-    // target found
-    chrono.lap();
-    stats.run_time = chrono.partial_wall_time();
+  if (!arc_based_search(g, s, workspace, weight_map, visitor, stats))
+    return;   // target not found
+  chrono.lap();
+  stats.run_time = chrono.partial_wall_time();
 #ifdef DEBUG
   logger(logDEBUG)
     << left("[dijkstra]", 14)
@@ -207,6 +217,11 @@ void compact_graph_dijkstra_algorithm::compute(
     << left(">", 3)
     << center("Visited Edges:", 20)
     << " | " << stats.visited_nodes; // labels are edges
+  logger(logDEBUG)
+    << left("[dijkstra]", 14)
+    << left(">", 3)
+    << center("Stalled Edges:", 20)
+    << " | " << stats.stalled_nodes;
   logger(logDEBUG)
     << left("[dijkstra]", 14)
     << left(">", 3)
@@ -217,8 +232,6 @@ void compact_graph_dijkstra_algorithm::compute(
     << center(" ", 20) << "  "
     << right("run-time: " + prd(stats.run_time, 5) + "s", 40);
 #endif
-  }
-
 }
 
 }  // namespace gol
@@ -18,14 +18,101 @@
 #ifndef GOL_DIJKSTRA_ALGORITHM_H_
 #define GOL_DIJKSTRA_ALGORITHM_H_
 
+#include <boost/graph/relax.hpp>
+
 namespace gol {  
 
+template < 
+  typename GraphT, 
+  typename Vertex, 
+  typename Workspace, 
+  typename WeightMap, 
+  typename Visitor >
+bool dijkstra_algorithm::search(
+    GraphT&     g, 
+    Vertex      s,
+    Workspace&  workspace,
+    WeightMap&  weight,
+    Visitor&    vis)
+{
+  typedef boost::graph_traits<GraphT>        Traits;
+  typedef typename Traits::edge_descriptor   Edge;
+  typedef typename Traits::out_edge_iterator OutEdgeIterator;
+  typedef boost::default_color_type          ColorValue;
+  typedef boost::color_traits<ColorValue>    Color;
+  typedef typename Workspace::distance_type  Distance;
+
+  typedef typename std::less<Distance>          Compare;
+  typedef typename boost::closed_plus<Distance> Combine;
+
+  workspace_predecessor_map<Workspace> predecessor(workspace);
+  workspace_distance_map<Workspace>    distance(workspace);
+
+  Compare compare;
+  Combine combine;
+
+  workspace.set_distance(s, Distance());
+  workspace.set_color(s, Color::gray());
+  vis.discover_vertex(s, g);               // <<
+  workspace.push(s);
+
+  while (! workspace.empty())
+  {
+    Vertex u = workspace.top(); workspace.pop();
+    if (vis.examine_vertex(u, g) == stop_search)  // <<
+      return true;
+
+    OutEdgeIterator oei, oei_end;
+    for (boost::tie(oei, oei_end) = out_edges(u, g); oei != oei_end; ++oei)
+    {
+      Edge   e = *oei;
+      Vertex v = boost::target(e, g);
+
+      if (compare(get(weight, e), Distance()))
+        throw boost::negative_edge();
+
+      vis.examine_edge(e, g);              // <<
+
+      ColorValue v_color = workspace.color(v);
+
+      bool decreased = false;
+      if (v_color == Color::white())
+      {
+        decreased = boost::relax(e, g, weight, 
+                                 predecessor, distance, combine, compare);
+        if (decreased)
+          vis.edge_relaxed(e, g);          // <<
+        else
+          vis.edge_not_relaxed(e, g);      // <<
+
+        workspace.set_color(v, Color::gray());
+        vis.discover_vertex(v, g);         // <<
+        workspace.push(v);
+      }
+      else if (v_color == Color::gray())
+      {
+        decreased = boost::relax(e, g, weight, 
+                                 predecessor, distance, combine, compare);
+        if (decreased)
+        {
+          workspace.update(v);
+          vis.edge_relaxed(e, g);          // <<
+        } else
+          vis.edge_not_relaxed(e, g);      // <<
+      }
+    } // end for
+    workspace.set_color(u, Color::black());
+    vis.finish_vertex(u, g);               // <<
+  } // end while
+
+  return false;
+}
+
 template <
   typename GraphT,
   typename Vertex, 
   //typename Heuristic, 
-  typename PredMap, 
-  typename DistanceMap, 
+  typename Workspace, 
   typename WeightMap,
   //typename Compare,  
   typename Visitor,  
@@ -35,27 +122,16 @@ void dijkstra_algorithm::compute(
      Vertex       s, 
      Vertex       t, 
      //Heuristic    h, 
-     PredMap&     pred_map, 
-     DistanceMap& distance_map,
+     Workspace&   workspace, 
      WeightMap&   weight_map,
      Visitor&     visitor, 
      Stats&       stats) 
 {
-  typedef typename WeightMap::value_type WeightT;
-  
   stopwatch chrono;
-  try {
-    boost::dijkstra_shortest_paths (g, s,
-      boost::predecessor_map(&pred_map[0]).
-	      distance_map(&distance_map[0]).
-	        weight_map(weight_map).
-            //distance_compare(Compare(visitor)).
-	            visitor(visitor));
-    throw target_not_found();  
-  } catch (target_found& tf) {
-    // target found
-    chrono.lap();
-    stats.run_time = chrono.partial_wall_time();
+  if (!search(g, s, workspace, weight_map, visitor))
+    return;   // target not found
+  chrono.lap();
+  stats.run_time = chrono.partial_wall_time();
 #ifdef DEBUG
   logger(logDEBUG) 
     << left("[dijkstra]", 14) 
@@ -74,9 +150,7 @@ void dijkstra_algorithm::compute(
     << left(">", 3) 
     << center(" ", 20) << "  " 
     << right("run-time: " + prd(stats.run_time, 5) + "s", 40);    
-#endif 
-  }
- 
+#endif
 }  
 
 }  // namespace gol
@@ -24,8 +24,7 @@ template <
   typename GraphT,
   typename Vertex, 
   //typename Heuristic, 
-  typename PredMap, 
-  typename DistanceMap, 
+  typename Workspace, 
   typename WeightMap,
   //typename Compare,  
   typename Visitor,  
@@ -35,24 +34,16 @@ void multi_target_dijkstra_algorithm::compute(
      Vertex s, 
      std::vector<Vertex> t_vec, 
      //Heuristic h, 
-     PredMap& pred_map, 
-     DistanceMap& distance_map,
+     Workspace& workspace, 
      WeightMap& weight_map,
      Visitor& visitor, 
      Stats& stats) 
 {
   stopwatch chrono;
-  try {
-    boost::dijkstra_shortest_paths (g, s,
-      boost::predecessor_map(&pred_map[0]).
-        distance_map(&distance_map[0]).
-          weight_map(weight_map).
-            visitor(visitor));
-    throw target_not_found();
-  } catch (all_targets_found& tf) {
-    // targets found
-    chrono.lap();
-    stats.run_time = chrono.partial_wall_time();
+  if (!dijkstra_algorithm::search(g, s, workspace, weight_map, visitor))
+    return;   // a target was not reached
+  chrono.lap();
+  stats.run_time = chrono.partial_wall_time();
 #ifdef DEBUG
   logger(logDEBUG) 
     << left("[dijkstra]", 14) 
@@ -71,9 +62,7 @@ void multi_target_dijkstra_algorithm::compute(
     << left(">", 3) 
     << center(" ", 20) << "  " 
     << right("run-time: " + prd(stats.run_time, 5) + "s", 40);    
-#endif     
-  }  
-
+#endif
 }
 
 }  // namespace gol
@@ -0,0 +1,217 @@
+// This file is part of Sii-Mobility - Algorithms Optimized Delivering.
+//
+// Copyright (C) 2017 GOL Lab http://webgol.dinfo.unifi.it/ - University of Florence
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with This program.  If not, see <http://www.gnu.org/licenses/>.
+#ifndef GOL_PHANTOM_DIJKSTRA_ALGORITHM_H_
+#define GOL_PHANTOM_DIJKSTRA_ALGORITHM_H_
+
+namespace gol {
+
+// Targets sorted by key, so that a settled label finds its entries by
+// binary search; several targets may share a key
+template <typename Key, typename Distance>
+std::vector<std::pair<Key, size_t> > phantom_target_index(
+    const std::vector<std::pair<Key, Distance> >& targets)
+{
+  std::vector<std::pair<Key, size_t> > index;
+  for (size_t i = 0; i < targets.size(); ++i)
+    index.push_back(std::make_pair(targets[i].first, i));
+  std::sort(index.begin(), index.end());
+  return index;
+}
+
+// Label-setting search seeded with the sources at their initial
+// distances. A settled label completes the path to the targets at its
+// key, mu is the best such cost so far (bound at first): once the 
+// queue holds no label below mu no target can improve on it.
+template <
+  typename GraphT,
+  typename Workspace,
+  typename WeightMap,
+  typename Stats>
+std::pair<size_t, typename Workspace::distance_type>
+phantom_dijkstra_algorithm::compute(
+    const GraphT&     g,
+    const std::vector<
+      std::pair<typename Workspace::key_type,
+        typename Workspace::distance_type> >& sources,
+    const std::vector<
+      std::pair<typename Workspace::key_type,
+        typename Workspace::distance_type> >& targets,
+    typename Workspace::distance_type         bound,
+    Workspace&        workspace,
+    const WeightMap&  weight_map,
+    Stats&            stats)
+{
+  typedef typename Workspace::key_type       Vertex;
+  typedef typename Workspace::distance_type  Distance;
+
+  stopwatch chrono;
+  workspace.reset(boost::num_vertices(g));
+  for (auto& s : sources)
+    if (s.second < workspace.distance(s.first)) {
+      bool queued = workspace.reached(s.first);
+      workspace.set_distance(s.first, s.second);
+      if (queued) workspace.update(s.first); else workspace.push(s.first);
+    }
+
+  auto   index = phantom_target_index(targets);
+  size_t best  = targets.size();
+  Distance mu  = bound;
+  while (!workspace.empty())
+  {
+    Vertex   u  = workspace.top(); workspace.pop();
+    Distance du = workspace.distance(u);
+    if (du >= mu)
+      break;
+    ++stats.visited_nodes;
+
+    auto tr = std::equal_range(index.begin(), index.end(), 
+      std::make_pair(u, size_t()), 
+      [](const std::pair<Vertex, size_t>& a, 
+         const std::pair<Vertex, size_t>& b) { return a.first < b.first; });
+    for (auto it = tr.first; it != tr.second; ++it)
+      if (du + targets[it->second].second < mu) {
+        mu   = du + targets[it->second].second;
+        best = it->second;
+      }
+
+    auto r = boost::out_edges(u, g);
+    for (auto it = r.first; it != r.second; ++it)
+    {
+      Vertex   v  = boost::target(*it, g);
+      Distance dv = du + get(weight_map, *it);
+      if (dv < mu && dv < workspace.distance(v)) {
+        bool queued = workspace.reached(v);
+        workspace.set_distance(v, dv);
+        workspace.set_parent(v, u);
+        if (queued) workspace.update(v); else workspace.push(v);
+      }
+    }
+  }
+
+  chrono.lap();
+  stats.run_time = chrono.partial_wall_time();
+#ifdef DEBUG
+  logger(logDEBUG)
+    << left("[dijkstra]", 14)
+    << left(">", 3)
+    << center("Visited Nodes:", 20)
+    << " | " << stats.visited_nodes;
+  logger(logDEBUG)
+    << left("[dijkstra]", 14)
+    << left(">", 3)
+    << center(" ", 20) << "  "
+    << right("run-time: " + prd(stats.run_time, 5) + "s", 40);
+#endif
+  return std::make_pair(best, mu);
+}
+
+// As compute, on edge labels: a label is the cost at the head of its
+// edge, so going on from in to out costs the turn and the weight of out
+template <
+  typename GraphT,
+  typename Workspace,
+  typename WeightMap,
+  typename Stats>
+std::pair<size_t, typename Workspace::distance_type>
+phantom_dijkstra_algorithm::arc_based_compute(
+    const GraphT&     g,
+    const std::vector<
+      std::pair<typename Workspace::key_type,
+        typename Workspace::distance_type> >& sources,
+    const std::vector<
+      std::pair<typename Workspace::key_type,
+        typename Workspace::distance_type> >& targets,
+    typename Workspace::distance_type         bound,
+    Workspace&        workspace,
+    const WeightMap&  weight_map,
+    Stats&            stats)
+{
+  typedef typename Workspace::key_type       EdgeIndex;
+  typedef typename Workspace::distance_type  Distance;
+
+  const Distance infinity = std::numeric_limits<Distance>::max();
+
+  stopwatch chrono;
+  workspace.reset(boost::num_edges(g));
+  for (auto& s : sources)
+    if (s.second < workspace.distance(s.first)) {
+      bool queued = workspace.reached(s.first);
+      workspace.set_distance(s.first, s.second);
+      if (queued) workspace.update(s.first); else workspace.push(s.first);
+    }
+
+  auto   index = phantom_target_index(targets);
+  size_t best  = targets.size();
+  Distance mu  = bound;
+  while (!workspace.empty())
+  {
+    EdgeIndex in = workspace.top(); workspace.pop();
+    Distance  du = workspace.distance(in);
+    if (du >= mu)
+      break;
+    ++stats.visited_nodes;
+
+    auto tr = std::equal_range(index.begin(), index.end(), 
+      std::make_pair(in, size_t()), 
+      [](const std::pair<EdgeIndex, size_t>& a, 
+         const std::pair<EdgeIndex, size_t>& b) { return a.first < b.first; });
+    for (auto it = tr.first; it != tr.second; ++it)
+      if (du + targets[it->second].second < mu) {
+        mu   = du + targets[it->second].second;
+        best = it->second;
+      }
+
+    auto e_in = edge_at(in, g);
+    auto u    = boost::target(e_in, g);
+    auto r    = boost::out_edges(u, g);
+    for (auto it = r.first; it != r.second; ++it)
+    {
+      Distance c = g.has_turn_table(u) ?
+        g.turn_cost(u, g[e_in].entry_point, g[*it].exit_point) : Distance();
+      if (c == infinity)
+        continue; // restricted manoeuvre
+      EdgeIndex out = g[*it].edge_index;
+      Distance  dv  = du + c + get(weight_map, *it);
+      if (dv < mu && dv < workspace.distance(out)) {
+        bool queued = workspace.reached(out);
+        workspace.set_distance(out, dv);
+        workspace.set_parent(out, in);
+        if (queued) workspace.update(out); else workspace.push(out);
+      }
+    }
+  }
+
+  chrono.lap();
+  stats.run_time = chrono.partial_wall_time();
+#ifdef DEBUG
+  logger(logDEBUG)
+    << left("[dijkstra]", 14)
+    << left(">", 3)
+    << center("Visited Edges:", 20)
+    << " | " << stats.visited_nodes; // labels are edges
+  logger(logDEBUG)
+    << left("[dijkstra]", 14)
+    << left(">", 3)
+    << center(" ", 20) << "  "
+    << right("run-time: " + prd(stats.run_time, 5) + "s", 40);
+#endif
+  return std::make_pair(best, mu);
+}
+
+}  // namespace gol
+
+#endif // GOL_PHANTOM_DIJKSTRA_ALGORITHM_H_
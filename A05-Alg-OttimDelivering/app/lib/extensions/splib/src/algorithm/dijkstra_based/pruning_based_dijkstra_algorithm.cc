@@ -18,8 +18,7 @@
 #ifndef GOL_PRUN_DIJKSTRA_ALGORITHM_H_
 #define GOL_PRUN_DIJKSTRA_ALGORITHM_H_
 
-#include <boost/graph/reverse_graph.hpp>
-#include <boost/pending/mutable_queue.hpp>
+#include <boost/graph/relax.hpp>
 
 namespace gol {
 
@@ -27,102 +26,87 @@ namespace gol {
 template < 
   typename GraphT, 
   typename Vertex, 
-  typename PredMap, 
-  typename DistanceMap, 
+  typename Workspace, 
   typename WeightMap,
-  typename IndexMap,
-  typename ColorMap, 
-  typename Visitor >
-void pruning_based_dijkstra_algorithm::pruning_based_search(
+  typename Pruning,
+  typename Visitor,
+  typename Stats >
+bool pruning_based_dijkstra_algorithm::pruning_based_search(
     GraphT&      g, 
     Vertex       s,
-    PredMap      predecessor,
-    DistanceMap  distance,
+    Workspace&   workspace,
     WeightMap&   weight,
-    IndexMap     index_map,
-    ColorMap     color,
-    Visitor&     vis)
+    Pruning&     pruning,
+    Visitor&     vis,
+    Stats&       stats)
 {
   typedef boost::graph_traits<GraphT>        Traits;
-  typedef typename Traits::edge_descriptor   Edge;
-  typedef typename Traits::vertex_iterator   VertexIterator;
   typedef typename Traits::out_edge_iterator EdgeIterator;
   
-  typedef typename 
-    boost::property_traits<ColorMap>::value_type    ColorValue;
-  typedef typename 
-    boost::color_traits<ColorValue>                 Color;
-  typedef typename 
-    boost::property_traits<DistanceMap>::value_type Distance;   
-
-  VertexIterator ui, ui_end;
-  for (boost::tie(ui, ui_end) = vertices(g); ui != ui_end; ++ui) 
-  {
-    put(distance, *ui, std::numeric_limits<Distance>::max());
-    put(predecessor, *ui, *ui);
-    put(color, *ui, Color::white());
-  }
+  typedef boost::default_color_type          ColorValue;
+  typedef boost::color_traits<ColorValue>    Color;
+  typedef typename Workspace::distance_type  Distance;   
+
+  workspace_predecessor_map<Workspace> predecessor(workspace);
+  workspace_distance_map<Workspace>    distance(workspace);
 
   typedef typename std::less<Distance> Compare;
   Compare compare;
   typedef typename boost::closed_plus<Distance> Combine;
   Combine combine;
-  typedef typename boost::indirect_cmp<DistanceMap, Compare> IndirectCmp;
-  IndirectCmp icmp(distance, compare);
-  typedef typename boost::relaxed_heap<Vertex, IndirectCmp, IndexMap> 
-    MutableQueue;
-
-  Edge e; bool found;
 
-  MutableQueue Q(num_vertices(g), icmp, index_map);
-
-  put(distance, s, 0); 
-  put(color, s, Color::gray()); 
+  workspace.set_distance(s, Distance()); 
+  workspace.set_color(s, Color::gray()); 
   vis.discover_vertex(s, g);             // <<
-  Q.push(s);
-  while (! Q.empty()) 
+  workspace.push(s);
+  while (! workspace.empty()) 
   {
-    Vertex u = Q.top(); Q.pop();            
-    put(color, s, Color::gray()); 
-    vis.examine_vertex(u, g);            // <<
+    Vertex u = workspace.top(); workspace.pop();            
+    if (vis.examine_vertex(u, g) == stop_search)  // <<
+      return true;
         
     EdgeIterator ei, ei_end;
-    for (tie(ei, ei_end) = out_edges(u, g); ei != ei_end; ++ei) 
+    for (boost::tie(ei, ei_end) = out_edges(u, g); ei != ei_end; ++ei) 
     {
       Vertex v = target(*ei, g);      
 
-      // TODO to avoid relax operation
-      //if ( /*Condition*/ )
-      //  continue;
-  
       if (compare(get(weight, *ei), 0))
         throw boost::negative_edge();
 
+      ColorValue v_color = workspace.color(v);
+
+      // pruned edges are never relaxed, settled targets need no check
+      if (v_color != Color::black() &&
+          pruning(*ei, combine(workspace.distance(u), get(weight, *ei))))
+      {
+        ++stats.pruned_edges;
+        continue;
+      }
+
       vis.examine_edge(*ei, g);           // <<
-      ColorValue v_color = get(color, v);
 
       bool decreased = false;
       if (v_color == Color::white())
       {      
-        decreased = relax(*ei, g, weight, predecessor, distance,
-                                combine, compare);
+        decreased = boost::relax(*ei, g, weight, predecessor, distance,
+                                 combine, compare);
         if (decreased)
           vis.edge_relaxed(*ei, g);       // <<
         else
           vis.edge_not_relaxed(*ei, g);   // <<
 
-        put(color, v, Color::gray()); 
+        workspace.set_color(v, Color::gray()); 
         vis.discover_vertex(v, g);        // <<
-        Q.push(v);
+        workspace.push(v);
       } else 
       {                              
         if (v_color == Color::gray())       
         {
-          decreased = relax(*ei, g, weight, predecessor, distance,
-                                  combine, compare);
+          decreased = boost::relax(*ei, g, weight, predecessor, distance,
+                                   combine, compare);
           if (decreased) 
           {
-            Q.update(target(*ei, g));
+            workspace.update(v);
             vis.edge_relaxed(*ei, g);     // <<
           } else
             vis.edge_not_relaxed(*ei, g); // <<
@@ -130,20 +114,21 @@ void pruning_based_dijkstra_algorithm::pruning_based_search(
         //else vis.black_target(*ei, g);
       }
     } // end for
-    put(color, u, Color::black()); 
+    workspace.set_color(u, Color::black()); 
     vis.finish_vertex(u, g);              // <<
   } // end while
 
+  return false;
 }   
 
 template <
   typename GraphT,
   typename Vertex, 
   //typename Heuristic, 
-  typename PredMap, 
-  typename DistanceMap, 
+  typename Workspace, 
   typename WeightMap,
   //typename Compare,  
+  typename Pruning,  
   typename Visitor,  
   typename Stats>
 void pruning_based_dijkstra_algorithm::compute(
@@ -151,32 +136,17 @@ void pruning_based_dijkstra_algorithm::compute(
      Vertex       s, 
      Vertex       t, 
      //Heuristic    h, 
-     PredMap&     pred_map, 
-     DistanceMap& distance_map,
+     Workspace&   workspace, 
      WeightMap&   weight_map,
+     Pruning&     pruning, 
      Visitor&     visitor, 
      Stats&       stats) 
 {
-  typedef typename WeightMap::value_type WeightT;
-  
   stopwatch chrono;
-  std::vector<boost::default_color_type> 
-    color_map(boost::num_vertices(g));
-
-  try {
-    turn_restriction_search (
-        g, s, 
-        &pred_map[0],
-	      &distance_map[0],
-	      weight_map,
-        get(boost::vertex_index, g),
-        &color_map[0],
-	      visitor);
-    throw target_not_found();  
-  } catch (target_found& tf) {
-    // target found
-    chrono.lap();
-    stats.run_time = chrono.partial_wall_time();
+  if (!pruning_based_search(g, s, workspace, weight_map, pruning, visitor, stats))
+    return;   // target not found
+  chrono.lap();
+  stats.run_time = chrono.partial_wall_time();
 #ifdef DEBUG
   logger(logDEBUG) 
     << left("[dijkstra]", 14) 
@@ -186,6 +156,11 @@ void pruning_based_dijkstra_algorithm::compute(
     << left(">", 3) 
     << center("Visited Nodes:", 20) 
     << " | " << stats.visited_nodes;
+  logger(logDEBUG) 
+    << left("[dijkstra]", 14) 
+    << left(">", 3) 
+    << center("Pruned Edges:", 20) 
+    << " | " << stats.pruned_edges;
   logger(logDEBUG) 
     << left("[dijkstra]", 14) 
     << left(">", 3) 
@@ -195,9 +170,7 @@ void pruning_based_dijkstra_algorithm::compute(
     << left(">", 3) 
     << center(" ", 20) << "  " 
     << right("run-time: " + prd(stats.run_time, 5) + "s", 40);    
-#endif 
-  }
- 
+#endif
 }  
 
 }  // namespace gol
@@ -22,5 +22,9 @@
 #include "dijkstra_based/multi_target_dijkstra_algorithm.cc"
 #include "dijkstra_based/pruning_based_dijkstra_algorithm.cc" 
 #include "dijkstra_based/compact_graph_dijkstra_algorithm.cc"
+#include "dijkstra_based/bidirectional_dijkstra_algorithm.cc"
+#include "dijkstra_based/compact_graph_bidirectional_dijkstra_algorithm.cc"
+#include "dijkstra_based/phantom_dijkstra_algorithm.cc"
+#include "dijkstra_based/alt_algorithm.cc"
 
 #endif // GOL_DIJKSTRA_BASED_ALGORITHM_H_
\ No newline at end of file
@@ -0,0 +1,165 @@
+// This file is part of Sii-Mobility - Algorithms Optimized Delivering.
+//
+// Copyright (C) 2017 GOL Lab http://webgol.dinfo.unifi.it/ - University of Florence
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with This program.  If not, see <http://www.gnu.org/licenses/>.
+
+#ifndef GOL_CONTRACTION_HIERARCHY_ALGORITHM_H_
+#define GOL_CONTRACTION_HIERARCHY_ALGORITHM_H_
+
+namespace gol {
+
+// Bidirectional Dijkstra on a contraction hierarchy: the forward search
+// follows up arcs from the sources, the backward search follows down
+// arcs (reversed) from the targets. The shortest path is the best sum
+// over nodes labelled by both; a direction stops once its queue cannot
+// improve it anymore.
+template <
+  typename HierarchyT,
+  typename Workspace,
+  typename Stats>
+std::pair<uint32_t, typename Workspace::distance_type>
+contraction_hierarchy_algorithm::compute(
+    const HierarchyT&  h,
+    const std::vector<
+      std::pair<uint32_t, 
+        typename Workspace::distance_type> >& sources,
+    const std::vector<
+      std::pair<uint32_t, 
+        typename Workspace::distance_type> >& targets,
+    Workspace&         forward,
+    Workspace&         backward,
+    Stats&             stats)
+{
+  typedef typename Workspace::distance_type  Distance;
+  typedef typename HierarchyT::arc_range     ArcRange;
+  typedef typename HierarchyT::arc_t         Arc;
+
+  const Distance infinity = std::numeric_limits<Distance>::max();
+  const uint32_t none     = Arc::none;
+
+  stopwatch chrono;
+  forward.reset(h.num_nodes());
+  backward.reset(h.num_nodes());
+  for (auto& s : sources)
+    if (s.second < forward.distance(s.first)) {
+      bool queued = forward.reached(s.first);
+      forward.set_distance(s.first, s.second);
+      if (queued) forward.update(s.first); else forward.push(s.first);
+    }
+  for (auto& t : targets)
+    if (t.second < backward.distance(t.first)) {
+      bool queued = backward.reached(t.first);
+      backward.set_distance(t.first, t.second);
+      if (queued) backward.update(t.first); else backward.push(t.first);
+    }
+
+  Distance mu   = infinity;
+  uint32_t meet = none;
+  for (;;)
+  {
+    Distance f_key = forward.empty()  ? 
+      infinity : forward.distance(forward.top());
+    Distance b_key = backward.empty() ? 
+      infinity : backward.distance(backward.top());
+    if (std::min(f_key, b_key) >= mu)
+      break; // also when both queues are empty
+
+    const bool is_forward = f_key <= b_key;
+    Workspace& ws    = is_forward ? forward  : backward;
+    Workspace& other = is_forward ? backward : forward;
+
+    uint32_t u = ws.top(); ws.pop();
+    ++stats.visited_nodes;
+    Distance du = ws.distance(u);
+    if (other.reached(u) && du + other.distance(u) < mu) {
+      mu   = du + other.distance(u);
+      meet = u;
+    }
+
+    ArcRange r = is_forward ? h.up_arcs(u) : h.down_arcs(u);
+    for (auto it = r.first; it != r.second; ++it)
+    {
+      const Arc& a  = h.arc(*it);
+      uint32_t   v  = is_forward ? a.head : a.tail;
+      Distance   dv = du + a.weight;
+      if (dv < ws.distance(v)) {
+        bool queued = ws.reached(v);
+        ws.set_distance(v, dv);
+        ws.set_parent(v, u);
+        if (queued) ws.update(v); else ws.push(v);
+      }
+    }
+  }
+
+  chrono.lap();
+  stats.run_time = chrono.partial_wall_time();
+#ifdef DEBUG
+  logger(logDEBUG) 
+    << left("[ch]", 14) 
+    << left(">", 3) 
+    << center("Visited Nodes:", 20) 
+    << " | " << stats.visited_nodes;
+  logger(logDEBUG) 
+    << left("[ch]", 14) 
+    << left(">", 3) 
+    << center(" ", 20) << "  " 
+    << right("run-time: " + prd(stats.run_time, 5) + "s", 40);    
+#endif 
+  return std::make_pair(meet, mu);
+}
+
+template <
+  typename HierarchyT,
+  typename Workspace,
+  typename OutputIterator>
+void contraction_hierarchy_algorithm::unpack_path(
+    const HierarchyT&  h,
+    uint32_t           meet,
+    const Workspace&   forward,
+    const Workspace&   backward,
+    OutputIterator     out)
+{
+  typedef typename HierarchyT::arc_range     ArcRange;
+  typedef typename HierarchyT::arc_t         Arc;
+  typedef typename HierarchyT::arc_index_t   ArcIndex;
+
+  // cheapest arc u -> v among the given ones
+  auto find_arc = [&h](ArcRange r, uint32_t u, uint32_t v) {
+    ArcIndex found = Arc::none;
+    for (auto it = r.first; it != r.second; ++it) {
+      const Arc& a = h.arc(*it);
+      if (a.tail == u && a.head == v &&
+          (found == Arc::none || a.weight < h.arc(found).weight))
+        found = *it;
+    }
+    return found;
+  };
+
+  // sources -> meet, walked backwards
+  std::vector<ArcIndex> chain;
+  for (uint32_t v = meet; forward.parent(v) != v; v = forward.parent(v))
+    chain.push_back(find_arc(h.up_arcs(forward.parent(v)), forward.parent(v), v));
+  std::reverse(chain.begin(), chain.end());
+  // meet -> targets
+  for (uint32_t v = meet; backward.parent(v) != v; v = backward.parent(v))
+    chain.push_back(find_arc(h.down_arcs(backward.parent(v)), v, backward.parent(v)));
+
+  for (ArcIndex a : chain)
+    h.unpack(a, out);
+}
+
+}  // namespace gol
+
+#endif // GOL_CONTRACTION_HIERARCHY_ALGORITHM_H_
@@ -0,0 +1,198 @@
+// This file is part of Sii-Mobility - Algorithms Optimized Delivering.
+//
+// Copyright (C) 2017 GOL Lab http://webgol.dinfo.unifi.it/ - University of Florence
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with This program.  If not, see <http://www.gnu.org/licenses/>.
+
+#ifndef GOL_MANY_TO_MANY_ALGORITHM_H_
+#define GOL_MANY_TO_MANY_ALGORITHM_H_
+
+#include "../../utils/work_stealing_pool.h"
+
+namespace gol {
+
+template <
+  typename HierarchyT,
+  typename WeightT,
+  typename Workspace>
+void many_to_many_algorithm::search(
+    const HierarchyT&  h,
+    const std::vector<many_to_many_label<WeightT> >& seeds,
+    bool               forward,
+    const std::vector<double>&  arc_lengths,
+    const std::vector<double>&  arc_durations,
+    Workspace&         ws,
+    std::vector<many_to_many_label<WeightT> >& settled)
+{
+  typedef typename HierarchyT::arc_range     ArcRange;
+  typedef typename HierarchyT::arc_t         Arc;
+  typedef many_to_many_label<WeightT>        Label;
+
+  const uint32_t none = Arc::none;
+
+  // the parent of a node is the position of its predecessor among the
+  // settled labels, none for seeds
+  ws.reset(h.num_nodes());
+  for (auto& s : seeds)
+    if (s.weight < ws.distance(s.node)) {
+      bool queued = ws.reached(s.node);
+      ws.set_distance(s.node, s.weight);
+      ws.set_parent(s.node, none);
+      if (queued) ws.update(s.node); else ws.push(s.node);
+    }
+
+  const size_t first = settled.size();
+  while (!ws.empty())
+  {
+    uint32_t u = ws.top(); ws.pop();
+    Label l = {u, 0, ws.distance(u), 0, 0};
+    if (ws.parent(u) == none) 
+    {
+      for (auto& s : seeds)
+        if (s.node == u && s.weight == l.weight) {
+          l.length   = s.length;
+          l.duration = s.duration;
+          break;
+        }
+    } 
+    else 
+    {
+      // the arc the predecessor relaxed u with
+      const Label& p = settled[first + ws.parent(u)];
+      ArcRange r = forward ? h.up_arcs(p.node) : h.down_arcs(p.node);
+      for (auto it = r.first; it != r.second; ++it)
+      {
+        const Arc& a = h.arc(*it);
+        if ((forward ? a.head : a.tail) == u && 
+            p.weight + a.weight == l.weight) {
+          l.length   = p.length   + arc_lengths[*it];
+          l.duration = p.duration + arc_durations[*it];
+          break;
+        }
+      }
+    }
+    const uint32_t pos = settled.size() - first;
+    settled.push_back(l);
+
+    ArcRange r = forward ? h.up_arcs(u) : h.down_arcs(u);
+    for (auto it = r.first; it != r.second; ++it)
+    {
+      const Arc& a  = h.arc(*it);
+      uint32_t   v  = forward ? a.head : a.tail;
+      WeightT    dv = l.weight + a.weight;
+      if (dv < ws.distance(v)) {
+        bool queued = ws.reached(v);
+        ws.set_distance(v, dv);
+        ws.set_parent(v, pos);
+        if (queued) ws.update(v); else ws.push(v);
+      }
+    }
+  }
+}
+
+template <
+  typename HierarchyT,
+  typename WeightT,
+  typename Stats>
+void many_to_many_algorithm::compute(
+    const HierarchyT&  h,
+    const std::vector<
+      std::vector<many_to_many_label<WeightT> > >& sources,
+    const std::vector<
+      std::vector<many_to_many_label<WeightT> > >& targets,
+    const std::vector<double>&  arc_lengths,
+    const std::vector<double>&  arc_durations,
+    std::vector<WeightT>&       weights,
+    std::vector<double>&        lengths,
+    std::vector<double>&        durations,
+    Stats&                      stats)
+{
+  typedef many_to_many_label<WeightT>        Label;
+
+  const size_t n = sources.size();
+  const size_t m = targets.size();
+  work_stealing_pool& pool = work_stealing_pool::instance();
+  const unsigned n_workers = pool.size();
+
+  stopwatch chrono;
+  weights.assign(n * m, std::numeric_limits<WeightT>::max());
+  lengths.assign(n * m, std::numeric_limits<double>::infinity());
+  durations.assign(n * m, std::numeric_limits<double>::infinity());
+
+  // backward searches, bucket entries by worker
+  std::vector<std::vector<Label> > entries(n_workers);
+  std::vector<size_t> visited(n_workers, 0);
+  pool.parallel_for(m, [&](unsigned w, size_t j) {
+    search_workspace<uint32_t, WeightT>& ws = 
+      thread_search_workspace<uint32_t, WeightT, many_to_many_algorithm>();
+    const size_t first = entries[w].size();
+    search(h, targets[j], false, arc_lengths, arc_durations, ws, entries[w]);
+    for (size_t k = first; k < entries[w].size(); ++k)
+      entries[w][k].index = j;
+    visited[w] += entries[w].size() - first;
+  });
+
+  // buckets by node
+  std::vector<uint32_t> offsets(h.num_nodes() + 1, 0);
+  for (auto& e : entries)
+    for (auto& l : e)
+      ++offsets[l.node + 1];
+  for (uint32_t u = 0; u < h.num_nodes(); ++u)
+    offsets[u + 1] += offsets[u];
+  std::vector<Label> buckets(offsets.back());
+  {
+    std::vector<uint32_t> fill(offsets.begin(), offsets.end() - 1);
+    for (auto& e : entries) 
+    {
+      for (auto& l : e)
+        buckets[fill[l.node]++] = l;
+      std::vector<Label>().swap(e);
+    }
+  }
+
+  // forward searches, a row each
+  pool.parallel_for(n, [&](unsigned w, size_t i) {
+    search_workspace<uint32_t, WeightT>& ws = 
+      thread_search_workspace<uint32_t, WeightT, many_to_many_algorithm>();
+    std::vector<Label> settled;
+    search(h, sources[i], true, arc_lengths, arc_durations, ws, settled);
+    visited[w] += settled.size();
+    for (const Label& l : settled)
+      for (uint32_t k = offsets[l.node]; k < offsets[l.node + 1]; ++k)
+      {
+        const Label& b = buckets[k];
+        const size_t c = i * m + b.index;
+        if (l.weight + b.weight < weights[c]) {
+          weights[c]   = l.weight   + b.weight;
+          lengths[c]   = l.length   + b.length;
+          durations[c] = l.duration + b.duration;
+        }
+      }
+  });
+
+  for (size_t v : visited)
+    stats.visited_nodes += v;
+  chrono.lap();
+  stats.run_time = chrono.partial_wall_time();
+
+  logger(logINFO) 
+    << left("[m2m]", 14) 
+    << n << " x " << m << " matrix, "
+    << buckets.size() << " bucket entries, "
+    << prd(stats.run_time, 3) << "s";
+}
+
+}  // namespace gol
+
+#endif // GOL_MANY_TO_MANY_ALGORITHM_H_
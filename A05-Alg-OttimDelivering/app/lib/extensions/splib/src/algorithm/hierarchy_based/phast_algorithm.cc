@@ -0,0 +1,116 @@
+// This file is part of Sii-Mobility - Algorithms Optimized Delivering.
+//
+// Copyright (C) 2017 GOL Lab http://webgol.dinfo.unifi.it/ - University of Florence
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with This program.  If not, see <http://www.gnu.org/licenses/>.
+
+#ifndef GOL_PHAST_ALGORITHM_H_
+#define GOL_PHAST_ALGORITHM_H_
+
+namespace gol {
+
+// PHAST: every shortest path of a hierarchy is an up path then a down
+// path, so after the upward search from the sources a node takes its
+// distance from the higher ranked tails of its down arcs. Sweeping the
+// nodes in descending rank settles each one once all of those tails
+// are. Labels beyond limit are never propagated: weights are non
+// negative, nothing reached through them is within limit.
+template <
+  typename HierarchyT,
+  typename Workspace,
+  typename Stats>
+void phast_algorithm::compute(
+    const HierarchyT&  h,
+    const std::vector<
+      std::pair<uint32_t,
+        typename Workspace::distance_type> >& sources,
+    typename Workspace::distance_type         limit,
+    Workspace&         workspace,
+    std::vector<typename Workspace::distance_type>& distances,
+    Stats&             stats)
+{
+  typedef typename Workspace::distance_type  Distance;
+  typedef typename HierarchyT::arc_range     ArcRange;
+  typedef typename HierarchyT::arc_t         Arc;
+
+  const Distance inf = std::numeric_limits<Distance>::max();
+
+  stopwatch chrono;
+  distances.assign(h.num_nodes(), inf);
+
+  // upward search
+  workspace.reset(h.num_nodes());
+  for (auto& s : sources)
+    if (s.second <= limit && s.second < workspace.distance(s.first)) {
+      bool queued = workspace.reached(s.first);
+      workspace.set_distance(s.first, s.second);
+      if (queued) workspace.update(s.first); else workspace.push(s.first);
+    }
+  while (!workspace.empty())
+  {
+    uint32_t u = workspace.top(); workspace.pop();
+    Distance du = workspace.distance(u);
+    distances[u] = du;
+    ++stats.visited_nodes;
+
+    ArcRange r = h.up_arcs(u);
+    for (auto it = r.first; it != r.second; ++it)
+    {
+      const Arc& a  = h.arc(*it);
+      Distance   dv = du + a.weight;
+      if (dv <= limit && dv < workspace.distance(a.head)) {
+        bool queued = workspace.reached(a.head);
+        workspace.set_distance(a.head, dv);
+        if (queued) workspace.update(a.head); else workspace.push(a.head);
+      }
+    }
+  }
+
+  // downward sweep
+  for (uint32_t v : h.sweep_order())
+  {
+    Distance  dv = distances[v];
+    ArcRange  r  = h.down_arcs(v);
+    for (auto it = r.first; it != r.second; ++it)
+    {
+      const Arc& a  = h.arc(*it);
+      Distance   du = distances[a.tail];
+      if (du <= limit && du + a.weight < dv)
+        dv = du + a.weight;
+    }
+    if (dv <= limit) {
+      distances[v] = dv;
+      ++stats.expansions;
+    }
+  }
+  chrono.lap();
+  stats.run_time = chrono.partial_wall_time();
+
+#ifdef DEBUG
+  logger(logDEBUG)
+    << left("[phast]", 14)
+    << left(">", 3)
+    << center("Reached Nodes:", 20)
+    << " | " << stats.expansions;
+  logger(logDEBUG)
+    << left("[phast]", 14)
+    << left(">", 3)
+    << center(" ", 20) << "  "
+    << right("run-time: " + prd(stats.run_time, 5) + "s", 40);
+#endif
+}
+
+}  // namespace gol
+
+#endif // GOL_PHAST_ALGORITHM_H_
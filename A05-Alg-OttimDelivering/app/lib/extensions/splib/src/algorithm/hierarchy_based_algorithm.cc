@@ -0,0 +1,25 @@
+// This file is part of Sii-Mobility - Algorithms Optimized Delivering.
+//
+// Copyright (C) 2017 GOL Lab http://webgol.dinfo.unifi.it/ - University of Florence
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with This program.  If not, see <http://www.gnu.org/licenses/>.
+
+#ifndef GOL_HIERARCHY_BASED_ALGORITHM_H_
+#define GOL_HIERARCHY_BASED_ALGORITHM_H_
+
+#include "hierarchy_based/contraction_hierarchy_algorithm.cc"
+#include "hierarchy_based/many_to_many_algorithm.cc"
+#include "hierarchy_based/phast_algorithm.cc"
+
+#endif // GOL_HIERARCHY_BASED_ALGORITHM_H_
@@ -0,0 +1,151 @@
+// This file is part of Sii-Mobility - Algorithms Optimized Delivering.
+//
+// Copyright (C) 2017 GOL Lab http://webgol.dinfo.unifi.it/ - University of Florence
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with This program.  If not, see <http://www.gnu.org/licenses/>.
+
+#ifndef GOL_CUSTOMIZABLE_ROUTE_PLANNING_ALGORITHM_H_
+#define GOL_CUSTOMIZABLE_ROUTE_PLANNING_ALGORITHM_H_
+
+#include "../../graph/graph_overlay.h"
+
+namespace gol {
+
+struct crp_unpack_search {};
+
+// Dijkstra on the multilevel overlay: vertices in the cells of s or t
+// are scanned on the base graph, any other vertex on the highest level
+// at which its cell contains neither of them.
+template <
+  typename OverlayT,
+  typename Workspace,
+  typename WeightMap,
+  typename Stats>
+bool customizable_route_planning_algorithm::compute(
+    const OverlayT&    og,
+    uint32_t           s,
+    uint32_t           t,
+    Workspace&         workspace,
+    const WeightMap&   weight_map,
+    Stats&             stats)
+{
+  const multilevel_partition_t& p = og.partition();
+
+  stopwatch chrono;
+  bool found = false;
+  overlay_search(og.base(), p, og.metric().cliques(), weight_map, s,
+    [&p, s, t](uint32_t v) { return p.query_level(v, s, t); },
+    workspace,
+    [&](uint32_t v) { 
+      ++stats.visited_nodes; 
+      return found = (v == t); });
+
+  chrono.lap();
+  stats.run_time = chrono.partial_wall_time();
+#ifdef DEBUG
+  logger(logDEBUG) 
+    << left("[crp]", 14) 
+    << left(">", 3) 
+    << center("Visited Nodes:", 20) 
+    << " | " << stats.visited_nodes;
+  logger(logDEBUG) 
+    << left("[crp]", 14) 
+    << left(">", 3) 
+    << center(" ", 20) << "  " 
+    << right("run-time: " + prd(stats.run_time, 5) + "s", 40);    
+#endif 
+  return found;
+}
+
+template <
+  typename OverlayT,
+  typename Workspace,
+  typename WeightMap,
+  typename OutputIterator>
+void customizable_route_planning_algorithm::unpack_path(
+    const OverlayT&    og,
+    uint32_t           s,
+    uint32_t           t,
+    const Workspace&   workspace,
+    const WeightMap&   weight_map,
+    OutputIterator     out)
+{
+  const multilevel_partition_t& p = og.partition();
+
+  std::vector<overlay_step<typename Workspace::distance_type> > steps;
+  for (uint32_t v = t; workspace.parent(v) != v; v = workspace.parent(v)) {
+    uint32_t u = workspace.parent(v);
+    steps.push_back({u, v, p.query_level(u, s, t), 
+      workspace.distance(u), workspace.distance(v)});
+  }
+  std::reverse(steps.begin(), steps.end());
+
+  for (auto& step : steps)
+    unpack_step(og, weight_map, step, out);
+}
+
+// an edge u -> v that is tight is the step, anything else is a clique
+// of the cell u was scanned at: it is searched again on the level below
+template <
+  typename OverlayT,
+  typename WeightMap,
+  typename WeightT,
+  typename OutputIterator>
+void customizable_route_planning_algorithm::unpack_step(
+    const OverlayT&               og,
+    const WeightMap&              weight_map,
+    const overlay_step<WeightT>&  step,
+    OutputIterator                out)
+{
+  const multilevel_partition_t& p = og.partition();
+
+  auto r = boost::out_edges(step.u, og.base());
+  for (auto it = r.first; it != r.second; ++it)
+    if (boost::target(*it, og.base()) == step.v && 
+        step.du + get(weight_map, *it) == step.dv) {
+      *out++ = og.base()[*it].edge_index;
+      return;
+    }
+
+  const uint32_t l = step.level, c = p.cell(l, step.u);
+  if (l == 0)
+    throw solver_exception(
+      "customizable_route_planning_algorithm::unpack_step(): no edge for step");
+
+  auto& ws = thread_search_workspace<uint32_t, WeightT, crp_unpack_search>();
+  ws.reset(p.num_vertices());
+  overlay_search(og.base(), p, og.metric().cliques(), weight_map, step.u,
+    [&p, l, c](uint32_t v) { 
+      return p.cell(l, v) == c ? l - 1 : multilevel_partition_t::none; },
+    ws,
+    [&step](uint32_t v) { return v == step.v; });
+  if (!ws.reached(step.v))
+    throw solver_exception(
+      "customizable_route_planning_algorithm::unpack_step(): clique not found");
+
+  // the workspace is reused by the steps below
+  std::vector<overlay_step<WeightT> > steps;
+  for (uint32_t v = step.v; v != step.u; v = ws.parent(v)) {
+    uint32_t u = ws.parent(v);
+    steps.push_back({u, v, l - 1, ws.distance(u), ws.distance(v)});
+  }
+  std::reverse(steps.begin(), steps.end());
+
+  for (auto& sub : steps)
+    unpack_step(og, weight_map, sub, out);
+}
+
+}  // namespace gol
+
+#endif // GOL_CUSTOMIZABLE_ROUTE_PLANNING_ALGORITHM_H_
@@ -21,10 +21,11 @@
 // std
 #include <iostream>
 #include <fstream>
+#include <tuple>
+#include <utility>
 // boost
 #include <boost/serialization/string.hpp>
 #include <boost/serialization/utility.hpp>
-#include <boost/graph/adj_list_serialize.hpp>
 #include <boost/archive/xml_oarchive.hpp>
 #include <boost/archive/xml_iarchive.hpp>
 #include <boost/archive/binary_oarchive.hpp>
@@ -42,81 +43,8 @@ namespace gol {
 
   bool has(std::string filename);
 
-  // Gets the serialized entry from cache for that filename.
-  template <
-      typename GraphT, 
-      typename VertexMap,
-      typename EdgeMap,
-      typename Constraints>
-  bool load_road_network(
-      GraphT*         g, 
-      VertexMap*      vtx,
-      EdgeMap*        edg,
-      Constraints*    ctr, 
-      std::string     filename) 
-  {
-    typedef typename boost::graph_traits<GraphT>::edge_iterator 
-      edge_iterator;
-
-    try {
-      std::ifstream ifs(filename.c_str());
-      if (ifs.good()) {
-        boost::archive::binary_iarchive ia(ifs);
-        ia >> BOOST_SERIALIZATION_NVP(*g);
-        ia >> BOOST_SERIALIZATION_NVP(*vtx);
-        //ia >> BOOST_SERIALIZATION_NVP(*edg);
-        BGL_FORALL_EDGES_T(e, *g, GraphT) {
-          edg->insert( std::make_pair((*g)[e].edge_index, e) );
-        }       
-        //ia >> BOOST_SERIALIZATION_NVP(*ctr);
-        ifs.close();
-        return true;
-      } else {
-        return false;
-      }
-    } catch (boost::archive::archive_exception& e) {
-      throw data_exception( 
-        std::string("load_road_network(): ") + e.what());
-    }
-  }
-
-  // Puts a serialized object in the cache with key filename
-  template <
-      typename GraphT, 
-      typename VertexMap,
-      typename EdgeMap,
-      typename Constraints>     
-  void save_road_network(
-      const GraphT&         g, 
-      const VertexMap&      vtx,
-      const EdgeMap&        edg,
-      const Constraints&    ctr, 
-      std::string           filename) 
-  {
-    std::ofstream ofs(filename.c_str());
-    assert(ofs.good());
-    boost::archive::binary_oarchive oa(ofs);
-    oa << BOOST_SERIALIZATION_NVP(g);
-    oa << BOOST_SERIALIZATION_NVP(vtx);
-    //oa << BOOST_SERIALIZATION_NVP(edg);
-    //oa << BOOST_SERIALIZATION_NVP(ctr);
-    
-    ofs.close();
-  }
-
-  template <
-      typename GraphT, 
-      typename VertexMap,
-      typename EdgeMap,
-      typename Constraints,        
-      typename BuilderT>
-  void parse_road_network(
-    GraphT*         g, 
-    VertexMap*      vtx,
-    EdgeMap*        edg,
-    Constraints*    ctr, 
-    BuilderT*       builder, 
-    sys_path        filename) 
+  template <typename BuilderT>
+  void parse_road_network(BuilderT* builder, sys_path filename) 
   {
     logger(logINFO) 
         << left("[cache]", 14) 
@@ -161,64 +89,71 @@ namespace gol {
     }    
   }
 
+  // Paths of the graph image of model and of its source data.
+  inline std::pair<sys_path, sys_path> 
+  road_network_paths(std::string filename, std::string model)
+  {
+    sys_path root = 
+      boost::filesystem::current_path() / 
+      sys_path(RELATIVE_DIR);
+    sys_path image = 
+      root / 
+      sys_path("cache") / 
+      sys_path((std::string(filename)
+                    .append(".")
+                    .append(model))
+                  .append(".gimg"))
+            .filename();
+    sys_path data = 
+      root / 
+      sys_path(filename); 
+    return std::make_pair(image, data);
+  }
+
+  // Maps the graph image of model from cache, if missing or stale the 
+  // network is parsed, frozen and imaged again.
   template <
-      typename GraphT, 
-      typename VertexMap,
-      typename EdgeMap,
-      typename Constraints,        
+      typename ModelT,
       typename BuilderT>
   void retrieve_road_network(
-    GraphT*         g, 
-    VertexMap*      vtx,
-    EdgeMap*        edg,
-    Constraints*    ctr,
+    ModelT*         m,
     BuilderT*       builder, 
     std::string     filename, 
     std::string     model) 
   {
     try 
     { 
-      sys_path root = 
-        boost::filesystem::current_path() / 
-        sys_path(RELATIVE_DIR);
-      sys_path serialized = 
-        root / 
-        sys_path("cache") / 
-        sys_path((std::string(filename)
-                      .append(".")
-                      .append(model))
-                    .append(".gsrz"))
-              .filename();
-      sys_path data = 
-        root / 
-        sys_path(filename); 
+      sys_path image, data;
+      std::tie(image, data) = road_network_paths(filename, model);
       
-      if (has(serialized.generic_string())) 
+      if (has(image.generic_string())) 
       {
         logger(logINFO) 
           << left("[cache]", 14) 
           << "Loading Graph >> " 
-          <<  sys_path((std::string(filename)
-                  .append(".")
-                  .append(model))
-                .append(".gsrz"))
-              .filename();          
-        
-        load_road_network(
-          g, vtx, edg, ctr, serialized.generic_string());
+          << image.filename();
+
+        try {
+          if (m->load_image(image.generic_string(), data.generic_string()))
+            return;
+        } catch (data_exception& e) {
+          logger(logWARNING) 
+            << left("[cache]", 14) 
+            << e.what();
+        }
+        logger(logINFO) 
+          << left("[cache]", 14) 
+          << "Rebuilding Graph";
       } 
-      else 
-      {
-        parse_road_network(
-          g, vtx, edg, ctr, builder, data.generic_string());
+
+      parse_road_network(builder, data);
+      m->freeze();
         
-        logger(logINFO) 
-            << left("[cache]", 14) 
-            << "<< Serializing Graph ";            
+      logger(logINFO) 
+          << left("[cache]", 14) 
+          << "<< Serializing Graph ";            
         
-        save_road_network(
-          *g, *vtx, *edg, *ctr, serialized.generic_string());
-      }
+      m->save_image(image.generic_string(), data.generic_string());
 
     } catch (std::exception& e) {
       logger(logERROR) 
@@ -229,6 +164,35 @@ namespace gol {
     }
   } 
 
+  // Maps the graph image of model from cache, never builds it: a 
+  // missing or stale image is an error.
+  template <typename ModelT>
+  void attach_road_network(
+    ModelT*         m,
+    std::string     filename, 
+    std::string     model) 
+  {
+    sys_path image, data;
+    std::tie(image, data) = road_network_paths(filename, model);
+
+    logger(logINFO) 
+      << left("[cache]", 14) 
+      << "Attaching Graph >> " 
+      << image.filename();
+
+    if (!has(image.generic_string()) ||
+        !m->load_image(image.generic_string(), data.generic_string()))
+    {
+      logger(logERROR) 
+        << left("[cache]", 14) 
+        << "Missing or stale Graph image " 
+        << image.filename();
+      throw data_exception( 
+        std::string("attach_road_network(): missing or stale image ") 
+        + image.generic_string()); 
+    }
+  } 
+
   // Gets the serialized entry from cache for that filename.
   bool load_public_transport(timetable_Rt* tt, std::string filename);
 
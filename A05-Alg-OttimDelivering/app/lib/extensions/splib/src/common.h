@@ -54,10 +54,16 @@ struct stats_t {
   stats_t() 
       : run_time(0), 
         expansions(0),
-        visited_nodes(0) {}
+        visited_nodes(0),
+        stalled_nodes(0),
+        pruned_edges(0),
+        pruned_labels(0) {}
   double run_time;
   unsigned int expansions;
   unsigned int visited_nodes;
+  unsigned int stalled_nodes;   // labels left unscanned by stalling
+  unsigned int pruned_edges;    // edges left unrelaxed by pruning
+  unsigned int pruned_labels;   // labels dominated once bounded to t
 };
 
 } // namesocae gol
@@ -47,6 +47,32 @@
 #define MAX_DOWNHILL_SPEED_MULTIPLIER        (1.6)
 #define EUCLIDEAN_DISTANCE_DELTA             (0.15)
 
+// Contraction Hierarchies
+#define CH_WITNESS_SETTLED_LIMIT             (500)
+
+// ALT
+#define ALT_LANDMARKS                        (16)
+#define ALT_ACTIVE_LANDMARKS                 (4)   // used by a query, best for s and t
+
+// Customizable Route Planning
+#define CRP_LEVELS                           (4)
+#define CRP_CELL_SIZE_LOG2                   (7)   // level 1 cells up to 128 vertices
+#define CRP_FANOUT_LOG2                      (3)   // 8 times larger cells each level up
+
+// Graph images
+#define GRAPH_IMAGE_VERIFY_ON_LOAD           (0)    // 1: checksum the whole image on every load
+
+// Tour optimization
+#define TOUR_TIME_BUDGET                     (1.0)  // s, local search
+#define TOUR_RUIN_PERCENT                    (10)   // stops reinserted by a perturbation
+
+// Isochrones
+#define ISOCHRONE_CELL_SIZE                  (100.0) // m, side of a grid cell
+
+// Snapping
+#define SPATIAL_INDEX_CELL_SIZE              (100.0) // m, finest side of a grid cell
+#define SNAP_MAX_DISTANCE                    (1000.0) // m, farthest coordinate snapped onto a model
+
 // RAPTOR
 #define RAPTOR_MAX_ROUNDS                    (5)
 #define MAX_TRANSFER                         (3)
@@ -143,19 +143,17 @@ struct node_as_via_turn_restriction
     return is_only_restriction;     
   }
 
-  bool is_restricted_maneuver(std::string nf, std::string nt)
+  bool is_restricted_maneuver(long long int nf, long long int nt)
   {
     bool nfFound = false; 
     bool ntFound = false;
 
-    for(auto w : from)
-      if ( std::find(w.refs.begin(), w.refs.end(), 
-             std::atoll(nf.c_str())) != w.refs.end() )
+    for(auto& w : from)
+      if ( std::find(w.refs.begin(), w.refs.end(), nf) != w.refs.end() )
         nfFound = true;
 
-    for(auto w : to)
-      if ( std::find(w.refs.begin(), w.refs.end(), 
-             std::atoll(nt.c_str())) != w.refs.end() )
+    for(auto& w : to)
+      if ( std::find(w.refs.begin(), w.refs.end(), nt) != w.refs.end() )
         ntFound = true;     
 
     return ( is_only_restriction() != (nfFound && ntFound) ) && nfFound;
@@ -182,6 +180,93 @@ struct node_as_via_turn_restriction
 
 typedef std::map<feature_Kt, boost::any> features_map;*/
 
+// highway classes the edges are tagged with, stored in one byte per
+// edge in place of the highway value string
+enum highway_Kt : uint8_t
+{
+  highway_nd                 =  0,   // no highway tag
+  highway_motorway           =  1,
+  highway_motorway_link      =  2,
+  highway_trunk              =  3,
+  highway_trunk_link         =  4,
+  highway_primary            =  5,
+  highway_primary_link       =  6,
+  highway_secondary          =  7,
+  highway_secondary_link     =  8,
+  highway_tertiary           =  9,
+  highway_tertiary_link      = 10,
+  highway_unclassified       = 11,
+  highway_residential        = 12,
+  highway_residential_link   = 13,
+  highway_living_street      = 14,
+  highway_service            = 15,
+  highway_road               = 16,
+  highway_pedestrian         = 17,
+  highway_footway            = 18,
+  highway_steps              = 19,
+  highway_track              = 20,
+  highway_bridleway          = 21,
+  highway_corridor           = 22,
+  highway_trail              = 23,
+  highway_gate               = 24,
+  highway_stile              = 25,
+  highway_cattle_grid        = 26,
+  highway_viaduct            = 27,
+  highway_path               = 28,
+  highway_via_ferrata        = 29,
+  highway_cycleway           = 30,
+  highway_private            = 31,
+  highway_construction       = 32,
+  highway_other              = 33    // any other highway value
+};
+
+static const char* const highway_Kv[] = {
+  "nd", "motorway", "motorway_link", "trunk", "trunk_link",
+  "primary", "primary_link", "secondary", "secondary_link",
+  "tertiary", "tertiary_link", "unclassified", "residential",
+  "residential_link", "living_street", "service", "road",
+  "pedestrian", "footway", "steps", "track", "bridleway", "corridor",
+  "trail", "gate", "stile", "cattle_grid", "viaduct", "path",
+  "via_ferrata", "cycleway", "private", "construction", "other"
+};
+
+inline const char* to_highway_value(highway_Kt hk) {
+  return highway_Kv[hk];
+}
+
+inline highway_Kt to_highway_kind(const std::string& v)
+{
+  for (uint8_t hk = highway_nd; hk < highway_other; ++hk)
+    if (v == highway_Kv[hk])
+      return static_cast<highway_Kt>(hk);
+  return highway_other;
+}
+
+// average speed in m/s of a travel mode ("foot", "bike" or "car") on
+// a highway class, estimated times of arrival are computed with it
+inline double average_speed(const std::string& mode, highway_Kt hk)
+{
+  if (mode == "bike")
+    return (AVERAGE_BICYCLE_SPEED/(3.6));
+  if (mode == "car")
+  {
+    switch (hk)
+    {
+      case highway_motorway:
+      case highway_motorway_link:
+        return (MOTORWAY_AVERAGE_CAR_SPEED/(3.6));
+      case highway_trunk:
+      case highway_trunk_link:
+      case highway_primary:
+      case highway_primary_link:
+        return (COUNTRY_AVERAGE_CAR_SPEED/(3.6));
+      default:
+        return (CITY_AVERAGE_CAR_SPEED/(3.6));
+    }
+  }
+  return (AVERAGE_WALKING_SPEED/(3.6));
+}
+
 class features_map 
 {  
  private:  
@@ -520,6 +605,10 @@ class features_map
     return "nd";
   } 
 
+  highway_Kt get_highway_kind() { 
+    return to_highway_kind(get_highway_value());
+  } 
+
   std::string get_highway_name() 
   { 
     std::string k, v;
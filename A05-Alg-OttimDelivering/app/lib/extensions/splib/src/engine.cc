@@ -22,11 +22,104 @@ gol::engine_cache_t* gol::engine_cache_t::_cache_instance_ptr = NULL;
 
 namespace gol {
 
+namespace {
+
+// tours on the model of g, the legs of every tour are searched with
+// algorithm and stitched into one route. A tour with a leg algorithm 
+// finds no route for is dropped, its stops are unassigned
+template <typename GraphT>
+void optimize_tour(
+    GraphT&                       g,
+    std::string                   algorithm,
+    osm_id_t                      depot,
+    const std::vector<tour_stop>& stops,
+    unsigned                      vehicles,
+    double                        capacity,
+    double                        time_budget,
+    std::string                   strategy,
+    tour_solution*                tour,
+    optimized_routes_solution*    sol)
+{
+  std::vector<osm_id_t> ids(1, depot);
+  for (const tour_stop& s : stops)
+    ids.push_back(s.node);
+  distance_matrix dm = g.many_to_many(ids, ids, strategy);
+
+  stopwatch chrono;
+  tour_optimizer_t optimizer(
+    stops, dm.weights, dm.durations, vehicles, capacity);
+  *tour = optimizer.solve(time_budget);
+  chrono.lap();
+
+  logger(logINFO)
+    << left("[tour]", 14)
+    << stops.size() << " stops, "
+    << tour->tours.size() << " tours, "
+    << tour->unassigned.size() << " unassigned, "
+    << "cost " << prd(tour->cost, 1) << ", "
+    << prd(chrono.partial_wall_time(), 3) << "s";
+
+  std::vector<std::vector<uint32_t> > tours;
+  for (const std::vector<uint32_t>& t : tour->tours)
+  {
+    Route    r;
+    bool     complete = true;
+    double   cost     = 0;
+    osm_id_t from     = depot;
+    uint32_t prev     = 0;    // location of from, the depot is 0
+    for (size_t i = 0; i <= t.size(); ++i)
+    {
+      osm_id_t to   = i < t.size() ? stops[t[i]].node : depot;
+      uint32_t next = i < t.size() ? t[i] + 1 : 0;
+      cost += dm.weights[dm.at(prev, next)];
+      if (to != from && complete) 
+      {
+        optimized_routes leg = 
+          g.route_optimize(algorithm, from, to, strategy);
+        if (leg.empty()) 
+        {
+          logger(logWARNING)
+            << left("[tour]", 14)
+            << "no route from " << from << " to " << to << ", "
+            << t.size() << " stops unassigned";
+          complete = false;
+        }
+        else
+          r.append(leg.front());
+      }
+      from = to;
+      prev = next;
+    }
+    if (!complete) 
+    {
+      tour->unassigned.insert(tour->unassigned.end(), t.begin(), t.end());
+      tour->cost -= cost;
+      continue;
+    }
+    tours.push_back(t);
+    sol->insert_route(r);
+  }
+  tour->tours.swap(tours);
+}
+
+template <typename GraphT>
+void route_job_on(GraphT& g, const route_job& job, route_result& result)
+{
+  optimized_routes opt = 
+    g.route_optimize(job.algorithm, job.source, job.target, job.strategy);
+  for (auto route : opt)
+    result.sol.insert_route(route);
+  result.status = opt.empty() ? 
+    route_result::not_found : route_result::found;
+}
+
+} // namespace
+
 void
 engine_t::dijkstra_based(
     std::string algorithm,
-    std::string source,
-    std::string target,
+    osm_id_t    source,
+    osm_id_t    target,
     std::string request_time,
     std::string model,
     std::string strategy,
@@ -40,11 +133,11 @@ engine_t::dijkstra_based(
     // retrieve models else parse and build structures from data
     if (model.find("pedestrian_") != std::string::npos)
     {
-      pedestrian_graphT& g = 
+      std::shared_ptr<pedestrian_graphT> g = 
         _cache->get_cached_pedestrian_network_for(model);
 
       optimized_routes opt;
-      opt = g.route_optimize(algorithm, source, target, strategy);
+      opt = g->route_optimize(algorithm, source, target, strategy);
 
       for (auto route : opt)
         sol->insert_route(route);        
@@ -52,23 +145,17 @@ engine_t::dijkstra_based(
 
     if (model.find("road_") != std::string::npos)
     {
-      road_graphT& g = 
+      std::shared_ptr<road_graphT> g = 
         _cache->get_cached_road_network_for(model);
 
       optimized_routes opt;
-      opt = g.route_optimize(algorithm, source, target, strategy);
+      opt = g->route_optimize(algorithm, source, target, strategy);
 
       for (auto route : opt)
         sol->insert_route(route);      
     }      
 
   }
-  catch (target_not_found& t) {
-    logger(logINFO)
-      << left("[-]", 14)
-      << "Target not found ";
-    return;
-  }
   catch (std::exception& e) {
     throw solver_exception( 
       std::string("dijkstra_based(): ") + e.what() );
@@ -77,9 +164,228 @@ engine_t::dijkstra_based(
 }
 
 void
-engine_t::bicriterion_epsMOA_star(
-    std::string source,
-    std::string target,
+engine_t::dijkstra_based(
+    std::string algorithm,
+    double      source_lon,
+    double      source_lat,
+    double      target_lon,
+    double      target_lat,
+    std::string model,
+    std::string strategy,
+    optimized_routes_solution* sol)
+{
+  try
+  {
+    optimized_routes opt;
+    if (model.find("pedestrian_") != std::string::npos)
+      opt = _cache->get_cached_pedestrian_network_for(model)->route_optimize(
+        algorithm, source_lon, source_lat, target_lon, target_lat, strategy);
+
+    if (model.find("road_") != std::string::npos)
+      opt = _cache->get_cached_road_network_for(model)->route_optimize(
+        algorithm, source_lon, source_lat, target_lon, target_lat, strategy);
+
+    if (model.find("bicycle_") != std::string::npos)
+      opt = _cache->get_cached_bicycle_network_for(model)->route_optimize(
+        algorithm, source_lon, source_lat, target_lon, target_lat, strategy);
+
+    for (auto route : opt)
+      sol->insert_route(route);
+  }
+  catch (std::exception& e) {
+    throw solver_exception(
+      std::string("dijkstra_based(): ") + e.what() );
+  }
+
+}
+
+bool
+engine_t::nearest(
+    double         lon,
+    double         lat,
+    std::string    model,
+    snapped_point* p)
+{
+  if (model.find("pedestrian_") != std::string::npos)
+    return _cache->get_cached_pedestrian_network_for(model)->snap(lon, lat, *p);
+  if (model.find("road_") != std::string::npos)
+    return _cache->get_cached_road_network_for(model)->snap(lon, lat, *p);
+  if (model.find("bicycle_") != std::string::npos)
+    return _cache->get_cached_bicycle_network_for(model)->snap(lon, lat, *p);
+  throw solver_exception("nearest(): model unknown " + model);
+}
+
+void
+engine_t::many_to_many(
+    std::vector<osm_id_t> sources,
+    std::vector<osm_id_t> targets,
+    std::string           model,
+    std::string           strategy,
+    distance_matrix*      dm)
+{
+  try
+  {
+    // weights of a bicriterion model have no total order
+    if (model.find("bicycle_") != std::string::npos)
+      throw solver_exception("single criterion only, " + model);
+
+    if (model.find("pedestrian_") != std::string::npos)
+    {
+      std::shared_ptr<pedestrian_graphT> g = 
+        _cache->get_cached_pedestrian_network_for(model);
+      *dm = g->many_to_many(sources, targets, strategy);
+    }
+
+    if (model.find("road_") != std::string::npos)
+    {
+      std::shared_ptr<road_graphT> g = 
+        _cache->get_cached_road_network_for(model);
+      *dm = g->many_to_many(sources, targets, strategy);
+    }      
+
+  }
+  catch (std::exception& e) {
+    throw solver_exception( 
+      std::string("many_to_many(): ") + e.what() );
+  }
+
+}
+
+void
+engine_t::route_batch(
+    const std::vector<route_job>& jobs,
+    std::vector<route_result>*    results,
+    std::function<
+      void(size_t, const route_result&)> on_result)
+{
+  results->assign(jobs.size(), route_result());
+  std::vector<char> done(jobs.size(), 0);
+  size_t            next = 0;
+  std::mutex        order;
+
+  stopwatch chrono;
+  work_stealing_pool::instance().parallel_for(jobs.size(), 
+    [&](unsigned /*w*/, size_t i) {
+      const route_job& job    = jobs[i];
+      route_result&    result = (*results)[i];
+      result.status = route_result::failed;
+      try 
+      {
+        if (!job.error.empty())
+          result.error = job.error;
+        else if (job.model.find("pedestrian_") != std::string::npos)
+          route_job_on(
+            *_cache->get_cached_pedestrian_network_for(job.model), 
+            job, result);
+        else if (job.model.find("road_") != std::string::npos)
+          route_job_on(
+            *_cache->get_cached_road_network_for(job.model), 
+            job, result);
+        else if (job.model.find("bicycle_") != std::string::npos)
+          route_job_on(
+            *_cache->get_cached_bicycle_network_for(job.model), 
+            job, result);
+        else
+          result.error = "route_batch(): model unknown " + job.model;
+      }
+      catch (std::exception& e) {
+        result.status = route_result::failed;
+        result.error  = e.what();
+      }
+
+      std::lock_guard<std::mutex> l(order);
+      done[i] = 1;
+      for (; next < jobs.size() && done[next]; ++next)
+        if (on_result)
+          on_result(next, (*results)[next]);
+    });
+  chrono.lap();
+
+  logger(logINFO)
+    << left("[batch]", 14)
+    << jobs.size() << " routes, "
+    << prd(chrono.partial_wall_time(), 3) << "s";
+}
+
+void
+engine_t::isochrones(
+    std::vector<osm_id_t>   sources,
+    double                  limit,
+    std::string             model,
+    std::string             strategy,
+    double                  cell_size,
+    std::vector<isochrone>* isos)
+{
+  try
+  {
+    // weights of a bicriterion model have no total order
+    if (model.find("bicycle_") != std::string::npos)
+      throw solver_exception("single criterion only, " + model);
+
+    if (model.find("pedestrian_") != std::string::npos)
+    {
+      std::shared_ptr<pedestrian_graphT> g = 
+        _cache->get_cached_pedestrian_network_for(model);
+      *isos = g->isochrones(sources, limit, strategy, cell_size);
+    }
+
+    if (model.find("road_") != std::string::npos)
+    {
+      std::shared_ptr<road_graphT> g = 
+        _cache->get_cached_road_network_for(model);
+      *isos = g->isochrones(sources, limit, strategy, cell_size);
+    }      
+
+  }
+  catch (std::exception& e) {
+    throw solver_exception( 
+      std::string("isochrones(): ") + e.what() );
+  }
+
+}
+
+void
+engine_t::tour_optimization(
+    osm_id_t               depot,
+    std::vector<tour_stop> stops,
+    unsigned               vehicles,
+    double                 capacity,
+    double                 time_budget,
+    std::string            model,
+    std::string            strategy,
+    tour_solution*         tour,
+    optimized_routes_solution* sol)
+{
+  try
+  {
+    // weights of a bicriterion model have no total order
+    if (model.find("bicycle_") != std::string::npos)
+      throw solver_exception("single criterion only, " + model);
+
+    if (model.find("pedestrian_") != std::string::npos)
+      optimize_tour(
+        *_cache->get_cached_pedestrian_network_for(model), "ch",
+        depot, stops, vehicles, capacity, time_budget, strategy, 
+        tour, sol);
+
+    if (model.find("road_") != std::string::npos)
+      optimize_tour(
+        *_cache->get_cached_road_network_for(model), "compact_ch",
+        depot, stops, vehicles, capacity, time_budget, strategy, 
+        tour, sol);
+  }
+  catch (std::exception& e) {
+    throw solver_exception( 
+      std::string("tour_optimization(): ") + e.what() );
+  }
+
+}
+
+void
+engine_t::multicriteria_based(
+    std::string algorithm,
+    osm_id_t    source,
+    osm_id_t    target,
     std::string request_time,
     std::string model,
     std::string strategy,
@@ -87,26 +393,24 @@ engine_t::bicriterion_epsMOA_star(
     std::string data_timetable_path,
     optimized_routes_solution* sol)
 {
-  auto g = generic_edge_weighted_graph_t <  // road network
-               extra_vertex_properties,
-               extra_edge_properties,
-               int, int >();                // buckets pruning
   try
   {
-    // if cache contains serialized files than
-    // retrieve else parse and build structures from data
-    g.create_model(model, data_graph_path);
+    if (model.find("bicycle_") == std::string::npos)
+      throw solver_exception("model unknown " + model);
+
+    std::shared_ptr<bicycle_graphT> g = 
+      _cache->get_cached_bicycle_network_for(model);
 
     optimized_routes opt;
-    opt = g.route_optimize(
-      "bicriterion_epsMOA_star", source, target, strategy);
+    opt = g->route_optimize(algorithm, source, target, strategy);
 
     for (auto route : opt)
       sol->insert_route(route);
 
-  } catch (std::exception& e) {
+  }
+  catch (std::exception& e) {
     throw solver_exception(
-      std::string("bicriterion_epsMOA_star(): ") + e.what() );
+      std::string("multicriteria_based(): ") + e.what() );
   }
 
 }
@@ -18,6 +18,9 @@
 #ifndef GOL_ENGINE_H_
 #define GOL_ENGINE_H_
 
+// std
+#include <functional>
+#include <mutex>
 // boost
 #include <boost/graph/graph_traits.hpp>
 #include <boost/graph/dijkstra_shortest_paths.hpp>
@@ -34,6 +37,8 @@
 
 #include "cache.h"
 #include "route.h"
+#include "tour/tour_optimizer.h"
+#include "utils/work_stealing_pool.h"
 
 #include "graphs.h"
 
@@ -47,8 +52,10 @@ class engine_cache_t
 
   engine_cache_t(std::string data_graph_path): 
     _data_graph_path(data_graph_path),
-    _road_compact_graph_ptr(nullptr),
-    _pedestrian_graph_ptr(nullptr)    {}
+    _road_compact_graph_ptr(),
+    _pedestrian_graph_ptr(),
+    _bicycle_graph_ptr(),
+    _models_mtx()                     {}
 
   // don't implement
   engine_cache_t(engine_cache_t const &);
@@ -56,14 +63,37 @@ class engine_cache_t
 
   ~engine_cache_t();   
 
-  std::string         _data_graph_path;
-  road_graphT*        _road_compact_graph_ptr;
-  pedestrian_graphT*  _pedestrian_graph_ptr;     
+  // models are snapshots: a query holds the one it started on, a 
+  // refresh or an attach publishes new ones and the old are freed 
+  // with the last query using them
+  std::string                        _data_graph_path;
+  std::shared_ptr<road_graphT>       _road_compact_graph_ptr;
+  std::shared_ptr<pedestrian_graphT> _pedestrian_graph_ptr;     
+  std::shared_ptr<bicycle_graphT>    _bicycle_graph_ptr;
+  std::mutex                         _models_mtx;  // guards the swaps
+
+  template <typename GraphT>
+  void publish(
+      std::shared_ptr<GraphT>&       slot, 
+      const std::shared_ptr<GraphT>& model) 
+  {
+    std::lock_guard<std::mutex> lock(_models_mtx);
+    slot = model;
+  }
+
+  template <typename GraphT>
+  std::shared_ptr<GraphT> snapshot(const std::shared_ptr<GraphT>& slot) 
+  {
+    std::lock_guard<std::mutex> lock(_models_mtx);
+    return slot;
+  }
 
  public:
       
   static engine_cache_t*
   get_instance(std::string data_graph_path) {
+    static std::mutex instance_mtx;
+    std::lock_guard<std::mutex> lock(instance_mtx);
     if ( _cache_instance_ptr == NULL ) 
       _cache_instance_ptr =  new engine_cache_t(data_graph_path);
     return _cache_instance_ptr;
@@ -117,17 +147,14 @@ class engine_cache_t
     logger(logINFO)
       << left("[cache]", 14)
       << "Refresh Cached Route Planning Models";    
+    std::shared_ptr<road_graphT> road_ptr(new road_graphT());
     try 
     {
       logger(logINFO)
         << left("[cache]", 14)
         << "> Road Compact Representation Model";
 
-      if (!(_road_compact_graph_ptr == nullptr))
-        delete _road_compact_graph_ptr;
-    
-      _road_compact_graph_ptr = new road_graphT();       
-      _road_compact_graph_ptr->create_model(
+      road_ptr->create_model(
           "road_compact_representation_model", 
           _data_graph_path);
 
@@ -137,17 +164,15 @@ class engine_cache_t
         << "refresh road_compact_representation_model error: "
         << e.what();
     }
+    publish(_road_compact_graph_ptr, road_ptr);
+    std::shared_ptr<pedestrian_graphT> pedestrian_ptr(new pedestrian_graphT());
     try 
     {
       logger(logINFO)
         << left("[cache]", 14)
         << "> Pedestrian Simplified Model";
 
-      if (!(_pedestrian_graph_ptr == nullptr))
-        delete _pedestrian_graph_ptr;
-    
-      _pedestrian_graph_ptr = new pedestrian_graphT();      
-      _pedestrian_graph_ptr->create_model(
+      pedestrian_ptr->create_model(
           "pedestrian_simplified_model", 
           _data_graph_path);
 
@@ -156,32 +181,91 @@ class engine_cache_t
         << left("[DB]", 14)
         << "refresh pedestrian_simplified_model error: "
         << e.what();
-    }    
+    }
+    publish(_pedestrian_graph_ptr, pedestrian_ptr);
+    std::shared_ptr<bicycle_graphT> bicycle_ptr(new bicycle_graphT());
+    try 
+    {
+      logger(logINFO)
+        << left("[cache]", 14)
+        << "> Bicriterion Bicycle Model";
+
+      bicycle_ptr->create_model(
+          "bicriterion_bicycle_model", 
+          _data_graph_path);
+
+    } catch (std::exception& e) {
+      logger(logERROR)
+        << left("[DB]", 14)
+        << "refresh bicriterion_bicycle_model error: "
+        << e.what();
+    }
+    publish(_bicycle_graph_ptr, bicycle_ptr);
             
   }
 
-  road_graphT& get_cached_road_network_for(std::string model) {
+  // maps the graph images built by another process, models are shared
+  // read-only through the page cache and never rebuilt here
+  void attach()
+  {
+    logger(logINFO)
+      << left("[cache]", 14)
+      << "Attach Shared Route Planning Models";
+
+    std::shared_ptr<road_graphT>       road_ptr(new road_graphT());
+    std::shared_ptr<pedestrian_graphT> pedestrian_ptr(new pedestrian_graphT());
+    std::shared_ptr<bicycle_graphT>    bicycle_ptr(new bicycle_graphT());
+    road_ptr->attach_model(
+        "road_compact_representation_model", 
+        _data_graph_path);
+    pedestrian_ptr->attach_model(
+        "pedestrian_simplified_model", 
+        _data_graph_path);
+    bicycle_ptr->attach_model(
+        "bicriterion_bicycle_model", 
+        _data_graph_path);
+
+    publish(_road_compact_graph_ptr, road_ptr);
+    publish(_pedestrian_graph_ptr,   pedestrian_ptr);
+    publish(_bicycle_graph_ptr,      bicycle_ptr);
+  }
+
+  // the current snapshot of a model, hold it for the whole query
+  std::shared_ptr<road_graphT> 
+  get_cached_road_network_for(std::string /*model*/) {
     //if ( model == "road_compact_representation_model" )
-      return (*_road_compact_graph_ptr);
+      return snapshot(_road_compact_graph_ptr);
     //if ( model == "road_simplified_model" )
     //  return (*_road_graph_ptr);
   }
 
-  pedestrian_graphT& get_cached_pedestrian_network_for(std::string model) {
+  std::shared_ptr<pedestrian_graphT> 
+  get_cached_pedestrian_network_for(std::string /*model*/) {
     //if ( model == "pedestrian_simplified_model" )
-      return (*_pedestrian_graph_ptr);
+      return snapshot(_pedestrian_graph_ptr);
+  }  
+
+  std::shared_ptr<bicycle_graphT> 
+  get_cached_bicycle_network_for(std::string /*model*/) {
+    //if ( model == "bicriterion_bicycle_model" )
+      return snapshot(_bicycle_graph_ptr);
   }  
         
 }; 
 
 class engine_t {
  public:
-  engine_t(std::string data_graph_path, bool updateDB) { 
+  // a shared engine maps models built by another process and refuses
+  // stale ones instead of rebuilding them
+  engine_t(std::string data_graph_path, bool updateDB, bool shared = false) { 
 #ifndef NLOG
     log_policy::get_instance().umtx();
 #endif      
     _cache = engine_cache_t::get_instance(data_graph_path);
-    _cache->refresh(updateDB); 
+    if (shared)
+      _cache->attach();
+    else
+      _cache->refresh(updateDB); 
   }
   
   ~engine_t() { 
@@ -195,8 +279,8 @@ class engine_t {
   void
   dijkstra_based(
     std::string algorithm,
-    std::string source, 
-    std::string target, 
+    osm_id_t    source, 
+    osm_id_t    target, 
     std::string request_time,
     std::string model,
     std::string strategy, 
@@ -204,10 +288,80 @@ class engine_t {
     std::string data_timetable_path,
     optimized_routes_solution* sol); 
 
-  static void
-  bicriterion_epsMOA_star(
-    std::string source, 
-    std::string target, 
+  // route between two points on the edges of model nearest to the
+  // coordinates, see generic_edge_weighted_graph_t::phantom
+  void
+  dijkstra_based(
+    std::string algorithm,
+    double      source_lon, 
+    double      source_lat, 
+    double      target_lon, 
+    double      target_lat, 
+    std::string model,
+    std::string strategy, 
+    optimized_routes_solution* sol); 
+
+  // (lon, lat) snapped onto model, false when no edge of it is near
+  bool
+  nearest(
+    double         lon, 
+    double         lat, 
+    std::string    model,
+    snapped_point* p); 
+
+  // travel cost tables between sources and targets, see
+  // generic_edge_weighted_graph_t::many_to_many
+  void
+  many_to_many(
+    std::vector<osm_id_t> sources, 
+    std::vector<osm_id_t> targets, 
+    std::string           model,
+    std::string           strategy, 
+    distance_matrix*      dm); 
+
+  // the routes of jobs on the work stealing pool, a job per core at a 
+  // time; results are in job order. on_result, when given, is called 
+  // in job order as soon as a result and all those before it are in
+  void
+  route_batch(
+    const std::vector<route_job>& jobs,
+    std::vector<route_result>*    results,
+    std::function<
+      void(size_t, const route_result&)> on_result = nullptr);
+
+  // areas reachable from sources within limit, in weights of 
+  // strategy, see generic_edge_weighted_graph_t::isochrones
+  void
+  isochrones(
+    std::vector<osm_id_t>   sources, 
+    double                  limit,
+    std::string             model,
+    std::string             strategy, 
+    double                  cell_size,
+    std::vector<isochrone>* isos); 
+
+  // delivery tours from depot over stops, see tour_optimizer_t; the
+  // route of every tour, legs stitched, goes to sol in tour order. The
+  // stops of a tour with a leg no route is found for are unassigned
+  void
+  tour_optimization(
+    osm_id_t               depot,
+    std::vector<tour_stop> stops,
+    unsigned               vehicles,
+    double                 capacity,
+    double                 time_budget,
+    std::string            model,
+    std::string            strategy,
+    tour_solution*         tour,
+    optimized_routes_solution* sol); 
+
+  // Pareto optimal routes on a model with several criteria by edge,
+  // e.g. algorithm bicriterion_epsMOA_star on bicriterion_bicycle_model
+  void
+  multicriteria_based(
+    std::string algorithm,
+    osm_id_t    source, 
+    osm_id_t    target, 
     std::string request_time,
     std::string model,
     std::string strategy,     
@@ -56,13 +56,27 @@
 #include "../utils/stopwatch.h"
 #include "../utils/logger.h"
 #include "../utils/bitset.h"
+#include "../utils/work_stealing_pool.h"
 
 #include "graph_serialization_multi_array.h"
 #include "graph_constraints.h"
+#include "graph_compressed_sparse_row.h"
+#include "graph_contraction_hierarchy.h"
+#include "graph_node_contraction.h"
+#include "graph_multilevel_partition.h"
+#include "graph_overlay.h"
+#include "graph_landmarks.h"
+#include "graph_vertex_map.h"
+#include "graph_string_table.h"
+#include "graph_image.h"
+#include "graph_isochrone.h"
+#include "graph_spatial_index.h"
+#include "graph_phantom_node.h"
 #include "../cache.h"
 
 #include "graph_builder_factory.h"
 #include "graph_solver_factory.h"
+#include "graph_weight_profile.h"
 
 #include "../round_based/raptor_timetable.h"
 
@@ -114,7 +128,8 @@ class generic_edge_weighted_graph_t
 private:
   struct graph_properties_t 
   {
-    std::string graph_id;
+    std::string  graph_id;
+    string_table names;    // street names of the edges
 
     friend class boost::serialization::access;
     template<class Archive>
@@ -146,7 +161,7 @@ private:
 
   struct vertex_properties_t 
   {
-    std::string id;  // move to vertex_map
+    osm_id_t    id;
     point_t     geo;
 
     turn_table_t* turn_table = 0;  
@@ -191,18 +206,21 @@ private:
     }
   };  
 
-  struct mapped_vertex_ord 
+  // vertex bundle of the frozen graph, turn tables are flattened into
+  // the compressed sparse row layout
+  struct frozen_vertex_properties_t 
   {
-    bool operator()(const std::string& v, const std::string& u) const {
-      return v.compare(u) < 0;
-    }
+    osm_id_t    id;
+    point_t     geo;
+
+    ExtraVertexProperties properties;
+
+    frozen_vertex_properties_t() = default;
+    explicit frozen_vertex_properties_t(const vertex_properties_t& vp):
+        id(vp.id), geo(vp.geo), properties(vp.properties) {}
   };
 
-  typedef std::map<
-      std::string, 
-      vertex_descriptor, 
-      mapped_vertex_ord
-  > vertex_map;
+  typedef vertex_id_map<vertex_descriptor> vertex_map;
 
   // typedef uint32_t edge_index_t; //see utility.cc
   typedef std::map<
@@ -215,25 +233,102 @@ private:
   typedef std::list<edge_descriptor>              path_t;
   typedef std::list<std::pair<weight_t, path_t> > gRoute;
 
+  // immutable layout used by solvers once the model is built
+  typedef csr_graph_t<
+      frozen_vertex_properties_t,
+      ExtraEdgeProperties,
+      weight_t
+  > frozen_graph_t;
+
+  typedef typename boost::property_map<
+      frozen_graph_t, boost::edge_index_t>::const_type IndexMap;
+
+  typedef weight_profiles<
+      frozen_graph_t, 
+      vertex_map, 
+      weight_t, 
+      IndexMap>                                        profiles_t;
+  typedef typename profiles_t::weight_map              weight_map_t;
+  typedef contraction_hierarchy_t<
+      frozen_graph_t, weight_t>                        hierarchy_t;
+  typedef contraction_hierarchy_t<
+      frozen_graph_t, 
+      weight_t, 
+      edge_based_hierarchy_tag>                        turn_hierarchy_t;
+  typedef overlay_metric_t<weight_t>                   metric_t;
+  typedef overlay_graph_t<
+      frozen_graph_t, weight_t>                        overlay_t;
+  typedef landmarks_t<weight_t>                        landmarks_type;
+  typedef landmark_graph_t<
+      frozen_graph_t, weight_t>                        landmark_graph_type;
+  // hierarchies are contracted and overlays customized for scalar 
+  // weights only
+  typedef std::integral_constant<bool, 
+      !is_pair_edge_weight<weight_t>::value && 
+      !is_tuple_edge_weight<weight_t>::value>          is_contractible;
+
   graph_t                _g;
+  frozen_graph_t         _fg;
+  profiles_t             _profiles;
+  std::map<
+    std::string, 
+    hierarchy_t>         _hierarchies;       // by strategy, bound to _fg
+  std::map<
+    std::string, 
+    turn_hierarchy_t>    _turn_hierarchies;  // by strategy, bound to _fg
+  multilevel_partition_t _partition;
+  std::map<
+    std::string, 
+    metric_t>            _metrics;           // by strategy
+  std::map<
+    std::string, 
+    landmarks_type>      _landmarks;         // by strategy
+  spatial_index_t        _spatial;
+  string_table           _names;
   vertex_map             _vtxmap;
   edge_map               _edgmap;
   graph_constraints_t<
     graph_t, weight_t >  _constraints;
   size_t                 _n_weights;
   std::string            _model;
+  std::shared_ptr<
+    graph_image>         _image;  // backs _fg when the model is mapped
+
+  // model name, layout of the frozen types and source data fingerprint
+  graph_image_header image_header(std::string source) const
+  {
+    graph_image_header h;
+    std::memset(&h, 0, sizeof(h));
+    std::strncpy(h.model, _model.c_str(), sizeof(h.model) - 1);
+    h.weight_size = sizeof(weight_t);
+    h.vertex_size = sizeof(frozen_vertex_properties_t);
+    h.edge_size   = sizeof(ExtraEdgeProperties);
+    fingerprint_source(source, h);
+    return h;
+  }
 
 public:
   generic_edge_weighted_graph_t(): 
       _g(), 
+      _fg(),
+      _profiles(),
+      _hierarchies(),
+      _turn_hierarchies(),
+      _partition(),
+      _metrics(),
+      _landmarks(),
+      _spatial(),
+      _names(),
       _vtxmap(),
       _edgmap(),
       _constraints(_g),
       _n_weights(sizeof...(WeightsT)),
-      _model() {};
+      _model(),
+      _image() {};
 
   ~generic_edge_weighted_graph_t() {} 
 
+  // builds the model, or maps its graph image when up to date
   void create_model(std::string model, std::string filename) 
   {
     graph_builder<
@@ -251,146 +346,471 @@ public:
           model, _g, _vtxmap, _edgmap, _constraints);
     
     _model = model;
-    cache::retrieve_road_network(
-      &_g, &_vtxmap, &_edgmap, &_constraints, gbuilder, filename, model);  
+    cache::retrieve_road_network(this, gbuilder, filename, model);  
   } 
-  
-  template <typename WeightFunctionT, 
-            typename StoppingCriteriaT = null_stopping_criteria<graph_t> >
-  optimized_routes apply_solver(
-      std::string       algorithm, 
-      std::string       source, 
-      std::string       target,
-      WeightFunctionT   weight_function,
-      StoppingCriteriaT stopping_criteria = null_stopping_criteria<graph_t>()) 
-  {          
-    // edge index map
-    typedef typename boost::property_map<
-      graph_t, edge_index_t edge_properties_t::*>::type IndexMap; 
 
-    IndexMap edge_index_map = boost::get(&edge_properties_t::edge_index, _g);  
+  // maps the graph image of the model only, the image must be up to 
+  // date with filename: used by processes sharing a model read-only
+  void attach_model(std::string model, std::string filename) 
+  {
+    _model = model;
+    cache::attach_road_network(this, filename, model);  
+  }
 
-    if( (_vtxmap).find(source) == _vtxmap.end() || 
-        (_vtxmap).find(target) == _vtxmap.end() ) {
-      logger(logINFO) 
-          << left("[*]", 14) 
-          << ">> no route found, invalid points";
-      return optimized_routes();
+  // the frozen graph and the weights of strategy, for the programs
+  // under src/test that run the solvers on the model directly
+  const frozen_graph_t& frozen_graph() const { return _fg; }
+  weight_map_t weight_map(std::string strategy) const { 
+    return _profiles.get(strategy, _fg); }
+
+  // moves the built adjacency_list into the compressed sparse row 
+  // layout, the adjacency_list and the edge map are released: edge
+  // indexes of the frozen graph are its edge slots
+  void freeze()
+  {
+    _fg.assign(_g);
+    _names = std::move(_g[boost::graph_bundle].names);
+    _names.seal();
+    BGL_FORALL_VERTICES_T(v, _g, graph_t) {
+      delete _g[v].turn_table;
+      _g[v].turn_table = 0;
     }
-    
-    graph_solver<
-        graph_t, 
-        weight_t,
-        IndexMap, 
-        WeightFunctionT, 
-        StoppingCriteriaT >* gsolver =  
-      gsolver_factory<
-        graph_t, 
-        weight_t,
-        IndexMap, 
-        WeightFunctionT, 
-        StoppingCriteriaT >::instance()
-         .get_solver_for( _g, algorithm, (_vtxmap)[source], (_vtxmap)[target]);         
-    
-    try 
+    _g.clear();
+    _edgmap.clear();
+    _image.reset();
+
+    _profiles.clear();
+    _profiles.alias("shortest_weight_function", _fg.weights());
+    for (std::string strategy : 
+           weight_function_factory<
+             frozen_graph_t, vertex_map, weight_t>::get_strategies_for(_model))
+      _profiles.materialize(strategy, _fg, _vtxmap);
+
+    _hierarchies.clear();
+    for (std::string strategy : 
+           weight_function_factory<
+             frozen_graph_t, vertex_map, weight_t>::get_contracted_strategies_for(_model))
+      contract(strategy, is_contractible());
+    _turn_hierarchies.clear();
+    for (std::string strategy : 
+           weight_function_factory<
+             frozen_graph_t, vertex_map, weight_t>::get_turn_contracted_strategies_for(_model))
+      contract_turns(strategy, is_contractible());
+    _metrics.clear();
+    std::vector<std::string> customized = overlay_strategies(is_contractible());
+    if (!customized.empty())
+      build_partition();
+    for (std::string strategy : customized)
+      customize(strategy);
+    _landmarks.clear();
+    for (std::string strategy : 
+           weight_function_factory<
+             frozen_graph_t, vertex_map, weight_t>::get_landmark_strategies_for(_model))
+      select_landmarks(strategy, is_contractible());
+    build_spatial_index();
+
+    logger(logINFO)
+      << left("[cache]", 14)
+      << "Frozen Graph > "
+      << "|V| = "
+      << boost::num_vertices(_fg)
+      << ", "
+      << "|E| = "
+      << boost::num_edges(_fg)
+      << ", "
+      << ((_fg.memory_usage() + _profiles.memory_usage()) >> 20) << " MB";
+  }
+
+  // contracts the frozen graph with the weight profile of strategy
+  void contract(std::string /*strategy*/, std::false_type) {}
+  void contract(std::string strategy, std::true_type)
+  {
+    stopwatch chrono;
+    weight_map_t weight_map = _profiles.get(strategy, _fg);
+    node_contraction<weight_t> nc(boost::num_vertices(_fg));
+    for (edge_index_t idx = 0; idx < boost::num_edges(_fg); ++idx)
     {
-      gsolver->solve(weight_function, edge_index_map, stopping_criteria);
-      return gsolver->get_optimized_routes();        
-    } catch (std::exception) 
+      auto e = edge_at(idx, _fg);
+      nc.add_arc(
+        boost::source(e, _fg), boost::target(e, _fg), get(weight_map, e), idx);
+    }
+    nc.run();
+
+    hierarchy_t& h = _hierarchies[strategy];
+    nc.assign_to(h);
+    h.bind(_fg);
+    chrono.lap();
+
+    logger(logINFO)
+      << left("[cache]", 14)
+      << "Contraction Hierarchy > "
+      << strategy << ", "
+      << nc.num_shortcuts() << " shortcuts, "
+      << (h.memory_usage() >> 20) << " MB, "
+      << prd(chrono.partial_wall_time(), 2) << "s";
+  }
+
+  // contracts the turns of the frozen graph with the weight profile of
+  // strategy: nodes are edge slots, turns forbidden by the turn tables
+  // are no arcs
+  void contract_turns(std::string /*strategy*/, std::false_type) {}
+  void contract_turns(std::string strategy, std::true_type)
+  {
+    stopwatch chrono;
+    weight_map_t weight_map = _profiles.get(strategy, _fg);
+    node_contraction<weight_t> nc(boost::num_edges(_fg));
+    for (edge_index_t idx = 0; idx < boost::num_edges(_fg); ++idx)
     {
-      logger(logINFO) 
-          << left("[*]", 14) 
-          << ">> no route found!";        
-      return optimized_routes();
+      auto in = edge_at(idx, _fg);
+      auto u  = boost::target(in, _fg);
+      auto oer = boost::out_edges(u, _fg);
+      for (auto oei = oer.first; oei != oer.second; ++oei)
+      {
+        weight_t turn = _fg.has_turn_table(u) ?
+          _fg.turn_cost(u, _fg[in].entry_point, _fg[*oei].exit_point) : weight_t();
+        if (turn == std::numeric_limits<weight_t>::max())
+          continue; // restricted manoeuvre
+        edge_index_t out = _fg[*oei].edge_index;
+        nc.add_arc(idx, out, get(weight_map, *oei) + turn, out);
+      }
     }
+    nc.run();
+
+    turn_hierarchy_t& h = _turn_hierarchies[strategy];
+    nc.assign_to(h);
+    h.bind(_fg);
+    chrono.lap();
+
+    logger(logINFO)
+      << left("[cache]", 14)
+      << "Turn Contraction Hierarchy > "
+      << strategy << ", "
+      << nc.num_shortcuts() << " shortcuts, "
+      << (h.memory_usage() >> 20) << " MB, "
+      << prd(chrono.partial_wall_time(), 2) << "s";
+  }
+
+  // (re)computes the overlay metric of strategy from its weight profile
+  void customize(std::string strategy) {
+    customize_metric(strategy, is_contractible());
+  }
+
+  // replaces the weight profile of strategy with weights, by edge slot,
+  // and customizes its overlay again; hierarchies and landmarks computed
+  // with the old profile are dropped. Not to be called while routes are
+  // searched
+  void customize(std::string strategy, std::vector<weight_t> weights)
+  {
+    if (weights.size() != boost::num_edges(_fg))
+      throw data_exception(
+        "customize(): " + std::to_string(weights.size()) + 
+        " weights for " + std::to_string(boost::num_edges(_fg)) + " edges");
+    _profiles.assign(strategy, std::move(weights));
+    _hierarchies.erase(strategy);
+    _turn_hierarchies.erase(strategy);
+    _landmarks.erase(strategy);
+    customize(strategy);
+  }
+
+  // strategies with an overlay metric: all the profiles of the model
+  std::vector<std::string> overlay_strategies(std::false_type) const {
+    return std::vector<std::string>(); }
+  std::vector<std::string> overlay_strategies(std::true_type) const
+  {
+    std::vector<std::string> strategies(1, "shortest_weight_function");
+    for (std::string strategy : 
+           weight_function_factory<
+             frozen_graph_t, vertex_map, weight_t>::get_strategies_for(_model))
+      strategies.push_back(strategy);
+    return strategies;
+  }
+
+  // multilevel partition of the frozen graph, shared by all metrics
+  void build_partition()
+  {
+    stopwatch chrono;
+    _partition.build(_fg, CRP_LEVELS, CRP_CELL_SIZE_LOG2, CRP_FANOUT_LOG2);
+    chrono.lap();
+
+    logger(logINFO)
+      << left("[cache]", 14)
+      << "Multilevel Partition > "
+      << _partition.num_levels() << " levels, "
+      << _partition.num_cells(1) << " cells, "
+      << (_partition.memory_usage() >> 20) << " MB, "
+      << prd(chrono.partial_wall_time(), 2) << "s";
+  }
+
+  void customize_metric(std::string /*strategy*/, std::false_type) {}
+  void customize_metric(std::string strategy, std::true_type)
+  {
+    stopwatch chrono;
+    metric_t& m = _metrics[strategy];
+    m.customize(_fg, _partition, _profiles.get(strategy, _fg));
+    chrono.lap();
+
+    logger(logINFO)
+      << left("[cache]", 14)
+      << "Overlay Metric > "
+      << strategy << ", "
+      << (m.memory_usage() >> 20) << " MB, "
+      << prd(chrono.partial_wall_time(), 2) << "s";
   }
 
+  // landmarks and their distances for the weight profile of strategy
+  void select_landmarks(std::string /*strategy*/, std::false_type) {}
+  void select_landmarks(std::string strategy, std::true_type)
+  {
+    stopwatch chrono;
+    landmarks_type& lm = _landmarks[strategy];
+    lm.build(_fg, _profiles.get(strategy, _fg), ALT_LANDMARKS);
+    chrono.lap();
+
+    logger(logINFO)
+      << left("[cache]", 14)
+      << "Landmarks > "
+      << strategy << ", "
+      << lm.num_landmarks() << " landmarks, "
+      << (lm.memory_usage() >> 20) << " MB, "
+      << prd(chrono.partial_wall_time(), 2) << "s";
+  }
+
+  // grid of the vertices and edges of the frozen graph, to snap
+  // coordinates onto the model
+  void build_spatial_index()
+  {
+    stopwatch chrono;
+    _spatial.build(_fg, SPATIAL_INDEX_CELL_SIZE);
+    chrono.lap();
+
+    logger(logINFO)
+      << left("[cache]", 14)
+      << "Spatial Index > "
+      << _spatial.grid().columns << " x " << _spatial.grid().rows 
+      << " cells of " << _spatial.grid().cell << " m, "
+      << (_spatial.memory_usage() >> 20) << " MB, "
+      << prd(chrono.partial_wall_time(), 2) << "s";
+  }
+
+  // writes the frozen model as a graph image of source
+  void save_image(std::string filename, std::string source) const
+  {
+    graph_image_writer w;
+    _fg.save(w, "csr");
+    _vtxmap.save(w, "vertex_map");
+    _names.save(w, "names");
+    _profiles.save(w, "profiles");
+    for (auto& kv : _hierarchies)
+      kv.second.save(w, "ch." + kv.first);
+    for (auto& kv : _turn_hierarchies)
+      kv.second.save(w, "compact_ch." + kv.first);
+    if (!_metrics.empty())
+      _partition.save(w, "crp.partition");
+    for (auto& kv : _metrics)
+      kv.second.save(w, "crp." + kv.first);
+    for (auto& kv : _landmarks)
+      kv.second.save(w, "alt." + kv.first);
+    _spatial.save(w, "spatial");
+    w.write(filename, image_header(source));
+
+    // the payload checksum once, the loads check the header only
+    if (!graph_image(filename).verify())
+      throw data_exception("save_image(): checksum mismatch " + filename);
+  }
+
+  // maps a graph image written by save_image(), false if the image
+  // was written for another model, layout or source data; arrays are 
+  // used in place and paged in lazily, see GRAPH_IMAGE_VERIFY_ON_LOAD
+  bool load_image(std::string filename, std::string source)
+  {
+    std::shared_ptr<graph_image> img = 
+      std::make_shared<graph_image>(filename);
+    const graph_image_header h = image_header(source);
+    std::string stale;
+    if (!img->matches(h.model, h.weight_size, h.vertex_size, h.edge_size))
+      stale = "layout changed";
+    else if (!img->built_from(h))
+      stale = "source data changed";
+    else if (GRAPH_IMAGE_VERIFY_ON_LOAD && !img->verify())
+      stale = "checksum mismatch";
+    if (!stale.empty()) 
+    {
+      logger(logWARNING)
+        << left("[cache]", 14)
+        << "Stale Graph image, " << stale;
+      return false;
+    }
+
+    frozen_graph_t fg;
+    vertex_map     vtxmap;
+    string_table   names;
+    profiles_t     profiles;
+    fg.map(*img, "csr");
+    vtxmap.map(*img, "vertex_map");
+    names.map(*img, "names");
+    profiles.alias("shortest_weight_function", fg.weights());
+    for (std::string strategy : 
+           weight_function_factory<
+             frozen_graph_t, vertex_map, weight_t>::get_strategies_for(_model))
+      profiles.map(*img, "profiles", strategy);
+    std::map<std::string, hierarchy_t> hierarchies;
+    for (std::string strategy : 
+           weight_function_factory<
+             frozen_graph_t, vertex_map, weight_t>::get_contracted_strategies_for(_model))
+      hierarchies[strategy].map(*img, "ch." + strategy);
+    std::map<std::string, turn_hierarchy_t> turn_hierarchies;
+    for (std::string strategy : 
+           weight_function_factory<
+             frozen_graph_t, vertex_map, weight_t>::get_turn_contracted_strategies_for(_model))
+      turn_hierarchies[strategy].map(*img, "compact_ch." + strategy);
+    multilevel_partition_t partition;
+    std::map<std::string, metric_t> metrics;
+    std::vector<std::string> customized = overlay_strategies(is_contractible());
+    if (!customized.empty())
+      partition.map(*img, "crp.partition");
+    for (std::string strategy : customized)
+      metrics[strategy].map(*img, "crp." + strategy, partition);
+    std::map<std::string, landmarks_type> landmarks;
+    for (std::string strategy : 
+           weight_function_factory<
+             frozen_graph_t, vertex_map, weight_t>::get_landmark_strategies_for(_model))
+      landmarks[strategy].map(*img, "alt." + strategy, boost::num_vertices(fg));
+    spatial_index_t spatial;
+    spatial.map(*img, "spatial");
+
+    _fg          = std::move(fg);
+    _vtxmap      = std::move(vtxmap);
+    _names       = std::move(names);
+    _profiles    = std::move(profiles);
+    _hierarchies = std::move(hierarchies);
+    for (auto& kv : _hierarchies)
+      kv.second.bind(_fg);
+    _turn_hierarchies = std::move(turn_hierarchies);
+    for (auto& kv : _turn_hierarchies)
+      kv.second.bind(_fg);
+    _partition = std::move(partition);
+    _metrics   = std::move(metrics);
+    _landmarks = std::move(landmarks);
+    _spatial   = std::move(spatial);
+    _image    = img;
+    _g.clear();
+    _edgmap.clear();
+
+    logger(logINFO)
+      << left("[cache]", 14)
+      << "Mapped Graph > "
+      << "|V| = "
+      << boost::num_vertices(_fg)
+      << ", "
+      << "|E| = "
+      << boost::num_edges(_fg)
+      << ", "
+      << (_image->size() >> 20) << " MB";
+    return true;
+  }
+  
   template <typename WeightFunctionT, 
-            typename StoppingCriteriaT = null_stopping_criteria<graph_t> >
-  optimized_routes apply_ARCsolver(
+            typename StoppingCriteriaT = null_stopping_criteria<frozen_graph_t> >
+  optimized_routes apply_solver(
       std::string       algorithm, 
-      std::string       source, 
-      std::string       target,
+      osm_id_t          source, 
+      osm_id_t          target,
       WeightFunctionT   weight_function,
-      StoppingCriteriaT stopping_criteria = null_stopping_criteria<graph_t>()) 
-  {          
-    // edge index map
-    typedef typename boost::property_map<
-      graph_t, edge_index_t edge_properties_t::*>::type IndexMap; 
+      StoppingCriteriaT stopping_criteria = null_stopping_criteria<frozen_graph_t>()) 
+  {
+    return apply_solver(
+      _fg, algorithm, source, target, weight_function, stopping_criteria);
+  }
 
-    IndexMap edge_index_map = boost::get(&edge_properties_t::edge_index, _g);  
+  // solves on g, the frozen graph or a structure built on it (e.g. a
+  // contraction hierarchy) sharing its vertices and edges
+  template <typename SolverGraphT,
+            typename WeightFunctionT, 
+            typename StoppingCriteriaT = null_stopping_criteria<SolverGraphT> >
+  optimized_routes apply_solver(
+      SolverGraphT&     g,
+      std::string       algorithm, 
+      osm_id_t          source, 
+      osm_id_t          target,
+      WeightFunctionT   weight_function,
+      StoppingCriteriaT stopping_criteria = null_stopping_criteria<SolverGraphT>()) 
+  {          
+    IndexMap edge_index_map = boost::get(boost::edge_index, _fg);  
 
-    if( (_vtxmap).find(source) == _vtxmap.end() || 
-        (_vtxmap).find(target) == _vtxmap.end() ) 
-    {
+    auto sit = _vtxmap.find(source);
+    auto tit = _vtxmap.find(target);
+    if( sit == _vtxmap.end() || 
+        tit == _vtxmap.end() ) {
       logger(logINFO) 
           << left("[*]", 14) 
           << ">> no route found, invalid points";
       return optimized_routes();
     }
-
-    graph_solver<
-        graph_t, 
+    
+    // one solver per search, the frozen graph is shared read-only
+    std::unique_ptr<
+      graph_solver<
+        SolverGraphT, 
         weight_t,
         IndexMap, 
         WeightFunctionT, 
-        StoppingCriteriaT >* gsolver =  
+        StoppingCriteriaT > > gsolver(  
       gsolver_factory<
-        graph_t, 
+        SolverGraphT, 
         weight_t,
         IndexMap, 
         WeightFunctionT, 
         StoppingCriteriaT >::instance()
-         .get_solver_for( _g, algorithm, _edgmap, (_vtxmap)[source], (_vtxmap)[target]);         
+         .get_solver_for( g, algorithm, sit->second, tit->second));         
     
-    try {
+    try 
+    {
       gsolver->solve(weight_function, edge_index_map, stopping_criteria);
-      return gsolver->get_optimized_routes();        
+      return gsolver->get_optimized_routes(_names);        
     } catch (std::exception) 
     {
       logger(logINFO) 
           << left("[*]", 14) 
-          << ">> no route found!";      
+          << ">> no route found!";        
       return optimized_routes();
     }
-  }  
+  }
 
   template <typename WeightFunctionT, 
-            typename StoppingCriteriaT = null_stopping_criteria<graph_t> >
+            typename StoppingCriteriaT = null_stopping_criteria<frozen_graph_t> >
   optimized_routes apply_solver(
       std::string              algorithm, 
-      std::string              source, 
-      std::vector<std::string> targets, 
+      osm_id_t                 source, 
+      std::vector<osm_id_t>    targets, 
       WeightFunctionT          weight_function,
-      StoppingCriteriaT        stopping_criteria = null_stopping_criteria<graph_t>())  
+      StoppingCriteriaT        stopping_criteria = null_stopping_criteria<frozen_graph_t>())  
   {
-    // edge index map
-    typedef typename boost::property_map<
-      graph_t, edge_index_t edge_properties_t::*>::type IndexMap; 
-
-    IndexMap edge_index_map = boost::get(&edge_properties_t::edge_index, _g); 
+    IndexMap edge_index_map = boost::get(boost::edge_index, _fg); 
 
-    std::vector<vertex_descriptor> tvec;
-    for (std::string t : targets)
-      tvec.push_back((_vtxmap)[t]);
+    std::vector<
+      typename frozen_graph_t::vertex_descriptor> tvec;
+    for (osm_id_t t : targets)
+      tvec.push_back(_vtxmap.at(t));
     
-    graph_solver<
-        graph_t, 
+    // one solver per search, the frozen graph is shared read-only
+    std::unique_ptr<
+      graph_solver<
+        frozen_graph_t, 
         weight_t,
         IndexMap, 
         WeightFunctionT, 
-        StoppingCriteriaT >* gsolver =  
+        StoppingCriteriaT > > gsolver(  
       gsolver_factory<
-        graph_t, 
+        frozen_graph_t, 
         weight_t,
         IndexMap, 
         WeightFunctionT, 
         StoppingCriteriaT >::instance()
-         .get_solver_for( _g, algorithm, (_vtxmap)[source], tvec);    
+         .get_solver_for( _fg, algorithm, _vtxmap.at(source), tvec));    
     
     try {
       gsolver->solve(weight_function, edge_index_map, stopping_criteria);
-      return gsolver->get_optimized_routes();        
+      return gsolver->get_optimized_routes(_names);        
     } catch (std::exception) 
     {
       logger(logINFO) 
@@ -401,39 +821,218 @@ public:
 
   }
 
+  // solves on the hierarchy of strategy, with the fallback algorithm
+  // on the frozen graph when it was not contracted
+  template <typename HierarchyMapT>
+  optimized_routes apply_hierarchy_solver(
+      HierarchyMapT& hierarchies,
+      std::string    algorithm, 
+      std::string    fallback, 
+      osm_id_t       source, 
+      osm_id_t       target,
+      std::string    strategy,
+      weight_map_t   weight_map,
+      std::true_type)
+  {
+    auto hit = hierarchies.find(strategy);
+    if (hit == hierarchies.end()) 
+      return apply_hierarchy_solver(
+        hierarchies, algorithm, fallback, source, target, 
+        strategy, weight_map, std::false_type());
+    return apply_solver(
+        hit->second,
+        algorithm,   
+        source, 
+        target,
+        weight_map);
+  }
+
+  template <typename HierarchyMapT>
+  optimized_routes apply_hierarchy_solver(
+      HierarchyMapT& /*hierarchies*/,
+      std::string    /*algorithm*/, 
+      std::string    fallback, 
+      osm_id_t       source, 
+      osm_id_t       target,
+      std::string    strategy,
+      weight_map_t   /*weight_map*/,
+      std::false_type)
+  {
+    logger(logWARNING) 
+      << left("[engine] ", 14) 
+      << "Contraction Hierarchy unknown for " << _model << ", "
+      << "select " << fallback;
+    return route_optimize(fallback, source, target, strategy);
+  }
+
+  // solves on the overlay of the metric of strategy, with the fallback
+  // algorithm on the frozen graph when it was not customized
+  optimized_routes apply_overlay_solver(
+      std::string    algorithm, 
+      std::string    fallback, 
+      osm_id_t       source, 
+      osm_id_t       target,
+      std::string    strategy,
+      weight_map_t   weight_map,
+      std::true_type)
+  {
+    auto mit = _metrics.find(strategy);
+    if (mit == _metrics.end()) 
+      return apply_overlay_solver(
+        algorithm, fallback, source, target, 
+        strategy, weight_map, std::false_type());
+    overlay_t og(_fg, _partition, mit->second);
+    return apply_solver(
+        og,
+        algorithm,   
+        source, 
+        target,
+        weight_map);
+  }
+
+  optimized_routes apply_overlay_solver(
+      std::string    /*algorithm*/, 
+      std::string    fallback, 
+      osm_id_t       source, 
+      osm_id_t       target,
+      std::string    strategy,
+      weight_map_t   /*weight_map*/,
+      std::false_type)
+  {
+    logger(logWARNING) 
+      << left("[engine] ", 14) 
+      << "Overlay Metric unknown for " << _model << ", "
+      << "select " << fallback;
+    return route_optimize(fallback, source, target, strategy);
+  }
+
+  // solves on the landmarks of strategy, with the fallback algorithm
+  // on the frozen graph when they were not computed
+  optimized_routes apply_landmark_solver(
+      std::string    algorithm, 
+      std::string    fallback, 
+      osm_id_t       source, 
+      osm_id_t       target,
+      std::string    strategy,
+      weight_map_t   weight_map,
+      std::true_type)
+  {
+    auto lit = _landmarks.find(strategy);
+    if (lit == _landmarks.end()) 
+      return apply_landmark_solver(
+        algorithm, fallback, source, target, 
+        strategy, weight_map, std::false_type());
+    landmark_graph_type lg(_fg, lit->second);
+    return apply_solver(
+        lg,
+        algorithm,   
+        source, 
+        target,
+        weight_map);
+  }
+
+  optimized_routes apply_landmark_solver(
+      std::string    /*algorithm*/, 
+      std::string    fallback, 
+      osm_id_t       source, 
+      osm_id_t       target,
+      std::string    strategy,
+      weight_map_t   /*weight_map*/,
+      std::false_type)
+  {
+    logger(logWARNING) 
+      << left("[engine] ", 14) 
+      << "Landmarks unknown for " << _model << ", "
+      << "select " << fallback;
+    return route_optimize(fallback, source, target, strategy);
+  }
+
   optimized_routes route_optimize(
       std::string algorithm,  
-      std::string source, 
-      std::string target,
+      osm_id_t    source, 
+      osm_id_t    target,
       std::string strategy = "shortest_weight_function") 
   {
-    generic_weight_functor<graph_t, vertex_map, weight_t>* functor =
-      weight_function_factory<graph_t, vertex_map, weight_t>::get_functor_for(
-        strategy, _g, _vtxmap); 
+    if ( !_vtxmap.contains(source) || 
+         !_vtxmap.contains(target) ) 
+    {
+      logger(logINFO) 
+          << left("[*]", 14) 
+          << ">> no route found, invalid points";
+      return optimized_routes();
+    }
+
+    if (!_profiles.contains(strategy)) 
+    {
+      logger(logWARNING) 
+        << left("[engine] ", 14) 
+        << "Weight Function unknown for " << _model << ", "
+        << "select Shortest Weight Function";
+      strategy = "shortest_weight_function";
+    }
+    weight_map_t weight_map = _profiles.get(strategy, _fg);
     
-    if (algorithm == "dijkstra") 
+    if (algorithm == "dijkstra"                       || 
+        algorithm == "compact_dijkstra"               ||
+        algorithm == "bidirectional_dijkstra"         ||
+        algorithm == "compact_bidirectional_dijkstra" ||
+        algorithm == "ellipse_dijkstra") 
     {
-      target_dijkstra_stopping_criteria<graph_t> stopping_criteria = 
-        target_dijkstra_stopping_criteria<graph_t>((_vtxmap)[target]);
-        
+      target_dijkstra_stopping_criteria<frozen_graph_t> stopping_criteria = 
+        target_dijkstra_stopping_criteria<frozen_graph_t>(_vtxmap.at(target));
+              
       return apply_solver(
           algorithm,   
           source, 
           target,
-          functor,
-          stopping_criteria);          
-    }
-    else if (algorithm == "compact_dijkstra") 
+          weight_map,
+          stopping_criteria);                              
+    }  
+    else if (algorithm == "ch") 
     {
-      target_dijkstra_stopping_criteria<graph_t> stopping_criteria = 
-        target_dijkstra_stopping_criteria<graph_t>((_vtxmap)[target]);
-              
-      return apply_ARCsolver(
+      return apply_hierarchy_solver(
+          _hierarchies,
           algorithm,   
+          "dijkstra",
           source, 
           target,
-          functor,
-          stopping_criteria);                              
+          strategy,
+          weight_map,
+          is_contractible());
+    }  
+    else if (algorithm == "compact_ch") 
+    {
+      return apply_hierarchy_solver(
+          _turn_hierarchies,
+          algorithm,   
+          "compact_dijkstra",
+          source, 
+          target,
+          strategy,
+          weight_map,
+          is_contractible());
+    }  
+    else if (algorithm == "crp") 
+    {
+      return apply_overlay_solver(
+          algorithm,   
+          "dijkstra",
+          source, 
+          target,
+          strategy,
+          weight_map,
+          is_contractible());
+    }  
+    else if (algorithm == "alt") 
+    {
+      return apply_landmark_solver(
+          algorithm,   
+          "dijkstra",
+          source, 
+          target,
+          strategy,
+          weight_map,
+          is_contractible());
     }  
     else if (algorithm == "bicriterion_epsMOA_star") 
     {
@@ -441,13 +1040,797 @@ public:
           algorithm,   
           source, 
           target,
-          functor);                             
+          weight_map);                             
     }  
     else
      return optimized_routes();
 
   }
 
+  // snaps (lon, lat) onto the nearest edge of the model within
+  // max_distance (m), false when there is none; see snapped_point
+  bool snap(
+      double         lon,
+      double         lat,
+      snapped_point& p,
+      double         max_distance = SNAP_MAX_DISTANCE) const
+  {
+    spatial_index_t::edge_hit hit;
+    if (!_spatial.nearest_edge(_fg, lon, lat, max_distance, hit))
+      return false;
+    auto e = edge_at(hit.edge, _fg);
+    p.source   = _fg[boost::source(e, _fg)].id;
+    p.target   = _fg[boost::target(e, _fg)].id;
+    p.node     = hit.ratio <= 0.5 ? p.source : p.target;
+    p.lon      = hit.lon;
+    p.lat      = hit.lat;
+    p.ratio    = hit.ratio;
+    p.distance = hit.distance;
+    return true;
+  }
+
+  // the point of the nearest edge to (lon, lat) usable with weight_map,
+  // within SNAP_MAX_DISTANCE (m), false when there is none; its reverse
+  // is the cheapest edge back between the same vertices, if any
+  bool phantom(
+      double              lon,
+      double              lat,
+      const weight_map_t& weight_map,
+      phantom_node&       p) const
+  {
+    const weight_t infinity = std::numeric_limits<weight_t>::max();
+    spatial_index_t::edge_hit hit;
+    if (!_spatial.nearest_edge(_fg, lon, lat, SNAP_MAX_DISTANCE, 
+          [&](edge_index_t idx) { 
+            return get(weight_map, edge_at(idx, _fg)) < infinity; }, hit))
+      return false;
+    auto e = edge_at(hit.edge, _fg);
+    vertex_descriptor u = boost::source(e, _fg);
+    p.forward = hit.edge;
+    p.reverse = phantom_node::none;
+    p.ratio   = hit.ratio;
+    p.lon     = hit.lon;
+    p.lat     = hit.lat;
+    weight_t w = infinity;
+    auto oer = boost::out_edges(boost::target(e, _fg), _fg);
+    for (auto it = oer.first; it != oer.second; ++it)
+      if (boost::target(*it, _fg) == u && get(weight_map, *it) < w) {
+        w         = get(weight_map, *it);
+        p.reverse = _fg[*it].edge_index;
+      }
+    return true;
+  }
+
+  // route between two coordinates, each snapped onto the nearest edge
+  // of the model: the route leaves and reaches the edges at the snapped
+  // points (see phantom_node). Algorithms named compact_ search edge
+  // labels with turn costs, compact_ch on the turn hierarchy; ch runs
+  // on the hierarchy, the others as phantom dijkstra on the frozen
+  // graph (see phantom_fallback)
+  optimized_routes route_optimize(
+      std::string algorithm,
+      double      source_lon,
+      double      source_lat,
+      double      target_lon,
+      double      target_lat,
+      std::string strategy = "shortest_weight_function")
+  {
+    if (!_profiles.contains(strategy)) 
+    {
+      logger(logWARNING) 
+        << left("[engine] ", 14) 
+        << "Weight Function unknown for " << _model << ", "
+        << "select Shortest Weight Function";
+      strategy = "shortest_weight_function";
+    }
+    return route_optimize(algorithm, source_lon, source_lat, 
+      target_lon, target_lat, strategy, is_contractible());
+  }
+
+  // weights that are not scalar: from and to the nearer end of the edges
+  optimized_routes route_optimize(
+      std::string algorithm,
+      double      source_lon,
+      double      source_lat,
+      double      target_lon,
+      double      target_lat,
+      std::string strategy,
+      std::false_type)
+  {
+    snapped_point s, t;
+    if (!snap(source_lon, source_lat, s) ||
+        !snap(target_lon, target_lat, t))
+    {
+      logger(logINFO)
+          << left("[*]", 14)
+          << ">> no route found, points off the model";
+      return optimized_routes();
+    }
+    return route_optimize(algorithm, s.node, t.node, strategy);
+  }
+
+  optimized_routes route_optimize(
+      std::string algorithm,
+      double      source_lon,
+      double      source_lat,
+      double      target_lon,
+      double      target_lat,
+      std::string strategy,
+      std::true_type)
+  {
+    weight_map_t weight_map = _profiles.get(strategy, _fg);
+    phantom_node s, t;
+    if (!phantom(source_lon, source_lat, weight_map, s) ||
+        !phantom(target_lon, target_lat, weight_map, t))
+    {
+      logger(logINFO)
+          << left("[*]", 14)
+          << ">> no route found, points off the model";
+      return optimized_routes();
+    }
+
+    stopwatch chrono;
+    stats_t stats;
+    std::vector<phantom_leg> legs;
+    bool found = algorithm.compare(0, 8, "compact_") == 0 ?
+      phantom_route(algorithm, s, t, strategy, weight_map, legs, stats,
+        edge_based_hierarchy_tag()) :
+      phantom_route(algorithm, s, t, strategy, weight_map, legs, stats,
+        vertex_based_hierarchy_tag());
+    chrono.lap();
+
+    logger(logINFO) 
+      << left("[solver] ", 14) 
+      << "Phantom Nodes [ " << algorithm << ", " << strategy << " ] "
+      << stats.visited_nodes << " visited, "
+      << prd(chrono.partial_wall_time(), 5) << "s";
+    if (!found) 
+    {
+      logger(logINFO) 
+          << left("[*]", 14) 
+          << ">> no route found!";
+      return optimized_routes();
+    }
+    return optimized_routes(1, phantom_route(s, t, legs));
+  }
+
+  // the part of a slot from s to t when both points lie on it in this
+  // order, the cost of the best one or max
+  weight_t phantom_direct(
+      const phantom_node&       s,
+      const phantom_node&       t,
+      const weight_map_t&       weight_map,
+      std::vector<phantom_leg>& legs) const
+  {
+    weight_t best = std::numeric_limits<weight_t>::max();
+    for (auto& a : s.slots())
+      for (auto& b : t.slots())
+        if (a.first == b.first && a.second <= b.second) 
+        {
+          weight_t c = (b.second - a.second) * 
+            get(weight_map, edge_at(a.first, _fg));
+          if (c < best) {
+            best = c;
+            legs.assign(1, phantom_leg{a.first, a.second, b.second});
+          }
+        }
+    return best;
+  }
+
+  // phantom dijkstra stands for the solvers that cannot start from the
+  // slots of a point: quietly for the dijkstras, with a warning for the
+  // others and for a missing hierarchy; unknown names are rejected
+  void phantom_fallback(const std::string& algorithm) const
+  {
+    if (algorithm == "ch" || algorithm == "compact_ch")
+      logger(logWARNING) 
+        << left("[engine] ", 14) 
+        << "Contraction Hierarchy unknown for " << _model << ", "
+        << "select phantom dijkstra";
+    else if (algorithm == "crp" || algorithm == "alt" ||
+             algorithm == "bicriterion_epsMOA_star")
+      logger(logWARNING) 
+        << left("[engine] ", 14) 
+        << algorithm << " not seeded from phantom nodes, "
+        << "select phantom dijkstra";
+    else if (algorithm != "dijkstra"                       &&
+             algorithm != "compact_dijkstra"               &&
+             algorithm != "bidirectional_dijkstra"         &&
+             algorithm != "compact_bidirectional_dijkstra" &&
+             algorithm != "ellipse_dijkstra")
+      throw solver_exception(
+        "route_optimize(): algorithm unknown " + algorithm);
+  }
+
+  // vertex labels: the searches start at the heads of the slots of s,
+  // with the cost of the rest of the slot, and end at the tails of the
+  // slots of t, with the cost of the slot up to the point
+  bool phantom_route(
+      std::string               algorithm,
+      const phantom_node&       s,
+      const phantom_node&       t,
+      std::string               strategy,
+      const weight_map_t&       weight_map,
+      std::vector<phantom_leg>& legs,
+      stats_t&                  stats,
+      vertex_based_hierarchy_tag)
+  {
+    typedef std::vector<std::pair<uint32_t, weight_t> > seeds_t;
+
+    const weight_t infinity = std::numeric_limits<weight_t>::max();
+    seeds_t sources, targets;
+    for (auto& a : s.slots()) {
+      auto e = edge_at(a.first, _fg);
+      sources.push_back(std::make_pair(uint32_t(boost::target(e, _fg)),
+        weight_t((1 - a.second) * get(weight_map, e))));
+    }
+    for (auto& b : t.slots()) {
+      auto e = edge_at(b.first, _fg);
+      targets.push_back(std::make_pair(uint32_t(boost::source(e, _fg)),
+        weight_t(b.second * get(weight_map, e))));
+    }
+
+    weight_t direct = phantom_direct(s, t, weight_map, legs);
+    std::vector<edge_index_t> slots;
+    uint32_t root, last;
+    auto hit = _hierarchies.find(strategy);
+    if (algorithm == "ch" && hit != _hierarchies.end())
+    {
+      auto& forward  = thread_search_workspace<
+        uint32_t, weight_t, ch_forward_search>();
+      auto& backward = thread_search_workspace<
+        uint32_t, weight_t, ch_backward_search>();
+      uint32_t meet;
+      weight_t mu;
+      std::tie(meet, mu) = contraction_hierarchy_algorithm::compute(
+        hit->second, sources, targets, forward, backward, stats);
+      if (meet == hierarchy_t::arc_t::none || mu >= direct)
+        return direct < infinity;
+      contraction_hierarchy_algorithm::unpack_path(
+        hit->second, meet, forward, backward, std::back_inserter(slots));
+      for (root = meet; forward.parent(root) != root; )
+        root = forward.parent(root);
+      for (last = meet; backward.parent(last) != last; )
+        last = backward.parent(last);
+    }
+    else
+    {
+      phantom_fallback(algorithm);
+      auto& ws = thread_search_workspace<
+        uint32_t, weight_t, phantom_dijkstra_algorithm>();
+      size_t   best;
+      weight_t mu;
+      std::tie(best, mu) = phantom_dijkstra_algorithm::compute(
+        _fg, sources, targets, direct, ws, weight_map, stats);
+      if (best == targets.size())
+        return direct < infinity;
+      // the cheapest edge between the vertices of each parent link
+      last = targets[best].first;
+      for (root = last; ws.parent(root) != root; root = ws.parent(root))
+      {
+        edge_index_t found = phantom_node::none;
+        weight_t     w     = infinity;
+        auto oer = boost::out_edges(ws.parent(root), _fg);
+        for (auto it = oer.first; it != oer.second; ++it)
+          if (boost::target(*it, _fg) == root && get(weight_map, *it) < w) {
+            w     = get(weight_map, *it);
+            found = _fg[*it].edge_index;
+          }
+        slots.push_back(found);
+      }
+      std::reverse(slots.begin(), slots.end());
+    }
+
+    // the slots of s and t at the ends of the path, the cheapest ones
+    // when both slots of a point share the vertex
+    legs.clear();
+    size_t si = 0;
+    for (size_t i = 1; i < sources.size(); ++i)
+      if (sources[i].first == root && 
+          (sources[si].first != root || 
+           sources[i].second < sources[si].second))
+        si = i;
+    auto sslots = s.slots();
+    legs.push_back(phantom_leg{
+      sslots[si].first, sslots[si].second, 1.0});
+    for (edge_index_t idx : slots)
+      legs.push_back(phantom_leg{idx, 0.0, 1.0});
+    size_t ti = 0;
+    for (size_t i = 1; i < targets.size(); ++i)
+      if (targets[i].first == last && 
+          (targets[ti].first != last || 
+           targets[i].second < targets[ti].second))
+        ti = i;
+    auto tslots = t.slots();
+    legs.push_back(phantom_leg{
+      tslots[ti].first, 0.0, tslots[ti].second});
+    return true;
+  }
+
+  // edge labels: the searches start on the slots of s, with the cost 
+  // of the rest of the slot, and end on the in-edges of the tails of 
+  // the slots of t, with the turn onto the slot and its cost up to the 
+  // point; so a route may come back onto the slot it left
+  bool phantom_route(
+      std::string               algorithm,
+      const phantom_node&       s,
+      const phantom_node&       t,
+      std::string               strategy,
+      const weight_map_t&       weight_map,
+      std::vector<phantom_leg>& legs,
+      stats_t&                  stats,
+      edge_based_hierarchy_tag)
+  {
+    typedef std::vector<std::pair<uint32_t, weight_t> > seeds_t;
+
+    const weight_t infinity = std::numeric_limits<weight_t>::max();
+    seeds_t sources, targets;
+    std::vector<std::pair<edge_index_t, double> > ends; // by target
+    for (auto& a : s.slots()) 
+      sources.push_back(std::make_pair(a.first, 
+        weight_t((1 - a.second) * get(weight_map, edge_at(a.first, _fg)))));
+    for (auto& b : t.slots()) 
+    {
+      auto     f = edge_at(b.first, _fg);
+      auto     u = boost::source(f, _fg);
+      weight_t w = b.second * get(weight_map, f);
+      auto ier = boost::in_edges(u, _fg);
+      for (auto it = ier.first; it != ier.second; ++it)
+      {
+        weight_t turn = _fg.has_turn_table(u) ?
+          _fg.turn_cost(u, _fg[*it].entry_point, _fg[f].exit_point) : weight_t();
+        if (turn == infinity)
+          continue; // restricted manoeuvre
+        targets.push_back(std::make_pair(_fg[*it].edge_index, turn + w));
+        ends.push_back(b);
+      }
+    }
+
+    weight_t direct = phantom_direct(s, t, weight_map, legs);
+    std::vector<edge_index_t> slots;
+    auto hit = _turn_hierarchies.find(strategy);
+    if (algorithm == "compact_ch" && hit != _turn_hierarchies.end())
+    {
+      auto& forward  = thread_search_workspace<
+        uint32_t, weight_t, ch_forward_search>();
+      auto& backward = thread_search_workspace<
+        uint32_t, weight_t, ch_backward_search>();
+      uint32_t meet;
+      weight_t mu;
+      std::tie(meet, mu) = contraction_hierarchy_algorithm::compute(
+        hit->second, sources, targets, forward, backward, stats);
+      if (meet == turn_hierarchy_t::arc_t::none || mu >= direct)
+        return direct < infinity;
+      // the root is a slot of s, the turns unpack into the edges that 
+      // follow up to an in-edge of a slot of t
+      uint32_t root = meet;
+      while (forward.parent(root) != root)
+        root = forward.parent(root);
+      slots.push_back(root);
+      contraction_hierarchy_algorithm::unpack_path(
+        hit->second, meet, forward, backward, std::back_inserter(slots));
+    }
+    else
+    {
+      phantom_fallback(algorithm);
+      auto& ws = thread_search_workspace<
+        uint32_t, weight_t, phantom_dijkstra_algorithm>();
+      size_t   best;
+      weight_t mu;
+      std::tie(best, mu) = phantom_dijkstra_algorithm::arc_based_compute(
+        _fg, sources, targets, direct, ws, weight_map, stats);
+      if (best == targets.size())
+        return direct < infinity;
+      uint32_t idx = targets[best].first;
+      for (; ws.parent(idx) != idx; idx = ws.parent(idx))
+        slots.push_back(idx);
+      slots.push_back(idx);
+      std::reverse(slots.begin(), slots.end());
+    }
+
+    // the slots of s and t at the ends of the path, the cheapest ones
+    // when both slots of a point share the edge
+    legs.clear();
+    double from = 0;
+    for (size_t i = 0; i < sources.size(); ++i)
+      if (sources[i].first == slots.front())
+        from = s.slots()[i].second;
+    size_t ti = targets.size();
+    for (size_t i = 0; i < targets.size(); ++i)
+      if (targets[i].first == slots.back() && 
+          (ti == targets.size() || targets[i].second < targets[ti].second))
+        ti = i;
+    for (edge_index_t idx : slots)
+      legs.push_back(phantom_leg{idx, 0.0, 1.0});
+    legs.front().from = from;
+    legs.push_back(phantom_leg{ends[ti].first, 0.0, ends[ti].second});
+    return true;
+  }
+
+  // a route along legs from s to t, the legs at the ends start or stop
+  // at the points
+  Route phantom_route(
+      const phantom_node&             s,
+      const phantom_node&             t,
+      const std::vector<phantom_leg>& legs) const
+  {
+    // legs of no length are the points at vertices, a route of one
+    // such leg joins two points at the same place
+    std::vector<phantom_leg> parts;
+    for (const phantom_leg& l : legs)
+      if (l.to > l.from)
+        parts.push_back(l);
+    if (parts.empty())
+      parts.push_back(legs.front());
+
+    Route route;
+    for (size_t i = 0; i < parts.size(); ++i)
+    {
+      const phantom_leg& l = parts[i];
+      auto e = edge_at(l.edge, _fg);
+      const auto& u = _fg[boost::source(e, _fg)];
+      const auto& v = _fg[boost::target(e, _fg)];
+      bool start = i == 0, end = i + 1 == parts.size();
+      route.add_route_edge(
+        edge_weight_adaptor<weight_t>::to_length(_fg[e].weight) * (l.to - l.from),
+        to_highway_value(_fg[e].properties.highway),
+        _names[_fg[e].properties.desc],
+        start ? std::string() : std::to_string(u.id),
+        start ? s.lon : u.geo.lon,
+        start ? s.lat : u.geo.lat,
+        end   ? std::string() : std::to_string(v.id),
+        end   ? t.lon : v.geo.lon,
+        end   ? t.lat : v.geo.lat);
+    }
+    return route;
+  }
+
+  // travel costs from every source to every target on the hierarchy
+  // of strategy, the edge-based one when the model has turn tables; 
+  // see many_to_many_algorithm. Sources and targets unknown to the 
+  // model stay unreachable
+  distance_matrix many_to_many(
+      std::vector<osm_id_t> sources,
+      std::vector<osm_id_t> targets,
+      std::string           strategy = "shortest_weight_function")
+  {
+    if (!_profiles.contains(strategy)) 
+    {
+      logger(logWARNING) 
+        << left("[engine] ", 14) 
+        << "Weight Function unknown for " << _model << ", "
+        << "select Shortest Weight Function";
+      strategy = "shortest_weight_function";
+    }
+    return many_to_many(sources, targets, strategy, is_contractible());
+  }
+
+  distance_matrix many_to_many(
+      std::vector<osm_id_t> /*sources*/,
+      std::vector<osm_id_t> /*targets*/,
+      std::string           /*strategy*/,
+      std::false_type)
+  {
+    throw solver_exception(
+      "many_to_many(): no contraction hierarchy for " + _model);
+  }
+
+  distance_matrix many_to_many(
+      std::vector<osm_id_t> sources,
+      std::vector<osm_id_t> targets,
+      std::string           strategy,
+      std::true_type)
+  {
+    auto tit = _turn_hierarchies.find(strategy);
+    if (tit != _turn_hierarchies.end())
+      return many_to_many(tit->second, sources, targets, strategy);
+    auto hit = _hierarchies.find(strategy);
+    if (hit != _hierarchies.end())
+      return many_to_many(hit->second, sources, targets, strategy);
+    throw solver_exception(
+      "many_to_many(): no contraction hierarchy for " + 
+      _model + ", " + strategy);
+  }
+
+  template <typename HierarchyT>
+  distance_matrix many_to_many(
+      const HierarchyT&     h,
+      std::vector<osm_id_t> sources,
+      std::vector<osm_id_t> targets,
+      std::string           strategy)
+  {
+    typedef many_to_many_label<weight_t> label_t;
+
+    // lengths and durations of the edge slots, then of the arcs
+    const std::string mode = travel_mode();
+    const size_t      m    = boost::num_edges(_fg);
+    std::vector<double> lengths(m), durations(m);
+    for (edge_index_t idx = 0; idx < m; ++idx) 
+    {
+      lengths[idx]   = _fg.weights()[idx];
+      durations[idx] = lengths[idx] / 
+        average_speed(mode, _fg[edge_at(idx, _fg)].properties.highway);
+    }
+
+    weight_map_t weight_map = _profiles.get(strategy, _fg);
+    std::vector<std::vector<label_t> > sseeds, tseeds;
+    for (osm_id_t s : sources)
+      sseeds.push_back(many_to_many_seeds(
+        s, true, weight_map, lengths, durations, 
+        typename HierarchyT::node_category()));
+    for (osm_id_t t : targets)
+      tseeds.push_back(many_to_many_seeds(
+        t, false, weight_map, lengths, durations, 
+        typename HierarchyT::node_category()));
+
+    logger(logINFO) 
+      << left("[solver] ", 14) 
+      << many_to_many_algorithm::get_name() << " [ " 
+      << sources.size() << " x " << targets.size() << ", " 
+      << strategy << " ]";
+
+    distance_matrix dm;
+    dm.sources = sources;
+    dm.targets = targets;
+    std::vector<weight_t> weights;
+    stats_t stats;
+    many_to_many_algorithm::compute(
+      h, sseeds, tseeds, 
+      h.arc_metric(lengths.data()), h.arc_metric(durations.data()),
+      weights, dm.lengths, dm.durations, stats);
+
+    dm.weights.resize(weights.size());
+    for (size_t c = 0; c < weights.size(); ++c)
+      dm.weights[c] = weights[c] == std::numeric_limits<weight_t>::max() ?
+        std::numeric_limits<double>::infinity() : weights[c];
+    // a source is its own target, not a cycle through it
+    for (size_t i = 0; i < sources.size(); ++i)
+      for (size_t j = 0; j < targets.size(); ++j)
+        if (sources[i] == targets[j] && _vtxmap.contains(sources[i]))
+          dm.weights[dm.at(i, j)] = dm.lengths[dm.at(i, j)] = 
+            dm.durations[dm.at(i, j)] = 0;
+    return dm;
+  }
+
+  // searches of a vertex-based hierarchy start at the vertex
+  template <typename WeightMapT>
+  std::vector<many_to_many_label<weight_t> > many_to_many_seeds(
+      osm_id_t                    id,
+      bool                        /*source*/,
+      WeightMapT&                 /*weight_map*/,
+      const std::vector<double>&  /*lengths*/,
+      const std::vector<double>&  /*durations*/,
+      vertex_based_hierarchy_tag)
+  {
+    std::vector<many_to_many_label<weight_t> > seeds;
+    auto vit = _vtxmap.find(id);
+    if (vit != _vtxmap.end())
+      seeds.push_back({uint32_t(vit->second), 0, weight_t(), 0, 0});
+    return seeds;
+  }
+
+  // searches of an edge-based hierarchy start at the out-edges of a 
+  // source, with their own weight, and at the in-edges of a target
+  template <typename WeightMapT>
+  std::vector<many_to_many_label<weight_t> > many_to_many_seeds(
+      osm_id_t                    id,
+      bool                        source,
+      WeightMapT&                 weight_map,
+      const std::vector<double>&  lengths,
+      const std::vector<double>&  durations,
+      edge_based_hierarchy_tag)
+  {
+    std::vector<many_to_many_label<weight_t> > seeds;
+    auto vit = _vtxmap.find(id);
+    if (vit == _vtxmap.end())
+      return seeds;
+    if (source) 
+    {
+      auto oer = boost::out_edges(vit->second, _fg);
+      for (auto it = oer.first; it != oer.second; ++it) {
+        edge_index_t idx = _fg[*it].edge_index;
+        seeds.push_back(
+          {idx, 0, get(weight_map, *it), lengths[idx], durations[idx]});
+      }
+    } 
+    else 
+    {
+      auto ier = boost::in_edges(vit->second, _fg);
+      for (auto it = ier.first; it != ier.second; ++it)
+        seeds.push_back({_fg[*it].edge_index, 0, weight_t(), 0, 0});
+    }
+    return seeds;
+  }
+
+  // travel mode of the model, estimated times are by mode
+  std::string travel_mode() const
+  {
+    if (_model.find("road_") != std::string::npos)
+      return "car";
+    if (_model.find("bicycle_") != std::string::npos)
+      return "bike";
+    return "foot";
+  }
+
+  // areas reachable from every source within limit, in weights of 
+  // strategy: a PHAST sweep of the hierarchy of strategy, the 
+  // edge-based one when the model has turn tables, or a Dijkstra search
+  // bounded by limit when there is no hierarchy. Sources run on all 
+  // cores; a source unknown to the model has no cells
+  std::vector<isochrone> isochrones(
+      std::vector<osm_id_t> sources,
+      double                limit,
+      std::string           strategy  = "shortest_weight_function",
+      double                cell_size = ISOCHRONE_CELL_SIZE)
+  {
+    if (!_profiles.contains(strategy)) 
+    {
+      logger(logWARNING) 
+        << left("[engine] ", 14) 
+        << "Weight Function unknown for " << _model << ", "
+        << "select Shortest Weight Function";
+      strategy = "shortest_weight_function";
+    }
+    if (!(cell_size > 0))
+      throw solver_exception("isochrones(): cell size must be positive");
+
+    stopwatch chrono;
+    std::vector<isochrone> isos(sources.size());
+    work_stealing_pool& pool = work_stealing_pool::instance();
+    std::vector<std::vector<weight_t> > costs(pool.size());
+    pool.parallel_for(sources.size(), [&](unsigned w, size_t i) {
+      isos[i].source    = sources[i];
+      isos[i].limit     = limit;
+      isos[i].cell_size = cell_size;
+      auto vit = _vtxmap.find(sources[i]);
+      if (vit == _vtxmap.end())
+        return;
+      one_to_all(vit->second, weight_t(limit), strategy, costs[w], 
+        is_contractible());
+      isochrone_cells(vit->second, weight_t(limit), strategy, costs[w], 
+        isos[i]);
+    });
+    chrono.lap();
+
+    logger(logINFO) 
+      << left("[solver] ", 14) 
+      << "Isochrones [ " << sources.size() << " sources, limit = " 
+      << limit << ", " << strategy << " ] "
+      << prd(chrono.partial_wall_time(), 3) << "s";
+    return isos;
+  }
+
+  void one_to_all(
+      vertex_descriptor      /*s*/,
+      weight_t               /*limit*/,
+      std::string            /*strategy*/,
+      std::vector<weight_t>& /*costs*/,
+      std::false_type)
+  {
+    throw solver_exception(
+      "isochrones(): no scalar weights for " + _model);
+  }
+
+  // least cost of every vertex from s, max beyond limit
+  void one_to_all(
+      vertex_descriptor      s,
+      weight_t               limit,
+      std::string            strategy,
+      std::vector<weight_t>& costs,
+      std::true_type)
+  {
+    auto tit = _turn_hierarchies.find(strategy);
+    if (tit != _turn_hierarchies.end())
+      return one_to_all(tit->second, s, limit, strategy, costs);
+    auto hit = _hierarchies.find(strategy);
+    if (hit != _hierarchies.end())
+      return one_to_all(hit->second, s, limit, strategy, costs);
+
+    typedef search_workspace<vertex_descriptor, weight_t> workspace_t;
+    workspace_t& ws = thread_search_workspace<vertex_descriptor, weight_t>();
+    weight_map_t weight_map = _profiles.get(strategy, _fg);
+    radius_dijkstra_stopping_criteria<
+      frozen_graph_t, workspace_t> visitor(ws, limit);
+    ws.reset(boost::num_vertices(_fg));
+    dijkstra_algorithm::search(_fg, s, ws, weight_map, visitor);
+    costs.assign(boost::num_vertices(_fg), 
+      std::numeric_limits<weight_t>::max());
+    for (vertex_descriptor v : ws.touched())
+      if (ws.distance(v) <= limit)
+        costs[v] = ws.distance(v);
+  }
+
+  template <typename HierarchyT>
+  void one_to_all(
+      const HierarchyT&      h,
+      vertex_descriptor      s,
+      weight_t               limit,
+      std::string            strategy,
+      std::vector<weight_t>& costs)
+  {
+    weight_map_t weight_map = _profiles.get(strategy, _fg);
+    stats_t stats;
+    phast_algorithm::compute(h, 
+      one_to_all_seeds(s, weight_map, typename HierarchyT::node_category()),
+      limit, thread_search_workspace<uint32_t, weight_t, phast_algorithm>(), 
+      costs, stats);
+    vertex_costs(s, costs, typename HierarchyT::node_category());
+  }
+
+  std::vector<std::pair<uint32_t, weight_t> > one_to_all_seeds(
+      vertex_descriptor      s,
+      weight_map_t&          /*weight_map*/,
+      vertex_based_hierarchy_tag) 
+  {
+    return std::vector<std::pair<uint32_t, weight_t> >(
+      1, std::make_pair(uint32_t(s), weight_t()));
+  }
+
+  // the out-edges of s, with their own weight
+  std::vector<std::pair<uint32_t, weight_t> > one_to_all_seeds(
+      vertex_descriptor      s,
+      weight_map_t&          weight_map,
+      edge_based_hierarchy_tag) 
+  {
+    std::vector<std::pair<uint32_t, weight_t> > seeds;
+    auto oer = boost::out_edges(s, _fg);
+    for (auto it = oer.first; it != oer.second; ++it)
+      seeds.push_back(std::make_pair(
+        uint32_t(_fg[*it].edge_index), get(weight_map, *it)));
+    return seeds;
+  }
+
+  void vertex_costs(
+      vertex_descriptor      /*s*/,
+      std::vector<weight_t>& /*costs*/,
+      vertex_based_hierarchy_tag) {}
+
+  // a vertex costs as its cheapest in-edge, the source nothing
+  void vertex_costs(
+      vertex_descriptor      s,
+      std::vector<weight_t>& costs,
+      edge_based_hierarchy_tag)
+  {
+    std::vector<weight_t> vcosts(
+      boost::num_vertices(_fg), std::numeric_limits<weight_t>::max());
+    for (edge_index_t idx = 0; idx < costs.size(); ++idx)
+    {
+      vertex_descriptor v = boost::target(edge_at(idx, _fg), _fg);
+      vcosts[v] = std::min(vcosts[v], costs[idx]);
+    }
+    vcosts[s] = weight_t();
+    costs.swap(vcosts);
+  }
+
+  // cells of the reached vertices and of the reached stretch of their
+  // out-edges; a stretch is measured from the vertex cost, turn costs
+  // aside
+  void isochrone_cells(
+      vertex_descriptor            s,
+      weight_t                     limit,
+      std::string                  strategy,
+      const std::vector<weight_t>& costs,
+      isochrone&                   iso)
+  {
+    weight_map_t weight_map = _profiles.get(strategy, _fg);
+    isochrone_grid grid(_fg[s].geo.lon, _fg[s].geo.lat, iso.cell_size);
+    for (vertex_descriptor u = 0; u < costs.size(); ++u)
+    {
+      if (costs[u] > limit)
+        continue;
+      grid.add(_fg[u].geo.lon, _fg[u].geo.lat, costs[u]);
+      auto oer = boost::out_edges(u, _fg);
+      for (auto it = oer.first; it != oer.second; ++it)
+      {
+        vertex_descriptor v = boost::target(*it, _fg);
+        grid.add_segment(
+          _fg[u].geo.lon, _fg[u].geo.lat, _fg[v].geo.lon, _fg[v].geo.lat,
+          costs[u], get(weight_map, *it), limit);
+      }
+    }
+    grid.fill(iso);
+  }
+
   // WARNING: use if stop identifiers aren't in user request  
   void search_near_stops(
     std::string source,
@@ -22,6 +22,7 @@
 //#include <boost/any.hpp>
 
 #include "graph_model_edge_weight.h"
+#include "graph_string_table.h"
 //#include "../data_extraction/OSM.h"
 #include "../data_extraction/sqlite/sqlite_database_helper.h"
 
@@ -66,15 +67,15 @@ class graph_builder
   ~graph_builder() {}
 
   virtual void add_node(
-    std::string   id,
+    osm_id_t      id,
     features_map& fmap, 
     double        lon, 
     double        lat,
     double        ele) = 0;
   
   virtual void add_section(
-    std::string   sid, 
-    std::string   tid, 
+    osm_id_t      sid, 
+    osm_id_t      tid, 
     features_map& fmap) = 0;
 
   virtual WeightT get_model_edge_weight(
@@ -89,32 +90,36 @@ class graph_builder
     return _model;
   }
 
-  bool is_vertex(std::string id) {
-    if (_vtxmap.find(id) != _vtxmap.end())
-      return true;
-    return false;
+  // index of the name in the string table of the graph
+  string_table::index_t intern_name(const std::string& name) {
+    return _g[boost::graph_bundle].names.intern(name);
+  }
+
+  bool is_vertex(osm_id_t id) {
+    return _vtxmap.contains(id);
   }       
 
   void create_network_junctions(
       std::vector<osm::node>& nds) 
   {
-    for (auto n : nds) {
+    for (auto& n : nds) {
       features_map fmap(n.tags);
-      this->add_node(std::to_string(n.id), fmap, n.lon, n.lat, n.ele);
+      this->add_node(n.id, fmap, n.lon, n.lat, n.ele);
     }
+    _vtxmap.sort();
   }
 
   void create_network_segments(
       std::vector<osm::way>& wys) 
   {
-    for (auto w : wys) {
+    for (auto& w : wys) {
       features_map fmap(w.tags);
       auto it = w.refs.begin(); 
       while (it != w.refs.end()) {
         long long int sid = (*it); // source
         it++;                      // target
         if (it != w.refs.end())        
-          this->add_section(std::to_string(sid), std::to_string((*it)), fmap);
+          this->add_section(sid, (*it), fmap);
       }
     } // end ways
 
@@ -148,7 +153,7 @@ class graph_builder
     out_edge_iterator oei, oei_end;
     for (auto restriction : trs)
     {      
-      auto vit = _vtxmap.find(std::to_string(restriction.via)); 
+      auto vit = _vtxmap.find(restriction.via); 
       if (vit == _vtxmap.end()) 
         continue;
 
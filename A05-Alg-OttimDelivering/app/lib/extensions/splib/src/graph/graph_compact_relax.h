@@ -57,7 +57,7 @@ bool compact_relax(
   const W& w_e     = get(w, outgoing_e);
   // represent the cost of turning from the i-th incoming arc into the j-th
   // outgoing arc at u
-  const W  w_turn  = (*(g[u].turn_table))[incoming_idx][outgoing_idx];
+  const W  w_turn  = g.turn_cost(u, incoming_idx, outgoing_idx);
 
   // The seemingly redundant comparisons after the distance puts are to
   // ensure that extra floating-point precision in x87 registers does not
@@ -0,0 +1,564 @@
+// This file is part of Sii-Mobility - Algorithms Optimized Delivering.
+//
+// Copyright (C) 2017 GOL Lab http://webgol.dinfo.unifi.it/ - University of Florence
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with This program.  If not, see <http://www.gnu.org/licenses/>.
+
+#ifndef GOL_GRAPH_COMPRESSED_SPARSE_ROW_H_
+#define GOL_GRAPH_COMPRESSED_SPARSE_ROW_H_
+
+// std
+#include <vector>
+#include <limits>
+#include <utility>
+#include <algorithm>
+#include <stdint.h>
+// boost
+#include <boost/graph/graph_traits.hpp>
+#include <boost/graph/properties.hpp>
+#include <boost/iterator/iterator_facade.hpp>
+#include <boost/iterator/counting_iterator.hpp>
+#include <boost/property_map/property_map.hpp>
+
+#include "../utility.h"
+#include "graph_flat_array.h"
+#include "graph_image.h"
+
+namespace gol {
+
+// Immutable compressed sparse row layout of a built road network.
+// Out-edges of vertex u are the contiguous slots
+// [out_offsets[u], out_offsets[u+1]) of the hot arrays (targets, weights,
+// turn table indexes); the slot is also the edge index used by arc-based
+// searches. Extra edge properties (highway, name) are kept in a separate
+// cold array read only when routes are reported.
+// Turn tables are flattened into one pool: the table of u is the
+// in_degree(u) x out_degree(u) row-major block at turn_offsets[u].
+// Every array is a flat_array, either built in memory or mapped from a
+// graph image.
+
+struct csr_edge_descriptor
+{
+  csr_edge_descriptor(): idx(std::numeric_limits<edge_index_t>::max()) {}
+  explicit csr_edge_descriptor(edge_index_t i): idx(i) {}
+
+  edge_index_t idx;
+
+  bool operator==(const csr_edge_descriptor& e) const { return idx == e.idx; }
+  bool operator!=(const csr_edge_descriptor& e) const { return idx != e.idx; }
+  bool operator< (const csr_edge_descriptor& e) const { return idx <  e.idx; }
+};
+
+// iterates a range of edge slots, directly (out-edges, all edges) or
+// through an indirection array (in-edges)
+class csr_edge_iterator:
+  public boost::iterator_facade<
+    csr_edge_iterator,
+    csr_edge_descriptor,
+    std::random_access_iterator_tag,
+    csr_edge_descriptor>
+{
+ public:
+  csr_edge_iterator(): _slots(nullptr), _pos(0) {}
+  csr_edge_iterator(const edge_index_t* slots, edge_index_t pos):
+      _slots(slots), _pos(pos) {}
+
+ private:
+  friend class boost::iterator_core_access;
+
+  csr_edge_descriptor dereference() const {
+    return csr_edge_descriptor(_slots ? _slots[_pos] : _pos); }
+  bool equal(const csr_edge_iterator& it) const {
+    return _pos == it._pos; }
+  void increment() { ++_pos; }
+  void decrement() { --_pos; }
+  void advance(std::ptrdiff_t n) { _pos += n; }
+  std::ptrdiff_t distance_to(const csr_edge_iterator& it) const {
+    return std::ptrdiff_t(it._pos) - std::ptrdiff_t(_pos); }
+
+  const edge_index_t* _slots;
+  edge_index_t        _pos;
+};
+
+struct csr_traversal_category:
+  public virtual boost::bidirectional_graph_tag,
+  public virtual boost::vertex_list_graph_tag,
+  public virtual boost::edge_list_graph_tag {};
+
+template <
+  typename VertexProperties,
+  typename ExtraEdgeProperties,
+  typename WeightT>
+class csr_graph_t
+{
+ public:
+  typedef uint32_t                           vertex_descriptor;
+  typedef csr_edge_descriptor                edge_descriptor;
+  typedef boost::counting_iterator<uint32_t> vertex_iterator;
+  typedef csr_edge_iterator                  out_edge_iterator;
+  typedef csr_edge_iterator                  in_edge_iterator;
+  typedef csr_edge_iterator                  edge_iterator;
+  typedef boost::bidirectional_tag           directed_category;
+  typedef boost::disallow_parallel_edge_tag  edge_parallel_category;
+  typedef csr_traversal_category             traversal_category;
+  typedef uint32_t                           vertices_size_type;
+  typedef uint32_t                           edges_size_type;
+  typedef uint32_t                           degree_size_type;
+
+  // view of an edge slot, gives the same g[e].field access
+  // of the adjacency_list bundled properties
+  struct edge_reference_t
+  {
+    edge_index_t               edge_index;
+    WeightT                    weight;
+    unsigned short int         entry_point;
+    unsigned short int         exit_point;
+    const ExtraEdgeProperties& properties;
+  };
+
+  csr_graph_t():
+      _out_offsets(1, 0),
+      _in_offsets(1, 0),
+      _targets(),
+      _sources(),
+      _in_slots(),
+      _weights(),
+      _entry_points(),
+      _exit_points(),
+      _turn_offsets(1, 0),
+      _turn_weights(),
+      _edge_properties(),
+      _vertex_properties() {}
+
+  static vertex_descriptor null_vertex() {
+    return std::numeric_limits<vertex_descriptor>::max(); }
+
+  // builds the layout from a graph with adjacency_list-like bundled
+  // properties, vertex numbering is preserved
+  template <typename GraphT>
+  void assign(const GraphT& g);
+
+  // writes the arrays as sections of a graph image
+  void save(graph_image_writer& w, std::string prefix) const;
+
+  // uses the sections of a mapped image in place
+  void map(const graph_image& img, std::string prefix);
+
+  void clear() {
+    *this = csr_graph_t();
+  }
+
+  const VertexProperties& operator[](vertex_descriptor v) const {
+    return _vertex_properties[v];
+  }
+
+  edge_reference_t operator[](edge_descriptor e) const {
+    return edge_reference_t{
+      e.idx,
+      _weights[e.idx],
+      _entry_points[e.idx],
+      _exit_points[e.idx],
+      _edge_properties[e.idx] };
+  }
+
+  vertex_descriptor source(edge_descriptor e) const {
+    return _sources[e.idx]; }
+  vertex_descriptor target(edge_descriptor e) const {
+    return _targets[e.idx]; }
+
+  uint32_t num_vertices() const {
+    return _vertex_properties.size(); }
+  uint32_t num_edges() const {
+    return _targets.size(); }
+
+  std::pair<out_edge_iterator, out_edge_iterator>
+  out_edges(vertex_descriptor u) const {
+    return std::make_pair(
+      out_edge_iterator(nullptr, _out_offsets[u]),
+      out_edge_iterator(nullptr, _out_offsets[u + 1]));
+  }
+
+  std::pair<in_edge_iterator, in_edge_iterator>
+  in_edges(vertex_descriptor u) const {
+    return std::make_pair(
+      in_edge_iterator(_in_slots.data(), _in_offsets[u]),
+      in_edge_iterator(_in_slots.data(), _in_offsets[u + 1]));
+  }
+
+  std::pair<edge_iterator, edge_iterator> edges() const {
+    return std::make_pair(
+      edge_iterator(nullptr, 0),
+      edge_iterator(nullptr, num_edges()));
+  }
+
+  uint32_t out_degree(vertex_descriptor u) const {
+    return _out_offsets[u + 1] - _out_offsets[u]; }
+  uint32_t in_degree(vertex_descriptor u) const {
+    return _in_offsets[u + 1] - _in_offsets[u]; }
+
+  // out-edges are sorted by target, binary search
+  std::pair<edge_descriptor, bool>
+  edge(vertex_descriptor u, vertex_descriptor v) const
+  {
+    auto first = _targets.begin() + _out_offsets[u];
+    auto last  = _targets.begin() + _out_offsets[u + 1];
+    auto it    = std::lower_bound(first, last, v);
+    if (it != last && *it == v)
+      return std::make_pair(
+        edge_descriptor(it - _targets.begin()), true);
+    return std::make_pair(edge_descriptor(), false);
+  }
+
+  // model weights indexed by edge slot
+  const WeightT* weights() const {
+    return _weights.data(); }
+
+  // cost of turning from the i-th incoming into the j-th outgoing 
+  // edge at u, see entry_point and exit_point
+  WeightT turn_cost(vertex_descriptor u, 
+                    unsigned short int i, 
+                    unsigned short int j) const {
+    return _turn_weights[_turn_offsets[u] + i * out_degree(u) + j]; }
+
+  bool has_turn_table(vertex_descriptor u) const {
+    return _turn_offsets[u + 1] != _turn_offsets[u]; }
+
+  size_t memory_usage() const;
+
+ private:
+  // hot arrays
+  flat_array<uint32_t>            _out_offsets;       // |V| + 1
+  flat_array<uint32_t>            _in_offsets;        // |V| + 1
+  flat_array<vertex_descriptor>   _targets;           // |E|
+  flat_array<vertex_descriptor>   _sources;           // |E|
+  flat_array<edge_index_t>        _in_slots;          // |E|
+  flat_array<WeightT>             _weights;           // |E|
+  flat_array<unsigned short int>  _entry_points;      // |E|
+  flat_array<unsigned short int>  _exit_points;       // |E|
+  flat_array<uint32_t>            _turn_offsets;      // |V| + 1
+  flat_array<WeightT>             _turn_weights;      // sum in x out degree
+  // cold arrays
+  flat_array<ExtraEdgeProperties> _edge_properties;   // |E|
+  flat_array<VertexProperties>    _vertex_properties; // |V|
+
+};
+
+template <
+  typename VertexProperties,
+  typename ExtraEdgeProperties,
+  typename WeightT>
+template <typename GraphT>
+void csr_graph_t<
+    VertexProperties,
+    ExtraEdgeProperties,
+    WeightT
+>::assign(const GraphT& g)
+{
+  typedef boost::graph_traits<GraphT>        Traits;
+  typedef typename Traits::vertex_iterator   vertex_iterator_t;
+  typedef typename Traits::out_edge_iterator out_edge_iterator_t;
+  typedef typename Traits::edge_descriptor   edge_descriptor_t;
+
+  const uint32_t n = boost::num_vertices(g);
+  const uint32_t m = boost::num_edges(g);
+
+  std::vector<uint32_t>            out_offsets(n + 1, 0);
+  std::vector<uint32_t>            in_offsets(n + 1, 0);
+  std::vector<vertex_descriptor>   targets;
+  std::vector<vertex_descriptor>   sources;
+  std::vector<WeightT>             weights;
+  std::vector<unsigned short int>  entry_points;
+  std::vector<unsigned short int>  exit_points;
+  std::vector<uint32_t>            turn_offsets(n + 1, 0);
+  std::vector<WeightT>             turn_weights;
+  std::vector<ExtraEdgeProperties> edge_properties;
+  std::vector<VertexProperties>    vertex_properties;
+  targets.reserve(m);
+  sources.reserve(m);
+  weights.reserve(m);
+  entry_points.reserve(m);
+  exit_points.reserve(m);
+  edge_properties.reserve(m);
+  vertex_properties.reserve(n);
+
+  std::vector<edge_descriptor_t> oedges;
+  vertex_iterator_t vi, vi_end;
+  for (boost::tie(vi, vi_end) = boost::vertices(g); vi != vi_end; ++vi)
+  {
+    vertex_descriptor u = *vi;
+    vertex_properties.push_back(VertexProperties(g[*vi]));
+
+    oedges.clear();
+    out_edge_iterator_t oei, oei_end;
+    for (boost::tie(oei, oei_end) = boost::out_edges(*vi, g);
+           oei != oei_end; ++oei)
+      oedges.push_back(*oei);
+    std::sort(oedges.begin(), oedges.end(),
+      [&g](const edge_descriptor_t& a, const edge_descriptor_t& b) {
+        return boost::target(a, g) < boost::target(b, g); });
+
+    for (auto e : oedges)
+    {
+      vertex_descriptor v = boost::target(e, g);
+      targets.push_back(v);
+      sources.push_back(u);
+      weights.push_back(g[e].weight);
+      entry_points.push_back(g[e].entry_point);
+      exit_points.push_back(g[e].exit_point);
+      edge_properties.push_back(g[e].properties);
+      ++in_offsets[v + 1];
+    }
+    out_offsets[u + 1] = targets.size();
+
+    // p x q turn table, q is the out-degree of u
+    if (g[*vi].turn_table)
+    {
+      const auto& tt = *(g[*vi].turn_table);
+      for (size_t i = 0; i < tt.shape()[0]; ++i)
+        for (size_t j = 0; j < tt.shape()[1]; ++j)
+          turn_weights.push_back(tt[i][j]);
+    }
+    turn_offsets[u + 1] = turn_weights.size();
+  }
+
+  for (uint32_t v = 0; v < n; ++v)
+    in_offsets[v + 1] += in_offsets[v];
+
+  // in-edges refer the forward slot, ordered by source
+  std::vector<edge_index_t> in_slots(m);
+  std::vector<uint32_t> fill(in_offsets.begin(), in_offsets.end() - 1);
+  for (edge_index_t i = 0; i < m; ++i)
+    in_slots[fill[targets[i]]++] = i;
+
+  _out_offsets       = flat_array<uint32_t>(std::move(out_offsets));
+  _in_offsets        = flat_array<uint32_t>(std::move(in_offsets));
+  _targets           = flat_array<vertex_descriptor>(std::move(targets));
+  _sources           = flat_array<vertex_descriptor>(std::move(sources));
+  _in_slots          = flat_array<edge_index_t>(std::move(in_slots));
+  _weights           = flat_array<WeightT>(std::move(weights));
+  _entry_points      = flat_array<unsigned short int>(std::move(entry_points));
+  _exit_points       = flat_array<unsigned short int>(std::move(exit_points));
+  _turn_offsets      = flat_array<uint32_t>(std::move(turn_offsets));
+  _turn_weights      = flat_array<WeightT>(std::move(turn_weights));
+  _edge_properties   = flat_array<ExtraEdgeProperties>(std::move(edge_properties));
+  _vertex_properties = flat_array<VertexProperties>(std::move(vertex_properties));
+}
+
+template <
+  typename VertexProperties,
+  typename ExtraEdgeProperties,
+  typename WeightT>
+void csr_graph_t<
+    VertexProperties,
+    ExtraEdgeProperties,
+    WeightT
+>::save(graph_image_writer& w, std::string prefix) const
+{
+  w.add(prefix + ".out_offsets",       _out_offsets);
+  w.add(prefix + ".in_offsets",        _in_offsets);
+  w.add(prefix + ".targets",           _targets);
+  w.add(prefix + ".sources",           _sources);
+  w.add(prefix + ".in_slots",          _in_slots);
+  w.add(prefix + ".weights",           _weights);
+  w.add(prefix + ".entry_points",      _entry_points);
+  w.add(prefix + ".exit_points",       _exit_points);
+  w.add(prefix + ".turn_offsets",      _turn_offsets);
+  w.add(prefix + ".turn_weights",      _turn_weights);
+  w.add(prefix + ".edge_properties",   _edge_properties);
+  w.add(prefix + ".vertex_properties", _vertex_properties);
+}
+
+template <
+  typename VertexProperties,
+  typename ExtraEdgeProperties,
+  typename WeightT>
+void csr_graph_t<
+    VertexProperties,
+    ExtraEdgeProperties,
+    WeightT
+>::map(const graph_image& img, std::string prefix)
+{
+  csr_graph_t fg;
+  fg._out_offsets       = img.section<uint32_t>(prefix + ".out_offsets");
+  fg._in_offsets        = img.section<uint32_t>(prefix + ".in_offsets");
+  fg._targets           = img.section<vertex_descriptor>(prefix + ".targets");
+  fg._sources           = img.section<vertex_descriptor>(prefix + ".sources");
+  fg._in_slots          = img.section<edge_index_t>(prefix + ".in_slots");
+  fg._weights           = img.section<WeightT>(prefix + ".weights");
+  fg._entry_points      = img.section<unsigned short int>(prefix + ".entry_points");
+  fg._exit_points       = img.section<unsigned short int>(prefix + ".exit_points");
+  fg._turn_offsets      = img.section<uint32_t>(prefix + ".turn_offsets");
+  fg._turn_weights      = img.section<WeightT>(prefix + ".turn_weights");
+  fg._edge_properties   = img.section<ExtraEdgeProperties>(prefix + ".edge_properties");
+  fg._vertex_properties = img.section<VertexProperties>(prefix + ".vertex_properties");
+
+  const size_t n = fg._vertex_properties.size();
+  const size_t m = fg._targets.size();
+  if (fg._out_offsets.size()  != n + 1 || fg._in_offsets.size() != n + 1 ||
+      fg._turn_offsets.size() != n + 1 ||
+      fg._sources.size()  != m || fg._in_slots.size()     != m ||
+      fg._weights.size()  != m || fg._entry_points.size() != m ||
+      fg._exit_points.size() != m || fg._edge_properties.size() != m ||
+      fg._out_offsets[n]  != m || fg._in_offsets[n] != m ||
+      fg._turn_offsets[n] != fg._turn_weights.size())
+    throw data_exception("csr_graph_t::map(): inconsistent image " + prefix);
+
+  *this = std::move(fg);
+}
+
+template <
+  typename VertexProperties,
+  typename ExtraEdgeProperties,
+  typename WeightT>
+size_t csr_graph_t<
+    VertexProperties,
+    ExtraEdgeProperties,
+    WeightT
+>::memory_usage() const
+{
+  return
+    _out_offsets.memory_usage()  + _in_offsets.memory_usage()   +
+    _targets.memory_usage()      + _sources.memory_usage()      +
+    _in_slots.memory_usage()     + _weights.memory_usage()      +
+    _entry_points.memory_usage() + _exit_points.memory_usage()  +
+    _turn_offsets.memory_usage() + _turn_weights.memory_usage() +
+    _edge_properties.memory_usage() + 
+    _vertex_properties.memory_usage();
+}
+
+// BGL interface
+
+
+template <typename VP, typename EP, typename W>
+inline typename csr_graph_t<VP, EP, W>::vertex_descriptor
+source(csr_edge_descriptor e, const csr_graph_t<VP, EP, W>& g) {
+  return g.source(e); }
+
+template <typename VP, typename EP, typename W>
+inline typename csr_graph_t<VP, EP, W>::vertex_descriptor
+target(csr_edge_descriptor e, const csr_graph_t<VP, EP, W>& g) {
+  return g.target(e); }
+
+template <typename VP, typename EP, typename W>
+inline std::pair<csr_edge_iterator, csr_edge_iterator>
+out_edges(uint32_t u, const csr_graph_t<VP, EP, W>& g) {
+  return g.out_edges(u); }
+
+template <typename VP, typename EP, typename W>
+inline std::pair<csr_edge_iterator, csr_edge_iterator>
+in_edges(uint32_t u, const csr_graph_t<VP, EP, W>& g) {
+  return g.in_edges(u); }
+
+template <typename VP, typename EP, typename W>
+inline uint32_t out_degree(uint32_t u, const csr_graph_t<VP, EP, W>& g) {
+  return g.out_degree(u); }
+
+template <typename VP, typename EP, typename W>
+inline uint32_t in_degree(uint32_t u, const csr_graph_t<VP, EP, W>& g) {
+  return g.in_degree(u); }
+
+template <typename VP, typename EP, typename W>
+inline uint32_t degree(uint32_t u, const csr_graph_t<VP, EP, W>& g) {
+  return g.out_degree(u) + g.in_degree(u); }
+
+template <typename VP, typename EP, typename W>
+inline std::pair<
+  boost::counting_iterator<uint32_t>,
+  boost::counting_iterator<uint32_t> >
+vertices(const csr_graph_t<VP, EP, W>& g) {
+  return std::make_pair(
+    boost::counting_iterator<uint32_t>(0),
+    boost::counting_iterator<uint32_t>(g.num_vertices())); }
+
+template <typename VP, typename EP, typename W>
+inline uint32_t num_vertices(const csr_graph_t<VP, EP, W>& g) {
+  return g.num_vertices(); }
+
+template <typename VP, typename EP, typename W>
+inline std::pair<csr_edge_iterator, csr_edge_iterator>
+edges(const csr_graph_t<VP, EP, W>& g) {
+  return g.edges(); }
+
+template <typename VP, typename EP, typename W>
+inline uint32_t num_edges(const csr_graph_t<VP, EP, W>& g) {
+  return g.num_edges(); }
+
+template <typename VP, typename EP, typename W>
+inline std::pair<csr_edge_descriptor, bool>
+edge(uint32_t u, uint32_t v, const csr_graph_t<VP, EP, W>& g) {
+  return g.edge(u, v); }
+
+// edge from its slot, inverse of the edge index map
+template <typename VP, typename EP, typename W>
+inline csr_edge_descriptor
+edge_at(edge_index_t idx, const csr_graph_t<VP, EP, W>& /*g*/) {
+  return csr_edge_descriptor(idx); }
+
+struct csr_edge_index_map:
+  public boost::put_get_helper<edge_index_t, csr_edge_index_map>
+{
+  typedef csr_edge_descriptor              key_type;
+  typedef edge_index_t                     value_type;
+  typedef edge_index_t                     reference;
+  typedef boost::readable_property_map_tag category;
+
+  reference operator[](const key_type& e) const {
+    return e.idx; }
+};
+
+} // namespace gol
+
+namespace boost {
+
+// qualified boost:: calls in solvers and algorithms
+using gol::source;
+using gol::target;
+using gol::out_edges;
+using gol::in_edges;
+using gol::out_degree;
+using gol::in_degree;
+using gol::degree;
+using gol::vertices;
+using gol::num_vertices;
+using gol::edges;
+using gol::num_edges;
+using gol::edge;
+
+template <typename VP, typename EP, typename W>
+inline typed_identity_property_map<uint32_t>
+get(vertex_index_t, const gol::csr_graph_t<VP, EP, W>& /*g*/) {
+  return typed_identity_property_map<uint32_t>(); }
+
+template <typename VP, typename EP, typename W>
+inline gol::csr_edge_index_map
+get(edge_index_t, const gol::csr_graph_t<VP, EP, W>& /*g*/) {
+  return gol::csr_edge_index_map(); }
+
+template <typename VP, typename EP, typename W>
+struct property_map<gol::csr_graph_t<VP, EP, W>, vertex_index_t>
+{
+  typedef typed_identity_property_map<uint32_t> type;
+  typedef type                                  const_type;
+};
+
+template <typename VP, typename EP, typename W>
+struct property_map<gol::csr_graph_t<VP, EP, W>, edge_index_t>
+{
+  typedef gol::csr_edge_index_map type;
+  typedef type                    const_type;
+};
+
+} // namespace boost
+
+#endif // GOL_GRAPH_COMPRESSED_SPARSE_ROW_H_
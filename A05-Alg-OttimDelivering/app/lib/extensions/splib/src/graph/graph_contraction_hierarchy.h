@@ -0,0 +1,321 @@
+// This file is part of Sii-Mobility - Algorithms Optimized Delivering.
+//
+// Copyright (C) 2017 GOL Lab http://webgol.dinfo.unifi.it/ - University of Florence
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with This program.  If not, see <http://www.gnu.org/licenses/>.
+
+#ifndef GOL_GRAPH_CONTRACTION_HIERARCHY_H_
+#define GOL_GRAPH_CONTRACTION_HIERARCHY_H_
+
+// std
+#include <vector>
+#include <limits>
+#include <utility>
+#include <type_traits>
+#include <stdint.h>
+// boost
+#include <boost/graph/graph_traits.hpp>
+
+#include "../exception.h"
+#include "graph_flat_array.h"
+#include "graph_image.h"
+
+namespace gol {
+
+// Contraction Hierarchy of a frozen graph for one weight profile.
+// Nodes are ranked by contraction order, every arc leads from a lower
+// to a higher ranked node or the other way round and shortcuts stand
+// for the two arcs they bypass. A query is a bidirectional search on
+// the upward arcs only, see contraction_hierarchy_algorithm.
+//
+// Nodes are the vertices of the base graph, or its edge slots for an
+// edge-based hierarchy: there arcs are the turns allowed by the turn
+// tables, weighted by the edge turned into plus the turn cost. Arcs of
+// the input graph keep the edge slot of the base graph they stand for
+// (the edge turned into, if edge-based), shortcuts keep the indexes of
+// their two halves.
+
+struct vertex_based_hierarchy_tag {};
+struct edge_based_hierarchy_tag {};
+
+template <typename WeightT>
+struct hierarchy_arc_t
+{
+  static const uint32_t none = std::numeric_limits<uint32_t>::max();
+
+  uint32_t tail;
+  uint32_t head;
+  uint32_t first;   // first half, or base edge slot
+  uint32_t second;  // second half, none for input arcs
+  WeightT  weight;
+
+  bool is_shortcut() const { return second != none; }
+};
+
+template <
+  typename GraphT, 
+  typename WeightT, 
+  typename NodeTag = vertex_based_hierarchy_tag>
+class contraction_hierarchy_t
+{
+ public:
+  typedef NodeTag                                  node_category;
+  typedef hierarchy_arc_t<WeightT>                 arc_t;
+  typedef uint32_t                                 arc_index_t;
+  typedef std::pair<
+    const arc_index_t*, const arc_index_t*>        arc_range;
+
+  // graph traits, the hierarchy is handed to the solvers in place of
+  // the base graph: vertices and reported edges are the base ones
+  typedef typename GraphT::vertex_descriptor       vertex_descriptor;
+  typedef typename GraphT::edge_descriptor         edge_descriptor;
+  typedef boost::directed_tag                      directed_category;
+  typedef boost::allow_parallel_edge_tag           edge_parallel_category;
+  typedef boost::incidence_graph_tag               traversal_category;
+
+  contraction_hierarchy_t():
+      _g(nullptr),
+      _up_offsets(1, 0),
+      _up_arcs(),
+      _down_offsets(1, 0),
+      _down_arcs(),
+      _arcs(),
+      _order() {}
+
+  static vertex_descriptor null_vertex() {
+    return GraphT::null_vertex(); }
+
+  // base graph the hierarchy was contracted from, to be bound again
+  // whenever the base graph moves
+  void bind(const GraphT& g) { _g = &g; }
+  const GraphT& base() const { return *_g; }
+
+  auto operator[](vertex_descriptor v) const -> decltype(std::declval<const GraphT&>()[v]) {
+    return (*_g)[v]; }
+  auto operator[](edge_descriptor e) const -> decltype(std::declval<const GraphT&>()[e]) {
+    return (*_g)[e]; }
+
+  uint32_t num_nodes() const {
+    return _up_offsets.size() - 1; }
+  uint32_t num_arcs() const {
+    return _arcs.size(); }
+
+  // arcs from u to higher ranked nodes, scanned by forward searches
+  arc_range up_arcs(uint32_t u) const {
+    return std::make_pair(
+      _up_arcs.data() + _up_offsets[u],
+      _up_arcs.data() + _up_offsets[u + 1]);
+  }
+
+  // arcs to u from higher ranked nodes, scanned by backward searches
+  arc_range down_arcs(uint32_t u) const {
+    return std::make_pair(
+      _down_arcs.data() + _down_offsets[u],
+      _down_arcs.data() + _down_offsets[u + 1]);
+  }
+
+  const arc_t& arc(arc_index_t a) const { return _arcs[a]; }
+
+  // nodes by descending rank: the tail of every down arc comes before
+  // its head, the order of a PHAST sweep
+  const flat_array<uint32_t>& sweep_order() const { return _order; }
+
+  // appends the input arcs a stands for, in path order
+  template <typename OutputIterator>
+  void unpack(arc_index_t a, OutputIterator out) const
+  {
+    std::vector<arc_index_t> stack(1, a);
+    while (!stack.empty())
+    {
+      const arc_t& x = _arcs[stack.back()];
+      stack.pop_back();
+      if (x.is_shortcut()) {
+        stack.push_back(x.second);
+        stack.push_back(x.first);
+      } else
+        *out++ = x.first;
+    }
+  }
+
+  // a metric of the base edge slots summed over the input arcs every
+  // arc stands for, e.g. the length of a shortcut; shortcuts come after
+  // their halves
+  template <typename MetricT>
+  std::vector<MetricT> arc_metric(const MetricT* edge_metric) const
+  {
+    std::vector<MetricT> m(_arcs.size());
+    for (arc_index_t a = 0; a < _arcs.size(); ++a)
+      m[a] = _arcs[a].is_shortcut() ?
+        m[_arcs[a].first] + m[_arcs[a].second] : edge_metric[_arcs[a].first];
+    return m;
+  }
+
+  // lists are indexed by node, built by node_contraction
+  void assign(
+      std::vector<arc_t>                     arcs,
+      const std::vector<
+        std::vector<arc_index_t> >&          up,
+      const std::vector<
+        std::vector<arc_index_t> >&          down)
+  {
+    _up_offsets   = flat_array<uint32_t>(offsets(up));
+    _up_arcs      = flat_array<arc_index_t>(concat(up));
+    _down_offsets = flat_array<uint32_t>(offsets(down));
+    _down_arcs    = flat_array<arc_index_t>(concat(down));
+    _arcs         = flat_array<arc_t>(std::move(arcs));
+    _order        = flat_array<uint32_t>(ranked_order());
+  }
+
+  void save(graph_image_writer& w, std::string prefix) const
+  {
+    w.add(prefix + ".up_offsets",   _up_offsets);
+    w.add(prefix + ".up_arcs",      _up_arcs);
+    w.add(prefix + ".down_offsets", _down_offsets);
+    w.add(prefix + ".down_arcs",    _down_arcs);
+    w.add(prefix + ".arcs",         _arcs);
+    w.add(prefix + ".order",        _order);
+  }
+
+  void map(const graph_image& img, std::string prefix)
+  {
+    contraction_hierarchy_t h;
+    h._up_offsets   = img.section<uint32_t>(prefix + ".up_offsets");
+    h._up_arcs      = img.section<arc_index_t>(prefix + ".up_arcs");
+    h._down_offsets = img.section<uint32_t>(prefix + ".down_offsets");
+    h._down_arcs    = img.section<arc_index_t>(prefix + ".down_arcs");
+    h._arcs         = img.section<arc_t>(prefix + ".arcs");
+    h._order        = img.section<uint32_t>(prefix + ".order");
+    const size_t n = h._up_offsets.size() - 1;
+    if (h._up_offsets.empty() || h._down_offsets.size() != n + 1 ||
+        h._up_offsets[n]   != h._up_arcs.size() ||
+        h._down_offsets[n] != h._down_arcs.size() ||
+        h._order.size()    != n)
+      throw data_exception(
+        "contraction_hierarchy_t::map(): inconsistent image " + prefix);
+    h._g = _g;
+    *this = std::move(h);
+  }
+
+  size_t memory_usage() const
+  {
+    return
+      _up_offsets.memory_usage()   + _up_arcs.memory_usage()   +
+      _down_offsets.memory_usage() + _down_arcs.memory_usage() +
+      _arcs.memory_usage()         + _order.memory_usage();
+  }
+
+ private:
+  // computed once contracted, the rank is not kept: nodes with no
+  // higher neighbour come first, then every node once all its higher
+  // neighbours did (Kahn)
+  std::vector<uint32_t> ranked_order() const
+  {
+    const uint32_t n = num_nodes();
+    std::vector<uint32_t> higher(n, 0);
+    std::vector<std::vector<uint32_t> > lower(n);
+    for (uint32_t u = 0; u < n; ++u)
+    {
+      higher[u] = (_up_offsets[u + 1] - _up_offsets[u]) + 
+        (_down_offsets[u + 1] - _down_offsets[u]);
+      for (arc_range r = up_arcs(u); r.first != r.second; ++r.first)
+        lower[_arcs[*r.first].head].push_back(u);
+      for (arc_range r = down_arcs(u); r.first != r.second; ++r.first)
+        lower[_arcs[*r.first].tail].push_back(u);
+    }
+    std::vector<uint32_t> order;
+    order.reserve(n);
+    for (uint32_t u = 0; u < n; ++u)
+      if (higher[u] == 0)
+        order.push_back(u);
+    for (size_t i = 0; i < order.size(); ++i)
+      for (uint32_t v : lower[order[i]])
+        if (--higher[v] == 0)
+          order.push_back(v);
+    return order;
+  }
+
+  static std::vector<uint32_t> offsets(
+      const std::vector<std::vector<arc_index_t> >& lists)
+  {
+    std::vector<uint32_t> o(1, 0);
+    o.reserve(lists.size() + 1);
+    for (auto& l : lists)
+      o.push_back(o.back() + l.size());
+    return o;
+  }
+
+  static std::vector<arc_index_t> concat(
+      const std::vector<std::vector<arc_index_t> >& lists)
+  {
+    std::vector<arc_index_t> c;
+    for (auto& l : lists)
+      c.insert(c.end(), l.begin(), l.end());
+    return c;
+  }
+
+  const GraphT*             _g;
+  flat_array<uint32_t>      _up_offsets;    // |V| + 1
+  flat_array<arc_index_t>   _up_arcs;
+  flat_array<uint32_t>      _down_offsets;  // |V| + 1
+  flat_array<arc_index_t>   _down_arcs;
+  flat_array<arc_t>         _arcs;
+  flat_array<uint32_t>      _order;         // by descending rank
+
+};
+
+template <typename T>
+struct is_contraction_hierarchy: std::false_type {};
+
+template <typename GraphT, typename WeightT, typename NodeTag>
+struct is_contraction_hierarchy<
+  contraction_hierarchy_t<GraphT, WeightT, NodeTag> >: std::true_type {};
+
+template <typename T>
+struct is_edge_based_hierarchy: std::false_type {};
+
+template <typename GraphT, typename WeightT>
+struct is_edge_based_hierarchy<
+  contraction_hierarchy_t<
+    GraphT, WeightT, edge_based_hierarchy_tag> >: std::true_type {};
+
+// BGL interface, edges are the base graph ones
+
+template <typename GraphT, typename WeightT, typename NodeTag>
+inline typename GraphT::vertex_descriptor
+source(typename GraphT::edge_descriptor e,
+       const contraction_hierarchy_t<GraphT, WeightT, NodeTag>& h) {
+  return source(e, h.base()); }
+
+template <typename GraphT, typename WeightT, typename NodeTag>
+inline typename GraphT::vertex_descriptor
+target(typename GraphT::edge_descriptor e,
+       const contraction_hierarchy_t<GraphT, WeightT, NodeTag>& h) {
+  return target(e, h.base()); }
+
+template <typename GraphT, typename WeightT, typename NodeTag>
+inline uint32_t num_vertices(
+    const contraction_hierarchy_t<GraphT, WeightT, NodeTag>& h) {
+  return num_vertices(h.base()); }
+
+} // namespace gol
+
+namespace boost {
+
+using gol::source;
+using gol::target;
+using gol::num_vertices;
+
+} // namespace boost
+
+#endif // GOL_GRAPH_CONTRACTION_HIERARCHY_H_
@@ -53,41 +53,6 @@ struct bicriteria_pareto_dominance {
   }
 };
 
-// MultiLabel Sets
-
-template <typename PairWeightT>
-struct bicriteria_ord {
-  bool operator()(const PairWeightT& a, const PairWeightT& b) const {
-    return (a.first < b.first);
-  }
-};
-
-template <typename WeightT> // LabelSet
-std::set<WeightT, bicriteria_ord<WeightT> > 
-      operator+(const std::set<WeightT, bicriteria_ord<WeightT> >& G, const WeightT& H) 
-{
-  typedef std::set<WeightT, bicriteria_ord<WeightT> > LabelSet;
-  LabelSet F;
-  for(typename LabelSet::const_iterator it = G.begin(); it != G.end(); ++it) 
-  {
-    F.insert((*it) + H); // TODO: check overflow
-  }
-  return F;
-}
-
-template <typename WeightT> // HeuristicEvaluetion
-struct bicriteria_heuristic_evaluation_ord {
-  bool operator()(const std::pair<unsigned int, WeightT>& a, const std::pair<unsigned int, WeightT>& b) const {
-    return 
-      (a.second.first < b.second.first)       || // first weight
-      (a.second.first == b.second.first && 
-        a.second.second < b.second.second)    || // second weight
-      (a.second.first == b.second.first && 
-        a.second.second == b.second.second && 
-          a.first < b.first);                    // open[] id
-  }
-};
-
 // Weight Dump
 
 template <typename WeightFT, typename WeightST>
@@ -96,14 +61,6 @@ std::ostream& operator<<(std::ostream& o, const std::pair<WeightFT, WeightST>& a
   return o;
 }
 
-template <typename WeightT>
-std::ostream& operator<<(std::ostream& o, const std::set<WeightT, bicriteria_ord<WeightT> >& a) {
-  typedef std::set<WeightT, bicriteria_ord<WeightT> > LabelSet;
-  for(typename LabelSet::const_iterator ii = a.begin(); ii != a.end(); ++ii)
-    o << *ii << " ";
-  return o;
-}
-
 
 } // namespace gol
 
@@ -0,0 +1,128 @@
+// This file is part of Sii-Mobility - Algorithms Optimized Delivering.
+//
+// Copyright (C) 2017 GOL Lab http://webgol.dinfo.unifi.it/ - University of Florence
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with This program.  If not, see <http://www.gnu.org/licenses/>.
+
+#ifndef GOL_GRAPH_FLAT_ARRAY_H_
+#define GOL_GRAPH_FLAT_ARRAY_H_
+
+// std
+#include <vector>
+#include <utility>
+
+namespace gol {
+
+// Read-only array either owning its elements, when a model is built,
+// or viewing a section of a mapped graph image. Mapped arrays are never
+// written, the owner of the mapping must outlive the views.
+template <typename T>
+class flat_array
+{
+ public:
+  typedef T        value_type;
+  typedef const T* const_iterator;
+
+  flat_array(): _owned(), _data(nullptr), _size(0) {}
+
+  explicit flat_array(std::vector<T>&& v):
+      _owned(std::move(v)),
+      _data(_owned.data()),
+      _size(_owned.size()) {}
+
+  flat_array(size_t n, const T& value):
+      _owned(n, value),
+      _data(_owned.data()),
+      _size(_owned.size()) {}
+
+  flat_array(const flat_array& other):
+      _owned(other._owned),
+      _data(other.mapped() ? other._data : _owned.data()),
+      _size(other._size) {}
+
+  flat_array(flat_array&& other):
+      _owned(),
+      _data(nullptr),
+      _size(0) { swap(other); }
+
+  flat_array& operator=(flat_array other) {
+    swap(other);
+    return *this;
+  }
+
+  void swap(flat_array& other)
+  {
+    // a vector swap keeps the element buffers, owned views stay valid
+    bool mine = !mapped(), theirs = !other.mapped();
+    _owned.swap(other._owned);
+    std::swap(_data, other._data);
+    std::swap(_size, other._size);
+    if (mine)   other._data = other._owned.data();
+    if (theirs) _data = _owned.data();
+  }
+
+  // view of n elements owned by someone else
+  static flat_array view(const T* data, size_t n)
+  {
+    flat_array a;
+    a._data = data;
+    a._size = n;
+    return a;
+  }
+
+  bool mapped() const {
+    return _data != nullptr && _data != _owned.data(); }
+
+  // build-time append, not allowed on a mapped array
+  void push_back(const T& value)
+  {
+    _owned.push_back(value);
+    _data = _owned.data();
+    _size = _owned.size();
+  }
+
+  template <typename InputIt>
+  void append(InputIt first, InputIt last)
+  {
+    _owned.insert(_owned.end(), first, last);
+    _data = _owned.data();
+    _size = _owned.size();
+  }
+
+  void clear() {
+    *this = flat_array();
+  }
+
+  const T& operator[](size_t i) const { return _data[i]; }
+  const T* data() const { return _data; }
+  size_t   size() const { return _size; }
+  bool     empty() const { return _size == 0; }
+
+  const_iterator begin() const { return _data; }
+  const_iterator end()   const { return _data + _size; }
+
+  // heap bytes, pages of a mapped array are owned by the kernel
+  size_t memory_usage() const {
+    return sizeof(T) * _owned.capacity(); }
+
+ private:
+  std::vector<T> _owned;
+  const T*       _data;
+  size_t         _size;
+
+};
+
+} // namespace gol
+
+#endif // GOL_GRAPH_FLAT_ARRAY_H_
@@ -19,6 +19,7 @@
 #define GOL_GRAPH_HEURISTIC_H_
 
 #include "../common.h"
+#include "graph_search_workspace.h"
 //#include "generic_edge_weighted_graph.h" 
 
 namespace gol {
@@ -55,6 +56,85 @@ class null_heuristic : public heuristic<BiGraphT, BiWeightT> {
   BiWeightT operator()(vertex_descriptor) const { return std::make_pair(0, 0); }
 };
 
+// Lower bounds from a vertex to t of each criterion, the distances of
+// single-criterion Dijkstras from t on the reverse graph: their pair
+// is admissible for the bicriterion search. The searches stay within 
+// region, its vertices which do not reach t there are erased from it.
+template <typename BiGraphT, typename BiWeightT>
+class bicriterion_bound_heuristic : public heuristic<BiGraphT, BiWeightT> {
+  typedef boost::graph_traits<BiGraphT>      Traits;
+  typedef typename Traits::edge_descriptor   edge_descriptor;
+  typedef typename BiWeightT::first_type     first_type;
+  typedef typename BiWeightT::second_type    second_type;
+ public:
+  typedef typename Traits::vertex_descriptor vertex_descriptor;
+
+  template <typename WeightMap, typename Region>
+  bicriterion_bound_heuristic(
+      const BiGraphT&   g, 
+      vertex_descriptor t, 
+      const WeightMap&  weight_map, 
+      Region&           region): 
+      heuristic<BiGraphT, BiWeightT>(),
+      _bound(boost::num_vertices(g)) 
+  {
+    // the criteria may share a workspace, one search at a time
+    auto& first = thread_search_workspace<
+      uint32_t, first_type, bicriterion_bound_heuristic>();
+    search(g, t, region, first, 
+      [&](edge_descriptor e) { return get(weight_map, e).first; });
+    for (uint32_t v = 0; v < _bound.size(); ++v)
+      if (!first.reached(v))
+        region.erase(v);
+      else
+        _bound[v].first = first.distance(v);
+    
+    auto& second = thread_search_workspace<
+      uint32_t, second_type, bicriterion_bound_heuristic>();
+    search(g, t, region, second, 
+      [&](edge_descriptor e) { return get(weight_map, e).second; });
+    for (uint32_t v = 0; v < _bound.size(); ++v)
+      if (second.reached(v))
+        _bound[v].second = second.distance(v);
+  }
+
+  BiWeightT operator()(vertex_descriptor u) const { return _bound[u]; }
+
+ private:
+  template <typename Region, typename Workspace, typename Cost>
+  static void search(
+      const BiGraphT&   g, 
+      vertex_descriptor t, 
+      const Region&     region, 
+      Workspace&        ws, 
+      Cost              cost) 
+  {
+    ws.reset(boost::num_vertices(g));
+    ws.set_distance(t, typename Workspace::distance_type());
+    ws.push(t);
+    while (!ws.empty())
+    {
+      uint32_t v = ws.top(); ws.pop();
+      auto r = boost::in_edges(v, g);
+      for (auto it = r.first; it != r.second; ++it)
+      {
+        uint32_t u = boost::source(*it, g);
+        if (!region.contains(u))
+          continue;
+        auto d = ws.distance(v) + cost(*it);
+        if (d < ws.distance(u)) {
+          bool queued = ws.reached(u);
+          ws.set_distance(u, d);
+          if (queued) ws.update(u); else ws.push(u);
+        }
+      }
+    }
+  }
+
+  std::vector<BiWeightT> _bound;   // by vertex, of those in region
+
+};
+
 /** \brief Heuristic functor.
  *
  * This class holds a reference to a target node and a graph and
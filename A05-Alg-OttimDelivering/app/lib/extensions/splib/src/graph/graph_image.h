@@ -0,0 +1,354 @@
+// This file is part of Sii-Mobility - Algorithms Optimized Delivering.
+//
+// Copyright (C) 2017 GOL Lab http://webgol.dinfo.unifi.it/ - University of Florence
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with This program.  If not, see <http://www.gnu.org/licenses/>.
+
+#ifndef GOL_GRAPH_IMAGE_H_
+#define GOL_GRAPH_IMAGE_H_
+
+// std
+#include <string>
+#include <vector>
+#include <cstring>
+#include <cstdio>
+#include <fstream>
+#include <sstream>
+#include <thread>
+#include <type_traits>
+// posix
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+#include "../exception.h"
+#include "graph_flat_array.h"
+
+namespace gol {
+
+// Graph image: a position independent file holding the arrays of a
+// frozen model, mapped read-only and used in place.
+//
+//   graph_image_header
+//   graph_image_section[n_sections]
+//   payloads, each aligned to GRAPH_IMAGE_ALIGNMENT
+//
+// Sections are plain arrays of standard layout types, offsets are
+// relative to the start of the file. The header carries the size and
+// modification time of the source data the model was built from,
+// worker processes sharing an image refuse it when they do not match.
+// A checksum of the section table is checked on every load; the one of
+// everything following the header reads every page of the image, it
+// is checked once written and on load only on GRAPH_IMAGE_VERIFY_ON_LOAD.
+
+#define GRAPH_IMAGE_MAGIC     "GOLGRAPH"
+#define GRAPH_IMAGE_VERSION   9
+#define GRAPH_IMAGE_ENDIANESS 0x01020304
+#define GRAPH_IMAGE_ALIGNMENT 64
+
+struct graph_image_header
+{
+  char     magic[8];
+  uint32_t version;
+  uint32_t endianess;
+  uint32_t n_sections;
+  uint32_t reserved;
+  uint64_t file_size;
+  // layout fingerprint of the model type
+  uint32_t weight_size;
+  uint32_t vertex_size;
+  uint32_t edge_size;
+  uint32_t reserved2;
+  char     model[64];
+  // source data fingerprint
+  uint64_t source_size;
+  int64_t  source_mtime;
+  // FNV-1a of the section table
+  uint64_t table_checksum;
+  // FNV-1a of the bytes following the header
+  uint64_t checksum;
+};
+
+struct graph_image_section
+{
+  char     name[64];
+  uint64_t offset;
+  uint64_t bytes;
+  uint32_t element_size;
+  uint32_t reserved;
+};
+
+// 64-bit FNV-1a, incremental
+inline uint64_t image_checksum(
+    const char* data, size_t n, uint64_t h = 0xcbf29ce484222325ULL)
+{
+  for (size_t i = 0; i < n; ++i) {
+    h ^= static_cast<unsigned char>(data[i]);
+    h *= 0x100000001b3ULL;
+  }
+  return h;
+}
+
+// fills the source fingerprint of h from the data file
+inline void fingerprint_source(std::string filename, graph_image_header& h)
+{
+  struct stat st;
+  if (::stat(filename.c_str(), &st) != 0)
+    throw data_exception("fingerprint_source(): can't stat " + filename);
+  h.source_size  = st.st_size;
+  h.source_mtime = st.st_mtime;
+}
+
+// read-only mapping of a whole file
+class mapped_file
+{
+ public:
+  explicit mapped_file(std::string filename): _data(nullptr), _size(0)
+  {
+    int fd = ::open(filename.c_str(), O_RDONLY);
+    if (fd < 0)
+      throw data_exception("mapped_file(): can't open " + filename);
+    struct stat st;
+    if (::fstat(fd, &st) != 0 || st.st_size == 0) {
+      ::close(fd);
+      throw data_exception("mapped_file(): can't stat " + filename);
+    }
+    _size = st.st_size;
+    void* p = ::mmap(nullptr, _size, PROT_READ, MAP_SHARED, fd, 0);
+    ::close(fd);
+    if (p == MAP_FAILED)
+      throw data_exception("mapped_file(): can't map " + filename);
+    _data = static_cast<const char*>(p);
+  }
+
+  ~mapped_file() {
+    if (_data)
+      ::munmap(const_cast<char*>(_data), _size);
+  }
+
+  const char* data() const { return _data; }
+  size_t      size() const { return _size; }
+
+ private:
+  mapped_file(const mapped_file&);
+  mapped_file& operator=(const mapped_file&);
+
+  const char* _data;
+  size_t      _size;
+
+};
+
+class graph_image_writer
+{
+ public:
+  graph_image_writer(): _sections(), _payloads() {}
+
+  template <typename T>
+  void add(std::string name, const T* data, size_t n)
+  {
+    static_assert(std::is_standard_layout<T>::value,
+      "graph image sections must be standard layout");
+    if (name.size() >= sizeof(graph_image_section::name))
+      throw data_exception("graph_image_writer::add(): name too long " + name);
+    graph_image_section s;
+    std::memset(&s, 0, sizeof(s));
+    std::strncpy(s.name, name.c_str(), sizeof(s.name) - 1);
+    s.bytes        = sizeof(T) * n;
+    s.element_size = sizeof(T);
+    _sections.push_back(s);
+    _payloads.push_back(reinterpret_cast<const char*>(data));
+  }
+
+  template <typename T>
+  void add(std::string name, const flat_array<T>& a) {
+    add(name, a.data(), a.size());
+  }
+
+  // the image is written aside and renamed, readers never see a
+  // partial file and concurrent writers never share the aside file
+  void write(std::string filename, graph_image_header header)
+  {
+    uint64_t offset = align(
+      sizeof(graph_image_header) +
+      sizeof(graph_image_section) * _sections.size());
+    for (auto& s : _sections) {
+      s.offset = offset;
+      offset = align(offset + s.bytes);
+    }
+
+    std::memcpy(header.magic, GRAPH_IMAGE_MAGIC, sizeof(header.magic));
+    header.version    = GRAPH_IMAGE_VERSION;
+    header.endianess  = GRAPH_IMAGE_ENDIANESS;
+    header.n_sections = _sections.size();
+    header.file_size  = offset;
+
+    std::ostringstream tmp_name;
+    tmp_name << filename << ".tmp." << ::getpid() << "." 
+             << std::this_thread::get_id();
+    std::string tmp = tmp_name.str();
+    std::ofstream ofs(tmp.c_str(), std::ios::binary | std::ios::trunc);
+    if (!ofs.good())
+      throw data_exception("graph_image_writer::write(): can't open " + tmp);
+
+    // the header is rewritten once the checksum is known
+    header.table_checksum = image_checksum(
+      reinterpret_cast<const char*>(_sections.data()),
+      sizeof(graph_image_section) * _sections.size());
+    header.checksum = image_checksum(nullptr, 0);
+    ofs.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    put(ofs, reinterpret_cast<const char*>(_sections.data()),
+        sizeof(graph_image_section) * _sections.size(), header.checksum);
+    for (size_t i = 0; i < _sections.size(); ++i) {
+      pad(ofs, _sections[i].offset, header.checksum);
+      put(ofs, _payloads[i], _sections[i].bytes, header.checksum);
+    }
+    pad(ofs, offset, header.checksum);
+    ofs.seekp(0);
+    ofs.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    ofs.close();
+
+    if (!ofs.good() || std::rename(tmp.c_str(), filename.c_str()) != 0) {
+      std::remove(tmp.c_str());
+      throw data_exception("graph_image_writer::write(): can't write " + filename);
+    }
+  }
+
+ private:
+  static uint64_t align(uint64_t offset) {
+    return (offset + GRAPH_IMAGE_ALIGNMENT - 1) &
+             ~uint64_t(GRAPH_IMAGE_ALIGNMENT - 1);
+  }
+
+  static void put(
+      std::ofstream& ofs, const char* data, size_t n, uint64_t& checksum)
+  {
+    ofs.write(data, n);
+    checksum = image_checksum(data, n, checksum);
+  }
+
+  static void pad(std::ofstream& ofs, uint64_t offset, uint64_t& checksum)
+  {
+    static const char zeros[GRAPH_IMAGE_ALIGNMENT] = {};
+    uint64_t pos = ofs.tellp();
+    if (pos < offset)
+      put(ofs, zeros, offset - pos, checksum);
+  }
+
+  std::vector<graph_image_section> _sections;
+  std::vector<const char*>         _payloads;
+
+};
+
+class graph_image
+{
+ public:
+  explicit graph_image(std::string filename):
+      _file(filename), _header(nullptr), _sections(nullptr)
+  {
+    if (_file.size() < sizeof(graph_image_header))
+      throw data_exception("graph_image(): truncated " + filename);
+    _header = reinterpret_cast<const graph_image_header*>(_file.data());
+    if (std::memcmp(_header->magic, GRAPH_IMAGE_MAGIC, sizeof(_header->magic)) != 0)
+      throw data_exception("graph_image(): not a graph image " + filename);
+    if (_header->version != GRAPH_IMAGE_VERSION ||
+        _header->endianess != GRAPH_IMAGE_ENDIANESS)
+      throw data_exception("graph_image(): unsupported version " + filename);
+    if (_header->file_size != _file.size() ||
+        sizeof(graph_image_header) +
+          sizeof(graph_image_section) * _header->n_sections > _file.size())
+      throw data_exception("graph_image(): truncated " + filename);
+    _sections = reinterpret_cast<const graph_image_section*>(
+      _file.data() + sizeof(graph_image_header));
+    // the table only, the payloads are paged in when used
+    if (image_checksum(
+          reinterpret_cast<const char*>(_sections),
+          sizeof(graph_image_section) * _header->n_sections) != 
+            _header->table_checksum)
+      throw data_exception("graph_image(): corrupted section table " + filename);
+    for (uint32_t i = 0; i < _header->n_sections; ++i)
+      if (_sections[i].offset + _sections[i].bytes > _file.size())
+        throw data_exception("graph_image(): truncated " + filename);
+  }
+
+  const graph_image_header& header() const { return *_header; }
+
+  // true if the image was written for model with the given layout
+  bool matches(std::string model,
+               uint32_t    weight_size,
+               uint32_t    vertex_size,
+               uint32_t    edge_size) const
+  {
+    return std::string(_header->model) == model   &&
+           _header->weight_size == weight_size    &&
+           _header->vertex_size == vertex_size    &&
+           _header->edge_size   == edge_size;
+  }
+
+  // true if the image was built from the given source data
+  bool built_from(const graph_image_header& source) const
+  {
+    return _header->source_size  == source.source_size &&
+           _header->source_mtime == source.source_mtime;
+  }
+
+  // checksum of the whole image: reads every page, which end up in 
+  // the shared page cache
+  bool verify() const
+  {
+    return image_checksum(
+      _file.data() + sizeof(graph_image_header),
+      _file.size() - sizeof(graph_image_header)) == _header->checksum;
+  }
+
+  bool has(std::string name) const {
+    return find(name) != nullptr;
+  }
+
+  template <typename T>
+  flat_array<T> section(std::string name) const
+  {
+    const graph_image_section* s = find(name);
+    if (!s)
+      throw data_exception("graph_image::section(): missing " + name);
+    if (s->element_size != sizeof(T) ||
+        s->bytes % sizeof(T) != 0    ||
+        s->offset + s->bytes > _file.size())
+      throw data_exception("graph_image::section(): corrupted " + name);
+    return flat_array<T>::view(
+      reinterpret_cast<const T*>(_file.data() + s->offset),
+      s->bytes / sizeof(T));
+  }
+
+  size_t size() const { return _file.size(); }
+
+ private:
+  const graph_image_section* find(std::string name) const
+  {
+    for (uint32_t i = 0; i < _header->n_sections; ++i)
+      if (std::strncmp(_sections[i].name, name.c_str(),
+                       sizeof(_sections[i].name)) == 0)
+        return &_sections[i];
+    return nullptr;
+  }
+
+  mapped_file                _file;
+  const graph_image_header*  _header;
+  const graph_image_section* _sections;
+
+};
+
+} // namespace gol
+
+#endif // GOL_GRAPH_IMAGE_H_
@@ -0,0 +1,169 @@
+// This file is part of Sii-Mobility - Algorithms Optimized Delivering.
+//
+// Copyright (C) 2017 GOL Lab http://webgol.dinfo.unifi.it/ - University of Florence
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with This program.  If not, see <http://www.gnu.org/licenses/>.
+
+#ifndef GOL_GRAPH_ISOCHRONE_H_
+#define GOL_GRAPH_ISOCHRONE_H_
+
+// std
+#include <vector>
+#include <unordered_map>
+#include <algorithm>
+#include <cmath>
+#include <stdint.h>
+
+#include "../common.h"
+
+namespace gol {
+
+// Grid collecting the points reached by a one-to-all search into the
+// cells of an isochrone. The grid is square in metres around the
+// origin, cells keep the least cost of their points.
+class isochrone_grid
+{
+  // metres per degree of latitude
+  static constexpr double meridian_degree = 111320.0;
+
+ public:
+  isochrone_grid(double lon, double lat, double cell_size)
+      : _lon(lon),
+        _lat(lat),
+        _size(cell_size),
+        _dlat(cell_size / meridian_degree),
+        _dlon(cell_size / (meridian_degree *
+          std::max(0.01, std::cos(rad(lat))))),
+        _cells() {}
+
+  void add(double lon, double lat, double cost)
+  {
+    auto it = _cells.emplace(
+      key(column(lon), row(lat)), cost).first;
+    it->second = std::min(it->second, cost);
+  }
+
+  // points of the segment from (lon1, lat1) to (lon2, lat2), traversed
+  // from cost1 at weight w, up to limit; a point every half cell
+  void add_segment(
+      double lon1, double lat1, double lon2, double lat2,
+      double cost1, double w, double limit)
+  {
+    double reach = w > 0 ? std::min(1.0, (limit - cost1) / w) : 1.0;
+    double steps = std::ceil(
+      2 * reach * distance(lon1, lat1, lon2, lat2) / _size);
+    if (!(steps >= 1))   // coincident ends, nan
+      steps = 1;
+    for (double k = 0; k <= steps; ++k)
+    {
+      double f = reach * k / steps;
+      add(lon1 + f * (lon2 - lon1), lat1 + f * (lat2 - lat1),
+          cost1 + f * w);
+    }
+  }
+
+  bool empty() const { return _cells.empty(); }
+
+  // cells by row then column, and the rings outlining them
+  void fill(isochrone& iso) const
+  {
+    std::vector<std::pair<int64_t, double> > cells(
+      _cells.begin(), _cells.end());
+    std::sort(cells.begin(), cells.end());
+    iso.cell_size = _size;
+    iso.cells.clear();
+    for (auto& c : cells)
+      iso.cells.push_back({
+        _lon + x(c.first) * _dlon, _lat + y(c.first) * _dlat, c.second});
+    outline(iso.rings);
+  }
+
+ private:
+  int32_t column(double lon) const {
+    return int32_t(std::floor((lon - _lon) / _dlon)); }
+  int32_t row(double lat) const {
+    return int32_t(std::floor((lat - _lat) / _dlat)); }
+
+  // row major, so that sorted keys go by row
+  static int64_t key(int32_t x, int32_t y) {
+    return (int64_t(y) << 32) | uint32_t(x); }
+  static int32_t x(int64_t k) { return int32_t(uint32_t(k)); }
+  static int32_t y(int64_t k) { return int32_t(k >> 32); }
+
+  bool occupied(int32_t x, int32_t y) const {
+    return _cells.count(key(x, y)) != 0; }
+
+  // the sides of the cells facing an empty cell, directed with the cell
+  // on their left, are chained corner to corner; where two rings touch
+  // at a corner the chain turns left, so rings never cross
+  void outline(
+      std::vector<std::vector<std::pair<double, double> > >& rings) const
+  {
+    // directions: east, north, west, south
+    static const int32_t dx[4] = {1, 0, -1,  0};
+    static const int32_t dy[4] = {0, 1,  0, -1};
+
+    // outgoing sides by corner, as a bitmask of directions
+    std::unordered_map<int64_t, uint8_t> sides;
+    for (auto& c : _cells)
+    {
+      int32_t cx = x(c.first), cy = y(c.first);
+      if (!occupied(cx, cy - 1)) sides[key(cx,     cy    )] |= 1 << 0;
+      if (!occupied(cx + 1, cy)) sides[key(cx + 1, cy    )] |= 1 << 1;
+      if (!occupied(cx, cy + 1)) sides[key(cx + 1, cy + 1)] |= 1 << 2;
+      if (!occupied(cx - 1, cy)) sides[key(cx,     cy + 1)] |= 1 << 3;
+    }
+
+    rings.clear();
+    for (auto& start : sides)
+    {
+      while (start.second != 0)
+      {
+        const int32_t x0 = x(start.first), y0 = y(start.first);
+        int32_t  cx  = x0, cy = y0;
+        uint8_t* out = &start.second;
+        int d = 0, last = -1;
+        while (!(*out & (1 << d))) ++d;
+        std::vector<std::pair<double, double> > ring;
+        do {
+          *out &= ~(1 << d);
+          if (d != last)   // a vertex where the outline turns
+            ring.emplace_back(_lon + cx * _dlon, _lat + cy * _dlat);
+          last = d;
+          cx += dx[d]; cy += dy[d];
+          out = &sides.find(key(cx, cy))->second;
+          for (int turn : {1, 0, 3})
+            if (*out & (1 << ((last + turn) % 4))) {
+              d = (last + turn) % 4;
+              break;
+            }
+        } while (cx != x0 || cy != y0);
+        ring.push_back(ring.front());
+        rings.push_back(std::move(ring));
+      }
+    }
+  }
+
+  double _lon;
+  double _lat;
+  double _size;
+  double _dlat;
+  double _dlon;
+  std::unordered_map<int64_t, double> _cells;
+
+};
+
+}  // namespace gol
+
+#endif // GOL_GRAPH_ISOCHRONE_H_
@@ -0,0 +1,388 @@
+// This file is part of Sii-Mobility - Algorithms Optimized Delivering.
+//
+// Copyright (C) 2017 GOL Lab http://webgol.dinfo.unifi.it/ - University of Florence
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with This program.  If not, see <http://www.gnu.org/licenses/>.
+
+#ifndef GOL_GRAPH_LANDMARKS_H_
+#define GOL_GRAPH_LANDMARKS_H_
+
+// std
+#include <vector>
+#include <limits>
+#include <random>
+#include <utility>
+#include <algorithm>
+#include <type_traits>
+#include <stdint.h>
+// boost
+#include <boost/graph/graph_traits.hpp>
+#include <boost/graph/astar_search.hpp>
+
+#include "../exception.h"
+#include "graph_flat_array.h"
+#include "graph_image.h"
+#include "graph_search_workspace.h"
+
+namespace gol {
+
+// Landmarks of a frozen graph for one weight profile: the distances
+// d(L, v) and d(v, L) between a few vertices L and every vertex. By 
+// the triangle inequality
+//
+//   d(v, t) >= d(v, L) - d(t, L)    and    d(v, t) >= d(L, t) - d(L, v)
+//
+// so they bound from below the distance of any vertex to a target.
+// Landmarks are selected by the avoid strategy: grow a shortest path
+// tree from a random root, weight each vertex by how much its bound
+// from the landmarks so far underestimates its distance, and take the
+// leaf at the end of the heaviest branch holding no landmark.
+template <typename WeightT>
+class landmarks_t
+{
+  static const uint32_t none = std::numeric_limits<uint32_t>::max();
+
+ public:
+  landmarks_t(): _k(0), _landmarks(), _from(), _to() {}
+
+  uint32_t num_landmarks() const { return _k; }
+  uint32_t landmark(uint32_t i) const { return _landmarks[i]; }
+
+  // d(L_i, v) and d(v, L_i), by landmark
+  const WeightT* from(uint32_t v) const { return _from.data() + size_t(v) * _k; }
+  const WeightT* to(uint32_t v)   const { return _to.data()   + size_t(v) * _k; }
+
+  // lower bound of d(u, v) by landmark i, 0 when it tells nothing
+  WeightT bound(uint32_t i, uint32_t u, uint32_t v) const {
+    return bound(from(u)[i], to(u)[i], from(v)[i], to(v)[i]); }
+
+  static WeightT bound(
+      WeightT from_u, WeightT to_u, WeightT from_v, WeightT to_v)
+  {
+    const WeightT infinity = std::numeric_limits<WeightT>::max();
+    WeightT b = WeightT();
+    if (to_u != infinity && to_v != infinity && to_u - to_v > b)
+      b = to_u - to_v;
+    if (from_u != infinity && from_v != infinity && from_v - from_u > b)
+      b = from_v - from_u;
+    return b;
+  }
+
+  template <typename GraphT, typename WeightMap>
+  void build(const GraphT& g, const WeightMap& weight, uint32_t k)
+  {
+    const WeightT  infinity = std::numeric_limits<WeightT>::max();
+    const uint32_t n        = boost::num_vertices(g);
+    k = std::min(k, n);
+
+    std::vector<uint32_t> landmarks;
+    std::vector<WeightT>  from(size_t(n) * k, infinity);
+    std::vector<WeightT>  to(size_t(n) * k, infinity);
+    std::vector<bool>     is_landmark(n, false);
+
+    search_workspace<uint32_t, WeightT> ws;
+    std::vector<uint32_t> order;
+    std::vector<WeightT>  size(n);
+    std::vector<bool>     covered(n);
+    std::vector<uint32_t> child_offsets(n + 1), children;
+    std::mt19937 rng(n);
+
+    auto lower_bound = [&](uint32_t u, uint32_t v) {
+      WeightT b = WeightT();
+      for (uint32_t i = 0; i < landmarks.size(); ++i)
+        b = std::max(b, bound(
+          from[size_t(u) * k + i], to[size_t(u) * k + i], 
+          from[size_t(v) * k + i], to[size_t(v) * k + i]));
+      return b;
+    };
+
+    for (uint32_t attempts = 0; landmarks.size() < k && attempts < 4 * k; ++attempts)
+    {
+      const uint32_t r = rng() % n;
+      search(g, weight, r, false, ws, order);
+
+      // subtree weights, zero for the subtrees holding a landmark
+      for (uint32_t v : order) {
+        size[v]    = ws.distance(v) - lower_bound(r, v);
+        covered[v] = is_landmark[v];
+      }
+      for (size_t i = order.size(); i-- > 1; ) {
+        uint32_t v = order[i], p = ws.parent(v);
+        size[p]    += size[v];
+        covered[p] = covered[p] || covered[v];
+      }
+
+      std::fill(child_offsets.begin(), child_offsets.end(), 0);
+      for (size_t i = 1; i < order.size(); ++i)
+        ++child_offsets[ws.parent(order[i]) + 1];
+      for (uint32_t v = 0; v < n; ++v)
+        child_offsets[v + 1] += child_offsets[v];
+      children.resize(child_offsets[n]);
+      std::vector<uint32_t> fill(child_offsets.begin(), child_offsets.end() - 1);
+      for (size_t i = 1; i < order.size(); ++i)
+        children[fill[ws.parent(order[i])]++] = order[i];
+
+      uint32_t v = r;
+      for (;;) 
+      {
+        uint32_t best = none;
+        for (uint32_t c = child_offsets[v]; c < child_offsets[v + 1]; ++c) {
+          uint32_t w = children[c];
+          if (!covered[w] && (best == none || size[w] > size[best]))
+            best = w;
+        }
+        if (best == none)
+          break;
+        v = best;
+      }
+      if (v == r)
+        v = order.back();  // farthest from r
+      if (is_landmark[v])
+        continue;
+
+      const uint32_t i = landmarks.size();
+      landmarks.push_back(v);
+      is_landmark[v] = true;
+      search(g, weight, v, false, ws, order);
+      for (uint32_t u : order)
+        from[size_t(u) * k + i] = ws.distance(u);
+      search(g, weight, v, true, ws, order);
+      for (uint32_t u : order)
+        to[size_t(u) * k + i] = ws.distance(u);
+    }
+
+    if (landmarks.size() < k) 
+    {
+      // drop the columns of the landmarks not found
+      const uint32_t m = landmarks.size();
+      for (uint32_t v = 0; v < n; ++v)
+        for (uint32_t i = 0; i < m; ++i) {
+          from[size_t(v) * m + i] = from[size_t(v) * k + i];
+          to[size_t(v) * m + i]   = to[size_t(v) * k + i];
+        }
+      from.resize(size_t(n) * m);
+      to.resize(size_t(n) * m);
+      k = m;
+    }
+
+    _k         = k;
+    _landmarks = flat_array<uint32_t>(std::move(landmarks));
+    _from      = flat_array<WeightT>(std::move(from));
+    _to        = flat_array<WeightT>(std::move(to));
+  }
+
+  void save(graph_image_writer& w, std::string prefix) const
+  {
+    w.add(prefix + ".landmarks", _landmarks);
+    w.add(prefix + ".from",      _from);
+    w.add(prefix + ".to",        _to);
+  }
+
+  void map(const graph_image& img, std::string prefix, uint32_t n)
+  {
+    landmarks_t lm;
+    lm._landmarks = img.section<uint32_t>(prefix + ".landmarks");
+    lm._from      = img.section<WeightT>(prefix + ".from");
+    lm._to        = img.section<WeightT>(prefix + ".to");
+    lm._k         = lm._landmarks.size();
+    if (lm._from.size() != size_t(n) * lm._k || 
+        lm._to.size()   != size_t(n) * lm._k)
+      throw data_exception(
+        "landmarks_t::map(): inconsistent image " + prefix);
+    *this = std::move(lm);
+  }
+
+  size_t memory_usage() const
+  {
+    return 
+      _landmarks.memory_usage() + 
+      _from.memory_usage()      + 
+      _to.memory_usage();
+  }
+
+ private:
+  // full Dijkstra from s, on the reversed graph if reverse; order 
+  // gets the vertices as they are settled
+  template <typename GraphT, typename WeightMap, typename Workspace>
+  static void search(
+      const GraphT&          g, 
+      const WeightMap&       weight, 
+      uint32_t               s, 
+      bool                   reverse, 
+      Workspace&             ws, 
+      std::vector<uint32_t>& order)
+  {
+    auto relax = [&ws](uint32_t u, uint32_t v, WeightT d) {
+      if (d < ws.distance(v)) {
+        bool queued = ws.reached(v);
+        ws.set_distance(v, d);
+        ws.set_parent(v, u);
+        if (queued) ws.update(v); else ws.push(v);
+      }
+    };
+
+    ws.reset(boost::num_vertices(g));
+    order.clear();
+    ws.set_distance(s, WeightT());
+    ws.push(s);
+    while (!ws.empty())
+    {
+      uint32_t u = ws.top(); ws.pop();
+      order.push_back(u);
+      WeightT du = ws.distance(u);
+      if (!reverse) {
+        auto r = boost::out_edges(u, g);
+        for (auto it = r.first; it != r.second; ++it)
+          relax(u, boost::target(*it, g), du + get(weight, *it));
+      } else {
+        auto r = boost::in_edges(u, g);
+        for (auto it = r.first; it != r.second; ++it)
+          relax(u, boost::source(*it, g), du + get(weight, *it));
+      }
+    }
+  }
+
+  uint32_t                _k;
+  flat_array<uint32_t>    _landmarks;
+  flat_array<WeightT>     _from;       // |V| x landmarks, d(L, v)
+  flat_array<WeightT>     _to;         // |V| x landmarks, d(v, L)
+
+};
+
+// ALT lower bound of the distance to t, on the landmarks giving the
+// best bound for (s, t)
+template <typename GraphT, typename WeightT>
+class landmark_heuristic : 
+  public boost::astar_heuristic<GraphT, WeightT> 
+{
+ public:
+  typedef typename boost::graph_traits<GraphT>::vertex_descriptor vertex_descriptor;
+
+  landmark_heuristic(
+      const landmarks_t<WeightT>& lm, 
+      vertex_descriptor           s, 
+      vertex_descriptor           t, 
+      uint32_t                    n_active):
+      _lm(&lm),
+      _active(),
+      _from_t(),
+      _to_t()
+  {
+    std::vector<std::pair<WeightT, uint32_t> > ranked;
+    for (uint32_t i = 0; i < lm.num_landmarks(); ++i)
+      ranked.push_back(std::make_pair(lm.bound(i, s, t), i));
+    n_active = std::min<uint32_t>(n_active, ranked.size());
+    std::partial_sort(
+      ranked.begin(), ranked.begin() + n_active, ranked.end(),
+      std::greater<std::pair<WeightT, uint32_t> >());
+    for (uint32_t a = 0; a < n_active; ++a) {
+      uint32_t i = ranked[a].second;
+      _active.push_back(i);
+      _from_t.push_back(lm.from(t)[i]);
+      _to_t.push_back(lm.to(t)[i]);
+    }
+  }
+
+  WeightT operator()(vertex_descriptor v) const 
+  {
+    const WeightT* from = _lm->from(v);
+    const WeightT* to   = _lm->to(v);
+    WeightT h = WeightT();
+    for (size_t a = 0; a < _active.size(); ++a) {
+      uint32_t i = _active[a];
+      h = std::max(h, 
+        landmarks_t<WeightT>::bound(from[i], to[i], _from_t[a], _to_t[a]));
+    }
+    return h;
+  }
+
+ private:
+  const landmarks_t<WeightT>* _lm;
+  std::vector<uint32_t>       _active;
+  std::vector<WeightT>        _from_t;
+  std::vector<WeightT>        _to_t;
+
+};
+
+// Base graph with the landmarks of one weight profile, handed to the
+// solvers in place of the base graph; vertices and edges are the base
+// ones.
+template <typename GraphT, typename WeightT>
+class landmark_graph_t
+{
+ public:
+  typedef landmarks_t<WeightT>                     landmarks_type;
+
+  typedef typename GraphT::vertex_descriptor       vertex_descriptor;
+  typedef typename GraphT::edge_descriptor         edge_descriptor;
+  typedef boost::directed_tag                      directed_category;
+  typedef boost::allow_parallel_edge_tag           edge_parallel_category;
+  typedef boost::incidence_graph_tag               traversal_category;
+
+  landmark_graph_t(const GraphT& g, const landmarks_type& lm):
+      _g(&g),
+      _lm(&lm) {}
+
+  static vertex_descriptor null_vertex() {
+    return GraphT::null_vertex(); }
+
+  const GraphT&         base()      const { return *_g; }
+  const landmarks_type& landmarks() const { return *_lm; }
+
+  auto operator[](vertex_descriptor v) const -> decltype(std::declval<const GraphT&>()[v]) {
+    return (*_g)[v]; }
+  auto operator[](edge_descriptor e) const -> decltype(std::declval<const GraphT&>()[e]) {
+    return (*_g)[e]; }
+
+ private:
+  const GraphT*         _g;
+  const landmarks_type* _lm;
+
+};
+
+template <typename T>
+struct is_landmark_graph: std::false_type {};
+
+template <typename GraphT, typename WeightT>
+struct is_landmark_graph<landmark_graph_t<GraphT, WeightT> >: std::true_type {};
+
+// BGL interface, edges are the base graph ones
+
+template <typename GraphT, typename WeightT>
+inline typename GraphT::vertex_descriptor
+source(typename GraphT::edge_descriptor e,
+       const landmark_graph_t<GraphT, WeightT>& lg) {
+  return source(e, lg.base()); }
+
+template <typename GraphT, typename WeightT>
+inline typename GraphT::vertex_descriptor
+target(typename GraphT::edge_descriptor e,
+       const landmark_graph_t<GraphT, WeightT>& lg) {
+  return target(e, lg.base()); }
+
+template <typename GraphT, typename WeightT>
+inline uint32_t num_vertices(const landmark_graph_t<GraphT, WeightT>& lg) {
+  return num_vertices(lg.base()); }
+
+} // namespace gol
+
+namespace boost {
+
+using gol::source;
+using gol::target;
+using gol::num_vertices;
+
+} // namespace boost
+
+#endif // GOL_GRAPH_LANDMARKS_H_
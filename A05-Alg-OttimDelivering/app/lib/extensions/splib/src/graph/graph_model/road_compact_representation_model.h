@@ -55,15 +55,15 @@ class road_compact_representation_model :
   ~road_compact_representation_model() {}
 
   virtual void add_node(
-    std::string   id,
+    osm_id_t      id,
     features_map& fmap, 
     double        lon, 
     double        lat,
     double        ele);
 
   virtual void add_section(
-    std::string   sid, 
-    std::string   tid, 
+    osm_id_t      sid, 
+    osm_id_t      tid, 
     features_map& fmap);
 
   virtual WeightT get_model_edge_weight(
@@ -114,7 +114,7 @@ void road_compact_representation_model<
     Constraints, 
     WeightT
 >::add_node(
-    std::string   id,
+    osm_id_t      id,
     features_map& fmap, 
     double        lon, 
     double        lat,
@@ -125,7 +125,7 @@ void road_compact_representation_model<
   (Base::_g)[v].geo.lon = lon; 
   (Base::_g)[v].geo.lat = lat;
   (Base::_g)[v].geo.ele = ele; 
-  (Base::_vtxmap)[id]   = v;
+  (Base::_vtxmap).insert(id, v);
 }
 
 template <
@@ -141,12 +141,17 @@ void road_compact_representation_model<
     Constraints, 
     WeightT
 >::add_section(
-    std::string   sid, 
-    std::string   tid, 
+    osm_id_t      sid, 
+    osm_id_t      tid, 
     features_map& fmap) 
 {  
-  vertex_descriptor s = (Base::_vtxmap)[sid];
-  vertex_descriptor t = (Base::_vtxmap)[tid];
+  auto sit = (Base::_vtxmap).find(sid);
+  auto tit = (Base::_vtxmap).find(tid);
+  if (sit == (Base::_vtxmap).end() || 
+      tit == (Base::_vtxmap).end())  
+    return; // out of bounding box
+  vertex_descriptor s = (*sit).second;
+  vertex_descriptor t = (*tit).second;
 
   if (fmap.is_road_highway())  
   { 
@@ -170,10 +175,10 @@ void road_compact_representation_model<
         (Base::_g)[e].weight = 
           this->get_model_edge_weight(s, t, fmap);
   
-        (Base::_g)[e].properties.highway_value = 
-          fmap.get_highway_value();
+        (Base::_g)[e].properties.highway = 
+          fmap.get_highway_kind();
         (Base::_g)[e].properties.desc = 
-          fmap.get_highway_name();  
+          this->intern_name(fmap.get_highway_name());  
       }
     }    
 
@@ -195,10 +200,10 @@ void road_compact_representation_model<
         (Base::_g)[e].weight = 
           this->get_model_edge_weight(t, s, fmap);
 
-        (Base::_g)[e].properties.highway_value = 
-          fmap.get_highway_value();
+        (Base::_g)[e].properties.highway = 
+          fmap.get_highway_kind();
         (Base::_g)[e].properties.desc = 
-          fmap.get_highway_name();              
+          this->intern_name(fmap.get_highway_name());              
       }
     }
     
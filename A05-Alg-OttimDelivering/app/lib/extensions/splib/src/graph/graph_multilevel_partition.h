@@ -0,0 +1,329 @@
+// This file is part of Sii-Mobility - Algorithms Optimized Delivering.
+//
+// Copyright (C) 2017 GOL Lab http://webgol.dinfo.unifi.it/ - University of Florence
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with This program.  If not, see <http://www.gnu.org/licenses/>.
+
+#ifndef GOL_GRAPH_MULTILEVEL_PARTITION_H_
+#define GOL_GRAPH_MULTILEVEL_PARTITION_H_
+
+// std
+#include <vector>
+#include <limits>
+#include <utility>
+#include <numeric>
+#include <algorithm>
+#include <stdint.h>
+// boost
+#include <boost/graph/graph_traits.hpp>
+
+#include "../exception.h"
+#include "graph_flat_array.h"
+#include "graph_image.h"
+
+namespace gol {
+
+// Nested partition of the vertices of a frozen graph into cells, level
+// 1 cells are the finest and every level l cell is a union of level
+// l - 1 cells. Cells come from recursive bisection at the median of
+// the wider coordinate extent, so the partition depends on the 
+// topology only and is shared by all the metrics of a model.
+//
+// A vertex is an entry (exit) of its level l cell when an edge enters
+// (leaves) the cell at it; entries and exits of a cell are numbered in
+// vertex order and index the rows and columns of its clique.
+class multilevel_partition_t
+{
+ public:
+  static const uint32_t none = std::numeric_limits<uint32_t>::max();
+
+  typedef std::pair<const uint32_t*, const uint32_t*> vertex_range;
+
+  multilevel_partition_t():
+      _n(0),
+      _levels(0),
+      _cells(),
+      _entry_pos(),
+      _exit_pos(),
+      _cell_offsets(1, 0),
+      _entry_offsets(1, 0),
+      _entries(),
+      _exit_offsets(1, 0),
+      _exits(),
+      _clique_offsets(1, 0) {}
+
+  // level l cells hold up to 2^(cell_size_log2 + (l - 1) * fanout_log2)
+  // vertices
+  template <typename GraphT>
+  void build(
+      const GraphT& g, 
+      uint32_t      levels, 
+      uint32_t      cell_size_log2, 
+      uint32_t      fanout_log2)
+  {
+    const uint32_t n = boost::num_vertices(g);
+
+    bisection b;
+    b.levels = levels;
+    b.cells.assign(size_t(levels) * n, 0);
+    b.n_cells.assign(levels + 1, 0);
+    for (uint32_t l = 1; l <= levels; ++l)
+      b.max_size.push_back(size_t(1) << (cell_size_log2 + (l - 1) * fanout_log2));
+    b.order.resize(n);
+    std::iota(b.order.begin(), b.order.end(), 0);
+    b.xy.reserve(n);
+    for (uint32_t v = 0; v < n; ++v)
+      b.xy.push_back(std::make_pair(g[v].geo.lon, g[v].geo.lat));
+    b.n = n;
+    if (n > 0)
+      b.bisect(0, n, levels);
+
+    // boundary vertices, cells are nested: an edge inside a level l
+    // cell is inside the cells of the levels above
+    std::vector<uint32_t> entry_pos(size_t(levels) * n, uint32_t(none));
+    std::vector<uint32_t> exit_pos(size_t(levels) * n, uint32_t(none));
+    auto er = boost::edges(g);
+    for (auto ei = er.first; ei != er.second; ++ei)
+    {
+      uint32_t u = boost::source(*ei, g), v = boost::target(*ei, g);
+      for (uint32_t l = 1; l <= levels; ++l)
+      {
+        size_t base = size_t(l - 1) * n;
+        if (b.cells[base + u] == b.cells[base + v])
+          break;
+        exit_pos[base + u]  = 0;
+        entry_pos[base + v] = 0;
+      }
+    }
+
+    std::vector<uint32_t> cell_offsets(1, 0);
+    for (uint32_t l = 1; l <= levels; ++l)
+      cell_offsets.push_back(cell_offsets.back() + b.n_cells[l]);
+    const uint32_t n_gcells = cell_offsets.back();
+
+    std::vector<uint32_t> entry_offsets, entries, exit_offsets, exits;
+    number(b.cells, cell_offsets, entry_pos, entry_offsets, entries, n, levels);
+    number(b.cells, cell_offsets, exit_pos,  exit_offsets,  exits,   n, levels);
+
+    std::vector<uint64_t> clique_offsets(1, 0);
+    for (uint32_t c = 0; c < n_gcells; ++c)
+      clique_offsets.push_back(clique_offsets.back() + 
+        uint64_t(entry_offsets[c + 1] - entry_offsets[c]) * 
+                (exit_offsets[c + 1]  - exit_offsets[c]));
+
+    _n              = n;
+    _levels         = levels;
+    _cells          = flat_array<uint32_t>(std::move(b.cells));
+    _entry_pos      = flat_array<uint32_t>(std::move(entry_pos));
+    _exit_pos       = flat_array<uint32_t>(std::move(exit_pos));
+    _cell_offsets   = flat_array<uint32_t>(std::move(cell_offsets));
+    _entry_offsets  = flat_array<uint32_t>(std::move(entry_offsets));
+    _entries        = flat_array<uint32_t>(std::move(entries));
+    _exit_offsets   = flat_array<uint32_t>(std::move(exit_offsets));
+    _exits          = flat_array<uint32_t>(std::move(exits));
+    _clique_offsets = flat_array<uint64_t>(std::move(clique_offsets));
+  }
+
+  uint32_t num_vertices() const { return _n; }
+  uint32_t num_levels()   const { return _levels; }
+
+  uint32_t num_cells(uint32_t l) const {
+    return _cell_offsets[l] - _cell_offsets[l - 1]; }
+
+  uint32_t cell(uint32_t l, uint32_t v) const {
+    return _cells[size_t(l - 1) * _n + v]; }
+
+  // position of v among the entries (exits) of its level l cell, none
+  // if it is not one
+  uint32_t entry_pos(uint32_t l, uint32_t v) const {
+    return _entry_pos[size_t(l - 1) * _n + v]; }
+  uint32_t exit_pos(uint32_t l, uint32_t v) const {
+    return _exit_pos[size_t(l - 1) * _n + v]; }
+
+  vertex_range entries(uint32_t l, uint32_t c) const {
+    uint32_t gc = _cell_offsets[l - 1] + c;
+    return std::make_pair(
+      _entries.data() + _entry_offsets[gc], 
+      _entries.data() + _entry_offsets[gc + 1]);
+  }
+
+  vertex_range exits(uint32_t l, uint32_t c) const {
+    uint32_t gc = _cell_offsets[l - 1] + c;
+    return std::make_pair(
+      _exits.data() + _exit_offsets[gc], 
+      _exits.data() + _exit_offsets[gc + 1]);
+  }
+
+  // cliques of all the cells, entries x exits row-major, cell by cell
+  uint64_t clique_offset(uint32_t l, uint32_t c) const {
+    return _clique_offsets[_cell_offsets[l - 1] + c]; }
+  uint64_t clique_size() const {
+    return _clique_offsets[_clique_offsets.size() - 1]; }
+
+  // highest level at which v is in neither the cell of s nor the one
+  // of t, 0 when there is none
+  uint32_t query_level(uint32_t v, uint32_t s, uint32_t t) const
+  {
+    for (uint32_t l = _levels; l > 0; --l) {
+      uint32_t c = cell(l, v);
+      if (c != cell(l, s) && c != cell(l, t))
+        return l;
+    }
+    return 0;
+  }
+
+  void save(graph_image_writer& w, std::string prefix) const
+  {
+    w.add(prefix + ".cells",          _cells);
+    w.add(prefix + ".entry_pos",      _entry_pos);
+    w.add(prefix + ".exit_pos",       _exit_pos);
+    w.add(prefix + ".cell_offsets",   _cell_offsets);
+    w.add(prefix + ".entry_offsets",  _entry_offsets);
+    w.add(prefix + ".entries",        _entries);
+    w.add(prefix + ".exit_offsets",   _exit_offsets);
+    w.add(prefix + ".exits",          _exits);
+    w.add(prefix + ".clique_offsets", _clique_offsets);
+  }
+
+  void map(const graph_image& img, std::string prefix)
+  {
+    multilevel_partition_t p;
+    p._cells          = img.section<uint32_t>(prefix + ".cells");
+    p._entry_pos      = img.section<uint32_t>(prefix + ".entry_pos");
+    p._exit_pos       = img.section<uint32_t>(prefix + ".exit_pos");
+    p._cell_offsets   = img.section<uint32_t>(prefix + ".cell_offsets");
+    p._entry_offsets  = img.section<uint32_t>(prefix + ".entry_offsets");
+    p._entries        = img.section<uint32_t>(prefix + ".entries");
+    p._exit_offsets   = img.section<uint32_t>(prefix + ".exit_offsets");
+    p._exits          = img.section<uint32_t>(prefix + ".exits");
+    p._clique_offsets = img.section<uint64_t>(prefix + ".clique_offsets");
+    if (p._cell_offsets.empty())
+      throw data_exception(
+        "multilevel_partition_t::map(): inconsistent image " + prefix);
+    p._levels = p._cell_offsets.size() - 1;
+    p._n      = p._levels ? p._cells.size() / p._levels : 0;
+    const uint32_t n_gcells = p._cell_offsets[p._levels];
+    if (p._entry_pos.size()      != p._cells.size() ||
+        p._exit_pos.size()       != p._cells.size() ||
+        p._entry_offsets.size()  != n_gcells + 1    ||
+        p._exit_offsets.size()   != n_gcells + 1    ||
+        p._clique_offsets.size() != n_gcells + 1)
+      throw data_exception(
+        "multilevel_partition_t::map(): inconsistent image " + prefix);
+    *this = std::move(p);
+  }
+
+  size_t memory_usage() const
+  {
+    return
+      _cells.memory_usage()         + _entry_pos.memory_usage()     +
+      _exit_pos.memory_usage()      + _cell_offsets.memory_usage()  +
+      _entry_offsets.memory_usage() + _entries.memory_usage()       +
+      _exit_offsets.memory_usage()  + _exits.memory_usage()         +
+      _clique_offsets.memory_usage();
+  }
+
+ private:
+  struct bisection
+  {
+    uint32_t                              n;
+    uint32_t                              levels;
+    std::vector<size_t>                   max_size;  // by level - 1
+    std::vector<uint32_t>                 cells;     // levels x |V|
+    std::vector<uint32_t>                 n_cells;   // by level
+    std::vector<uint32_t>                 order;
+    std::vector<std::pair<double, double> > xy;
+
+    // order[lo, hi) is inside one cell of every level above l
+    void bisect(uint32_t lo, uint32_t hi, uint32_t l)
+    {
+      while (l > 0 && hi - lo <= max_size[l - 1])
+      {
+        uint32_t c = n_cells[l]++;
+        for (uint32_t i = lo; i < hi; ++i)
+          cells[size_t(l - 1) * n + order[i]] = c;
+        --l;
+      }
+      if (l == 0)
+        return;
+
+      double min_x = xy[order[lo]].first,  max_x = min_x;
+      double min_y = xy[order[lo]].second, max_y = min_y;
+      for (uint32_t i = lo; i < hi; ++i) {
+        min_x = std::min(min_x, xy[order[i]].first);
+        max_x = std::max(max_x, xy[order[i]].first);
+        min_y = std::min(min_y, xy[order[i]].second);
+        max_y = std::max(max_y, xy[order[i]].second);
+      }
+      const bool by_x = (max_x - min_x) >= (max_y - min_y);
+      const uint32_t mid = lo + (hi - lo) / 2;
+      std::nth_element(
+        order.begin() + lo, order.begin() + mid, order.begin() + hi,
+        [this, by_x](uint32_t a, uint32_t b) {
+          return by_x ? xy[a].first  < xy[b].first 
+                      : xy[a].second < xy[b].second; });
+      bisect(lo, mid, l);
+      bisect(mid, hi, l);
+    }
+  };
+
+  // numbers the marked vertices of each cell, in vertex order
+  static void number(
+      const std::vector<uint32_t>& cells,
+      const std::vector<uint32_t>& cell_offsets,
+      std::vector<uint32_t>&       pos,
+      std::vector<uint32_t>&       offsets,
+      std::vector<uint32_t>&       vertices,
+      uint32_t                     n,
+      uint32_t                     levels)
+  {
+    offsets.assign(cell_offsets.back() + 1, 0);
+    for (uint32_t l = 1; l <= levels; ++l)
+      for (uint32_t v = 0; v < n; ++v)
+        if (pos[size_t(l - 1) * n + v] != none)
+          ++offsets[cell_offsets[l - 1] + cells[size_t(l - 1) * n + v] + 1];
+    for (size_t c = 1; c < offsets.size(); ++c)
+      offsets[c] += offsets[c - 1];
+
+    vertices.resize(offsets.back());
+    std::vector<uint32_t> fill(offsets.begin(), offsets.end() - 1);
+    for (uint32_t l = 1; l <= levels; ++l)
+      for (uint32_t v = 0; v < n; ++v)
+      {
+        size_t i = size_t(l - 1) * n + v;
+        if (pos[i] == none)
+          continue;
+        uint32_t gc = cell_offsets[l - 1] + cells[i];
+        pos[i] = fill[gc] - offsets[gc];
+        vertices[fill[gc]++] = v;
+      }
+  }
+
+  uint32_t                _n;
+  uint32_t                _levels;
+  flat_array<uint32_t>    _cells;           // levels x |V|, cell in level
+  flat_array<uint32_t>    _entry_pos;       // levels x |V|
+  flat_array<uint32_t>    _exit_pos;        // levels x |V|
+  flat_array<uint32_t>    _cell_offsets;    // first cell of each level, levels + 1
+  flat_array<uint32_t>    _entry_offsets;   // all cells + 1
+  flat_array<uint32_t>    _entries;
+  flat_array<uint32_t>    _exit_offsets;    // all cells + 1
+  flat_array<uint32_t>    _exits;
+  flat_array<uint64_t>    _clique_offsets;  // all cells + 1
+
+};
+
+} // namespace gol
+
+#endif // GOL_GRAPH_MULTILEVEL_PARTITION_H_
@@ -0,0 +1,269 @@
+// This file is part of Sii-Mobility - Algorithms Optimized Delivering.
+//
+// Copyright (C) 2017 GOL Lab http://webgol.dinfo.unifi.it/ - University of Florence
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with This program.  If not, see <http://www.gnu.org/licenses/>.
+
+#ifndef GOL_GRAPH_NODE_CONTRACTION_H_
+#define GOL_GRAPH_NODE_CONTRACTION_H_
+
+// std
+#include <vector>
+#include <queue>
+#include <limits>
+#include <utility>
+#include <functional>
+#include <algorithm>
+#include <stdint.h>
+
+#include "../config.h"
+#include "graph_search_workspace.h"
+#include "graph_contraction_hierarchy.h"
+
+namespace gol {
+
+// Offline preprocessing of a contraction hierarchy. Nodes are taken
+// by increasing priority (edge difference, contracted neighbours and
+// level, updated lazily); contracting v adds a shortcut u -> w for
+// each pair of arcs u -> v -> w unless a witness search from u finds
+// a path to w avoiding v that is not longer. Witness searches are cut
+// after CH_WITNESS_SETTLED_LIMIT settled nodes, which may only add
+// superfluous shortcuts.
+template <typename WeightT>
+class node_contraction
+{
+  typedef hierarchy_arc_t<WeightT>        arc_t;
+  typedef uint32_t                        arc_index_t;
+  typedef search_workspace<
+    uint32_t, WeightT>                    workspace_t;
+  typedef std::pair<int64_t, uint32_t>    priority_t;
+
+  static const uint32_t none = arc_t::none;
+
+ public:
+  explicit node_contraction(uint32_t n):
+      _arcs(),
+      _out(n),
+      _in(n),
+      _up(n),
+      _down(n),
+      _contracted(n, false),
+      _level(n, 0),
+      _neighbours(n, 0),
+      _ws(),
+      _n_shortcuts(0) {}
+
+  // arc of the input graph, payload is kept for unpacking
+  void add_arc(uint32_t tail, uint32_t head, WeightT w, uint32_t payload)
+  {
+    if (tail == head)
+      return;
+    insert(arc_t{tail, head, payload, none, w});
+  }
+
+  void run()
+  {
+    const uint32_t n = _out.size();
+
+    std::priority_queue<
+      priority_t,
+      std::vector<priority_t>,
+      std::greater<priority_t> > Q;
+    std::vector<int64_t> priority(n);
+    for (uint32_t v = 0; v < n; ++v) {
+      priority[v] = compute_priority(v);
+      Q.push(priority_t(priority[v], v));
+    }
+
+    while (!Q.empty())
+    {
+      priority_t top = Q.top(); Q.pop();
+      uint32_t v = top.second;
+      if (_contracted[v] || top.first != priority[v])
+        continue; // stale entry
+
+      // lazy update, v goes back if it got worse meanwhile
+      priority[v] = compute_priority(v);
+      if (!Q.empty() && priority[v] > Q.top().first) {
+        Q.push(priority_t(priority[v], v));
+        continue;
+      }
+
+      std::vector<uint32_t> neighbours = contract(v);
+      for (uint32_t w : neighbours) {
+        priority[w] = compute_priority(w);
+        Q.push(priority_t(priority[w], w));
+      }
+    }
+  }
+
+  template <typename HierarchyT>
+  void assign_to(HierarchyT& h) {
+    h.assign(std::move(_arcs), _up, _down);
+  }
+
+  size_t num_shortcuts() const { return _n_shortcuts; }
+
+ private:
+  // adds a arc unless a parallel one is not longer, a longer parallel
+  // arc is dropped
+  bool insert(const arc_t& a)
+  {
+    auto& out = _out[a.tail];
+    for (size_t i = 0; i < out.size(); ++i)
+    {
+      arc_t& b = _arcs[out[i]];
+      if (b.head != a.head)
+        continue;
+      if (b.weight <= a.weight)
+        return false;
+      erase(_in[a.head], out[i]);
+      out[i] = out.back(); out.pop_back();
+      break;
+    }
+    arc_index_t idx = _arcs.size();
+    _arcs.push_back(a);
+    _out[a.tail].push_back(idx);
+    _in[a.head].push_back(idx);
+    return true;
+  }
+
+  static void erase(std::vector<arc_index_t>& l, arc_index_t a)
+  {
+    auto it = std::find(l.begin(), l.end(), a);
+    if (it != l.end()) {
+      *it = l.back();
+      l.pop_back();
+    }
+  }
+
+  // distances from u to the heads of v out-arcs avoiding v, bounded
+  // by limit; the workspace holds them afterwards
+  void witness_search(uint32_t u, uint32_t v, WeightT limit)
+  {
+    _ws.reset(_out.size());
+    _ws.set_distance(u, WeightT());
+    _ws.push(u);
+    uint32_t settled = 0;
+    while (!_ws.empty() && settled < CH_WITNESS_SETTLED_LIMIT)
+    {
+      uint32_t x = _ws.top(); _ws.pop();
+      WeightT  d = _ws.distance(x);
+      if (d > limit)
+        break;
+      ++settled;
+      for (arc_index_t a : _out[x])
+      {
+        const arc_t& e = _arcs[a];
+        if (e.head == v)
+          continue;
+        WeightT nd = d + e.weight;
+        if (nd < _ws.distance(e.head)) {
+          bool queued = _ws.reached(e.head);
+          _ws.set_distance(e.head, nd);
+          if (queued) _ws.update(e.head); else _ws.push(e.head);
+        }
+      }
+    }
+  }
+
+  // shortcuts contracting v needs, appended to shortcuts when given
+  size_t shortcuts_for(uint32_t v, std::vector<arc_t>* shortcuts)
+  {
+    size_t count = 0;
+    WeightT max_out = WeightT();
+    for (arc_index_t b : _out[v])
+      max_out = std::max(max_out, _arcs[b].weight);
+
+    for (arc_index_t a : _in[v])
+    {
+      const arc_t in = _arcs[a];
+      witness_search(in.tail, v, in.weight + max_out);
+      for (arc_index_t b : _out[v])
+      {
+        const arc_t& out = _arcs[b];
+        if (out.head == in.tail)
+          continue;
+        WeightT via = in.weight + out.weight;
+        if (_ws.distance(out.head) <= via)
+          continue; // witness found
+        ++count;
+        if (shortcuts)
+          shortcuts->push_back(arc_t{in.tail, out.head, a, b, via});
+      }
+    }
+    return count;
+  }
+
+  int64_t compute_priority(uint32_t v)
+  {
+    int64_t added   = shortcuts_for(v, nullptr);
+    int64_t removed = _in[v].size() + _out[v].size();
+    return 2 * (added - removed) + _neighbours[v] + _level[v];
+  }
+
+  // ranks v above the nodes contracted so far, returns its
+  // uncontracted neighbours
+  std::vector<uint32_t> contract(uint32_t v)
+  {
+    std::vector<arc_t> shortcuts;
+    shortcuts_for(v, &shortcuts);
+
+    // arcs left at v lead to higher ranked nodes
+    _up[v]   = _out[v];
+    _down[v] = _in[v];
+
+    std::vector<uint32_t> neighbours;
+    for (arc_index_t a : _out[v]) {
+      erase(_in[_arcs[a].head], a);
+      neighbours.push_back(_arcs[a].head);
+    }
+    for (arc_index_t a : _in[v]) {
+      erase(_out[_arcs[a].tail], a);
+      neighbours.push_back(_arcs[a].tail);
+    }
+    _out[v].clear(); _out[v].shrink_to_fit();
+    _in[v].clear();  _in[v].shrink_to_fit();
+    _contracted[v] = true;
+
+    for (const arc_t& s : shortcuts)
+      if (insert(s))
+        ++_n_shortcuts;
+
+    std::sort(neighbours.begin(), neighbours.end());
+    neighbours.erase(
+      std::unique(neighbours.begin(), neighbours.end()), neighbours.end());
+    for (uint32_t w : neighbours) {
+      ++_neighbours[w];
+      _level[w] = std::max(_level[w], _level[v] + 1);
+    }
+    return neighbours;
+  }
+
+  std::vector<arc_t>                     _arcs;
+  std::vector<std::vector<arc_index_t> > _out;         // arcs among uncontracted nodes
+  std::vector<std::vector<arc_index_t> > _in;
+  std::vector<std::vector<arc_index_t> > _up;          // arcs to higher ranked nodes
+  std::vector<std::vector<arc_index_t> > _down;        // arcs from higher ranked nodes
+  std::vector<bool>                      _contracted;
+  std::vector<uint32_t>                  _level;
+  std::vector<uint32_t>                  _neighbours;  // contracted neighbours
+  workspace_t                            _ws;
+  size_t                                 _n_shortcuts;
+
+};
+
+} // namespace gol
+
+#endif // GOL_GRAPH_NODE_CONTRACTION_H_
@@ -0,0 +1,287 @@
+// This file is part of Sii-Mobility - Algorithms Optimized Delivering.
+//
+// Copyright (C) 2017 GOL Lab http://webgol.dinfo.unifi.it/ - University of Florence
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with This program.  If not, see <http://www.gnu.org/licenses/>.
+
+#ifndef GOL_GRAPH_OVERLAY_H_
+#define GOL_GRAPH_OVERLAY_H_
+
+// std
+#include <vector>
+#include <limits>
+#include <atomic>
+#include <thread>
+#include <type_traits>
+#include <stdint.h>
+// boost
+#include <boost/graph/graph_traits.hpp>
+
+#include "../exception.h"
+#include "graph_flat_array.h"
+#include "graph_image.h"
+#include "graph_search_workspace.h"
+#include "graph_multilevel_partition.h"
+
+namespace gol {
+
+// Dijkstra on the overlay of a multilevel partition. level_of(v) is the
+// level v is scanned at, none for the vertices the search must not
+// enter: at level 0 all the edges leaving v are relaxed, at level l the
+// clique row of v (when it is an entry of its level l cell) and the
+// edges leaving the cell. The search ends once stop(v) holds for a
+// settled vertex v, parents in the workspace are overlay steps.
+template <
+  typename GraphT, 
+  typename WeightMap, 
+  typename WeightT, 
+  typename LevelOf, 
+  typename Workspace, 
+  typename Stop>
+void overlay_search(
+    const GraphT&                 g, 
+    const multilevel_partition_t& p, 
+    const WeightT*                cliques,
+    const WeightMap&              weight, 
+    uint32_t                      s, 
+    LevelOf                       level_of, 
+    Workspace&                    ws, 
+    Stop                          stop)
+{
+  const uint32_t none     = multilevel_partition_t::none;
+  const WeightT  infinity = std::numeric_limits<WeightT>::max();
+
+  auto relax = [&ws](uint32_t x, uint32_t y, WeightT d) {
+    if (d < ws.distance(y)) {
+      bool queued = ws.reached(y);
+      ws.set_distance(y, d);
+      ws.set_parent(y, x);
+      if (queued) ws.update(y); else ws.push(y);
+    }
+  };
+
+  ws.set_distance(s, WeightT());
+  ws.push(s);
+  while (!ws.empty())
+  {
+    uint32_t x = ws.top(); ws.pop();
+    if (stop(x))
+      return;
+    const uint32_t l  = level_of(x);
+    const WeightT  dx = ws.distance(x);
+
+    if (l > 0 && p.entry_pos(l, x) != none)
+    {
+      const uint32_t c  = p.cell(l, x);
+      auto           ex = p.exits(l, c);
+      const WeightT* row = cliques + p.clique_offset(l, c) + 
+        uint64_t(p.entry_pos(l, x)) * (ex.second - ex.first);
+      for (auto it = ex.first; it != ex.second; ++it, ++row)
+        if (*row != infinity && level_of(*it) != none)
+          relax(x, *it, dx + *row);
+    }
+
+    auto r = boost::out_edges(x, g);
+    for (auto it = r.first; it != r.second; ++it)
+    {
+      uint32_t y = boost::target(*it, g);
+      if (l > 0 && p.cell(l, y) == p.cell(l, x))
+        continue; // inside the cell, covered by its clique
+      if (level_of(y) == none)
+        continue;
+      relax(x, y, dx + get(weight, *it));
+    }
+  }
+}
+
+// Metric of a multilevel partition for one weight profile: for every
+// cell the distances from each of its entries to each of its exits
+// through the cell, infinite when there is no such path. Cheap to
+// rebuild compared to a hierarchy, the partition is not touched.
+template <typename WeightT>
+class overlay_metric_t
+{
+ public:
+  typedef WeightT weight_type;
+
+  overlay_metric_t(): _cliques() {}
+
+  const WeightT* cliques() const { return _cliques.data(); }
+
+  // bottom-up, cells of a level are independent and customized by
+  // concurrent workers reading the cliques of the level below
+  template <typename GraphT, typename WeightMap>
+  void customize(
+      const GraphT&                 g, 
+      const multilevel_partition_t& p, 
+      const WeightMap&              weight)
+  {
+    std::vector<WeightT> cliques(
+      p.clique_size(), std::numeric_limits<WeightT>::max());
+    const unsigned n_workers = 
+      std::max(1u, std::thread::hardware_concurrency());
+
+    for (uint32_t l = 1; l <= p.num_levels(); ++l)
+    {
+      const uint32_t n_cells = p.num_cells(l);
+      std::atomic<uint32_t> next(0);
+      auto worker = [&]() {
+        search_workspace<uint32_t, WeightT> ws;
+        for (uint32_t c = next++; c < n_cells; c = next++)
+          customize_cell(g, p, weight, l, c, cliques.data(), ws);
+      };
+      std::vector<std::thread> pool;
+      for (unsigned i = 1; i < std::min<unsigned>(n_workers, n_cells); ++i)
+        pool.emplace_back(worker);
+      worker();
+      for (auto& t : pool)
+        t.join();
+    }
+    _cliques = flat_array<WeightT>(std::move(cliques));
+  }
+
+  void save(graph_image_writer& w, std::string prefix) const {
+    w.add(prefix + ".cliques", _cliques); }
+
+  void map(
+      const graph_image&            img, 
+      std::string                   prefix, 
+      const multilevel_partition_t& p)
+  {
+    flat_array<WeightT> cliques = img.section<WeightT>(prefix + ".cliques");
+    if (cliques.size() != p.clique_size())
+      throw data_exception(
+        "overlay_metric_t::map(): inconsistent image " + prefix);
+    _cliques = std::move(cliques);
+  }
+
+  size_t memory_usage() const { return _cliques.memory_usage(); }
+
+ private:
+  // one search per entry confined to the cell, on the level l - 1 
+  // overlay of it
+  template <typename GraphT, typename WeightMap, typename Workspace>
+  static void customize_cell(
+      const GraphT&                 g, 
+      const multilevel_partition_t& p, 
+      const WeightMap&              weight,
+      uint32_t                      l, 
+      uint32_t                      c, 
+      WeightT*                      cliques, 
+      Workspace&                    ws)
+  {
+    auto en = p.entries(l, c);
+    auto ex = p.exits(l, c);
+    const uint32_t n_exits = ex.second - ex.first;
+    if (n_exits == 0)
+      return;
+
+    auto level_of = [&p, l, c](uint32_t v) {
+      return p.cell(l, v) == c ? l - 1 : multilevel_partition_t::none; };
+
+    WeightT* row = cliques + p.clique_offset(l, c);
+    for (auto u = en.first; u != en.second; ++u, row += n_exits)
+    {
+      uint32_t remaining = n_exits;
+      ws.reset(p.num_vertices());
+      overlay_search(g, p, cliques, weight, *u, level_of, ws, 
+        [&](uint32_t x) { 
+          return p.exit_pos(l, x) != multilevel_partition_t::none && 
+                 --remaining == 0; });
+      for (uint32_t j = 0; j < n_exits; ++j)
+        row[j] = ws.distance(ex.first[j]);
+    }
+  }
+
+  flat_array<WeightT> _cliques;
+
+};
+
+// Base graph seen through the overlay of one metric, handed to the
+// solvers in place of the base graph; vertices and reported edges are
+// the base ones.
+template <typename GraphT, typename WeightT>
+class overlay_graph_t
+{
+ public:
+  typedef overlay_metric_t<WeightT>                metric_t;
+
+  typedef typename GraphT::vertex_descriptor       vertex_descriptor;
+  typedef typename GraphT::edge_descriptor         edge_descriptor;
+  typedef boost::directed_tag                      directed_category;
+  typedef boost::allow_parallel_edge_tag           edge_parallel_category;
+  typedef boost::incidence_graph_tag               traversal_category;
+
+  overlay_graph_t(
+      const GraphT&                 g, 
+      const multilevel_partition_t& p, 
+      const metric_t&               m):
+      _g(&g),
+      _p(&p),
+      _m(&m) {}
+
+  static vertex_descriptor null_vertex() {
+    return GraphT::null_vertex(); }
+
+  const GraphT&                 base()      const { return *_g; }
+  const multilevel_partition_t& partition() const { return *_p; }
+  const metric_t&               metric()    const { return *_m; }
+
+  auto operator[](vertex_descriptor v) const -> decltype(std::declval<const GraphT&>()[v]) {
+    return (*_g)[v]; }
+  auto operator[](edge_descriptor e) const -> decltype(std::declval<const GraphT&>()[e]) {
+    return (*_g)[e]; }
+
+ private:
+  const GraphT*                 _g;
+  const multilevel_partition_t* _p;
+  const metric_t*               _m;
+
+};
+
+template <typename T>
+struct is_overlay_graph: std::false_type {};
+
+template <typename GraphT, typename WeightT>
+struct is_overlay_graph<overlay_graph_t<GraphT, WeightT> >: std::true_type {};
+
+// BGL interface, edges are the base graph ones
+
+template <typename GraphT, typename WeightT>
+inline typename GraphT::vertex_descriptor
+source(typename GraphT::edge_descriptor e,
+       const overlay_graph_t<GraphT, WeightT>& og) {
+  return source(e, og.base()); }
+
+template <typename GraphT, typename WeightT>
+inline typename GraphT::vertex_descriptor
+target(typename GraphT::edge_descriptor e,
+       const overlay_graph_t<GraphT, WeightT>& og) {
+  return target(e, og.base()); }
+
+template <typename GraphT, typename WeightT>
+inline uint32_t num_vertices(const overlay_graph_t<GraphT, WeightT>& og) {
+  return num_vertices(og.base()); }
+
+} // namespace gol
+
+namespace boost {
+
+using gol::source;
+using gol::target;
+using gol::num_vertices;
+
+} // namespace boost
+
+#endif // GOL_GRAPH_OVERLAY_H_
@@ -0,0 +1,68 @@
+// This file is part of Sii-Mobility - Algorithms Optimized Delivering.
+//
+// Copyright (C) 2017 GOL Lab http://webgol.dinfo.unifi.it/ - University of Florence
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with This program.  If not, see <http://www.gnu.org/licenses/>.
+#ifndef GOL_GRAPH_PHANTOM_NODE_H_
+#define GOL_GRAPH_PHANTOM_NODE_H_
+
+// std
+#include <vector>
+#include <limits>
+#include <utility>
+#include <stdint.h>
+
+#include "../utility.h"
+
+namespace gol {
+
+// A point on an edge of a frozen graph where a route starts or ends:
+// at ratio of the slot forward from its source and, when the way is
+// two-way, at 1 - ratio of the slot reverse going the other way.
+// Searches start from, or end at, the ends of these slots with the 
+// weight of the part of the slot between them and the point, so no 
+// vertex is added to the graph.
+struct phantom_node
+{
+  static const edge_index_t none = std::numeric_limits<edge_index_t>::max();
+
+  edge_index_t forward;
+  edge_index_t reverse;
+  double       ratio;
+  double       lon;
+  double       lat;
+
+  // the slots through the point, with the ratio of the point on each
+  std::vector<std::pair<edge_index_t, double> > slots() const
+  {
+    std::vector<std::pair<edge_index_t, double> > s(
+      1, std::make_pair(forward, ratio));
+    if (reverse != none)
+      s.push_back(std::make_pair(reverse, 1 - ratio));
+    return s;
+  }
+};
+
+// a slot of a route between phantom nodes, travelled from ratio from
+// to ratio to of its length: a part of it at either end of the route
+struct phantom_leg
+{
+  edge_index_t edge;
+  double       from;
+  double       to;
+};
+
+}  // namespace gol
+
+#endif // GOL_GRAPH_PHANTOM_NODE_H_
@@ -0,0 +1,133 @@
+// This file is part of Sii-Mobility - Algorithms Optimized Delivering.
+//
+// Copyright (C) 2017 GOL Lab http://webgol.dinfo.unifi.it/ - University of Florence
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with This program.  If not, see <http://www.gnu.org/licenses/>.
+
+#ifndef GOL_GRAPH_PRUNING_H_
+#define GOL_GRAPH_PRUNING_H_
+
+#include "../common.h"
+
+namespace gol {
+
+// Pruning predicates for pruning_based_dijkstra_algorithm, built on the
+// query as Pruning(g, s, t). An edge for which operator() returns true
+// is not relaxed, d_v is the tentative distance through that edge.
+// Arc flags and reach bounds fit the same interface once their 
+// preprocessing is available.
+
+// never prunes, the search is a plain Dijkstra
+template <typename GraphT>
+class no_pruning 
+{
+  typedef boost::graph_traits<GraphT>        Traits;
+  typedef typename Traits::vertex_descriptor vertex_descriptor;
+  typedef typename Traits::edge_descriptor   edge_descriptor;
+
+ public:
+  no_pruning(const GraphT&, vertex_descriptor, vertex_descriptor) {}
+
+  template <typename DistanceT>
+  bool operator()(edge_descriptor, DistanceT) const { return false; }
+};
+
+// sum of the distances from the foci s and t of the points on the
+// ellipse kept by the pruning: the periapsis is a share of the focal
+// distance, short queries get a fixed ellipse, see config.h
+template <typename GraphT, typename Vertex>
+double ellipse_bound(const GraphT& g, Vertex s, Vertex t)
+{
+  double focus = 
+    distance(g[s].geo.lon, g[s].geo.lat, g[t].geo.lon, g[t].geo.lat);
+  // ellipse periapsis, peripheral distance from focus on the main axis
+  double periapsis = ELLIPSE_PERIPHERAL_DISTANCE_PERCENT * (focus/100);
+  return focus > ELLIPSE_PRUNING_THRESHOLD ? 
+    focus + 2*periapsis : (1.5)*ELLIPSE_PRUNING_THRESHOLD;
+}
+
+// prunes edges leading out of the ellipse with foci s and t, the same
+// rule used by the bicriterion epsMOA* search. It is a geometric 
+// heuristic: paths leaving the ellipse are lost, see config.h
+template <typename GraphT>
+class ellipse_pruning 
+{
+  typedef boost::graph_traits<GraphT>        Traits;
+  typedef typename Traits::vertex_descriptor vertex_descriptor;
+  typedef typename Traits::edge_descriptor   edge_descriptor;
+
+ public:
+  ellipse_pruning(const GraphT& g, vertex_descriptor s, vertex_descriptor t)
+      : _g(g), _s(s), _t(t), _bound(ellipse_bound(g, s, t)) {}
+
+  template <typename DistanceT>
+  bool operator()(edge_descriptor e, DistanceT) const 
+  {
+    vertex_descriptor v = boost::target(e, _g);
+    return 
+      distance(_g[_s].geo.lon, _g[_s].geo.lat, _g[v].geo.lon, _g[v].geo.lat) +
+      distance(_g[v].geo.lon, _g[v].geo.lat, _g[_t].geo.lon, _g[_t].geo.lat) > 
+        _bound;
+  }
+
+ private:
+  const GraphT&     _g;
+  vertex_descriptor _s;
+  vertex_descriptor _t;
+  double            _bound;   // sum of focal distances on the ellipse
+};
+
+// The vertices within the ellipse of ellipse_pruning, as a bitmask
+// computed once per query. Label-correcting searches reach a vertex
+// through many edges and labels, a bit test replaces the two distances
+// of each. Further filters of the query may erase vertices from it.
+template <typename GraphT>
+class ellipse_region 
+{
+  typedef boost::graph_traits<GraphT>        Traits;
+  typedef typename Traits::vertex_descriptor vertex_descriptor;
+
+ public:
+  ellipse_region(const GraphT& g, vertex_descriptor s, vertex_descriptor t)
+      : _bits((boost::num_vertices(g) + 63) / 64, 0), _size(0) 
+  {
+    double bound = ellipse_bound(g, s, t);
+    for (uint32_t v = 0; v < boost::num_vertices(g); ++v)
+      if (distance(g[s].geo.lon, g[s].geo.lat, g[v].geo.lon, g[v].geo.lat) +
+          distance(g[v].geo.lon, g[v].geo.lat, g[t].geo.lon, g[t].geo.lat) <= 
+            bound)
+        insert(v);
+    insert(s);
+    insert(t);
+  }
+
+  bool contains(uint32_t v) const { 
+    return (_bits[v >> 6] >> (v & 63)) & 1; }
+
+  // vertices in the region
+  uint32_t size() const { return _size; }
+
+  void insert(uint32_t v) {
+    if (!contains(v)) { _bits[v >> 6] |= uint64_t(1) << (v & 63); ++_size; } }
+  void erase(uint32_t v) {
+    if (contains(v))  { _bits[v >> 6] &= ~(uint64_t(1) << (v & 63)); --_size; } }
+
+ private:
+  std::vector<uint64_t> _bits;
+  uint32_t              _size;
+};
+
+} // namespace gol
+
+#endif // GOL_GRAPH_PRUNING_H_
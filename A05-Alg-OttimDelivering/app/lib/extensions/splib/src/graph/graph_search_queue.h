@@ -0,0 +1,338 @@
+// This file is part of Sii-Mobility - Algorithms Optimized Delivering.
+//
+// Copyright (C) 2017 GOL Lab http://webgol.dinfo.unifi.it/ - University of Florence
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with This program.  If not, see <http://www.gnu.org/licenses/>.
+
+#ifndef GOL_GRAPH_SEARCH_QUEUE_H_
+#define GOL_GRAPH_SEARCH_QUEUE_H_
+
+// std
+#include <vector>
+#include <limits>
+#include <utility>
+#include <algorithm>
+#include <functional>
+#include <type_traits>
+#include <cstring>
+#include <stdint.h>
+// boost
+#include <boost/graph/properties.hpp>
+
+namespace gol {
+
+// Priority queues of a search_workspace, ordered by the distance of the
+// keys. A queue keeps its bookkeeping in the queue_pos slot of the
+// workspace entries (npos when the key is not queued), the workspace
+// only calls update() for queued keys whose distance decreased.
+//
+// A policy is a tag with a nested queue<KeyT, DistanceT> template:
+//
+//   dary_heap_queue<D>       indexed D-ary heap with decrease-key
+//   lazy_binary_heap_queue   binary heap of (distance, key) pairs, a
+//                            decrease pushes a copy and stale copies
+//                            are skipped when they surface
+//   radix_heap_queue         monotone radix heap on the bit pattern of
+//                            the distance, lazy like the above; needs
+//                            keys never below the last popped one, as
+//                            in label-setting searches
+
+template <typename KeyT, typename DistanceT>
+struct search_entry
+{
+  typedef boost::default_color_type color_type;
+
+  uint32_t   stamp;
+  uint32_t   queue_pos;
+  KeyT       parent;
+  DistanceT  distance;
+  color_type color;
+};
+
+static const uint32_t search_queue_npos = std::numeric_limits<uint32_t>::max();
+
+template <size_t Arity>
+struct dary_heap_queue
+{
+  template <typename KeyT, typename DistanceT>
+  class queue
+  {
+    typedef std::vector<search_entry<KeyT, DistanceT> > entries_t;
+
+   public:
+    bool   empty() const { return _heap.empty(); }
+    KeyT   top(const entries_t&) const { return _heap.front(); }
+    void   clear()       { _heap.clear(); }
+    size_t memory_usage() const { return _heap.capacity() * sizeof(KeyT); }
+
+    void push(KeyT k, entries_t& e)
+    {
+      _heap.push_back(k);
+      sift_up(_heap.size() - 1, e);
+    }
+
+    void pop(entries_t& e)
+    {
+      e[_heap.front()].queue_pos = search_queue_npos;
+      if (_heap.size() > 1)
+      {
+        _heap.front() = _heap.back();
+        _heap.pop_back();
+        sift_down(0, e);
+      }
+      else
+        _heap.pop_back();
+    }
+
+    void update(KeyT k, entries_t& e) {
+      sift_up(e[k].queue_pos, e); }
+
+   private:
+    static bool less(KeyT a, KeyT b, const entries_t& e) {
+      return e[a].distance < e[b].distance; }
+
+    void place(size_t i, KeyT k, entries_t& e)
+    {
+      _heap[i] = k;
+      e[k].queue_pos = i;
+    }
+
+    void sift_up(size_t i, entries_t& e)
+    {
+      KeyT k = _heap[i];
+      while (i > 0)
+      {
+        size_t p = (i - 1) / Arity;
+        if (!less(k, _heap[p], e))
+          break;
+        place(i, _heap[p], e);
+        i = p;
+      }
+      place(i, k, e);
+    }
+
+    void sift_down(size_t i, entries_t& e)
+    {
+      KeyT   k = _heap[i];
+      size_t n = _heap.size();
+      for (;;)
+      {
+        size_t first = i * Arity + 1;
+        if (first >= n)
+          break;
+        size_t last     = std::min(first + Arity, n);
+        size_t smallest = first;
+        for (size_t c = first + 1; c < last; ++c)
+          if (less(_heap[c], _heap[smallest], e))
+            smallest = c;
+        if (!less(_heap[smallest], k, e))
+          break;
+        place(i, _heap[smallest], e);
+        i = smallest;
+      }
+      place(i, k, e);
+    }
+
+    std::vector<KeyT> _heap;
+  };
+};
+
+struct lazy_binary_heap_queue
+{
+  template <typename KeyT, typename DistanceT>
+  class queue
+  {
+    typedef std::vector<search_entry<KeyT, DistanceT> > entries_t;
+    typedef std::pair<DistanceT, KeyT>                  item_t;
+    typedef std::greater<item_t>                        cmp_t;
+
+   public:
+    bool   empty() const { return _heap.empty(); }
+    KeyT   top(const entries_t&) const { return _heap.front().second; }
+    void   clear()       { _heap.clear(); }
+    size_t memory_usage() const { return _heap.capacity() * sizeof(item_t); }
+
+    void push(KeyT k, entries_t& e)
+    {
+      e[k].queue_pos = 0;
+      update(k, e);
+    }
+
+    void pop(entries_t& e)
+    {
+      e[top(e)].queue_pos = search_queue_npos;
+      std::pop_heap(_heap.begin(), _heap.end(), cmp_t());
+      _heap.pop_back();
+      // copies left behind by decreases, or of keys already popped
+      while (!_heap.empty() && 
+             (e[top(e)].queue_pos == search_queue_npos ||
+              e[top(e)].distance  != _heap.front().first))
+      {
+        std::pop_heap(_heap.begin(), _heap.end(), cmp_t());
+        _heap.pop_back();
+      }
+    }
+
+    void update(KeyT k, entries_t& e)
+    {
+      _heap.push_back(item_t(e[k].distance, k));
+      std::push_heap(_heap.begin(), _heap.end(), cmp_t());
+    }
+
+   private:
+    std::vector<item_t> _heap;
+  };
+};
+
+// order preserving integer image of a non-negative distance: IEEE
+// floating point numbers of the same sign compare as their bits
+template <typename T>
+inline typename std::enable_if<std::is_integral<T>::value, uint64_t>::type
+radix_key(T d) { return uint64_t(d); }
+
+template <typename T>
+inline typename std::enable_if<std::is_floating_point<T>::value, uint64_t>::type
+radix_key(T d)
+{
+  typedef typename std::conditional<
+    sizeof(T) == sizeof(uint32_t), uint32_t, uint64_t>::type bits_t;
+  static_assert(sizeof(T) == sizeof(bits_t), "unsupported distance type");
+  bits_t b;
+  std::memcpy(&b, &d, sizeof(b));
+  return b;
+}
+
+struct radix_heap_queue
+{
+  template <typename KeyT, typename DistanceT>
+  class queue
+  {
+    typedef std::vector<search_entry<KeyT, DistanceT> > entries_t;
+    typedef std::pair<uint64_t, KeyT>                   item_t;
+
+    static const size_t n_buckets = 65;
+
+   public:
+    queue(): _buckets(n_buckets), _last(0), _size(0) {}
+
+    // bucket 0 holds the keys equal to the last extracted one, it is
+    // refilled when the top is asked for: the keys queued by the scan
+    // of the last popped one may still go below the next minimum
+    bool empty() const { return _size == 0; }
+
+    KeyT top(const entries_t& e) const
+    {
+      refill(e);
+      return _buckets[0].back().second;
+    }
+
+    void clear()
+    {
+      for (auto& b : _buckets)
+        b.clear();
+      _last = 0;
+      _size = 0;
+    }
+
+    size_t memory_usage() const
+    {
+      size_t n = 0;
+      for (auto& b : _buckets)
+        n += b.capacity() * sizeof(item_t);
+      return n;
+    }
+
+    void push(KeyT k, entries_t& e)
+    {
+      e[k].queue_pos = 0;
+      ++_size;
+      insert(k, e);
+    }
+
+    void pop(entries_t& e)
+    {
+      e[top(e)].queue_pos = search_queue_npos;
+      _buckets[0].pop_back();
+      --_size;
+    }
+
+    void update(KeyT k, entries_t& e) {
+      insert(k, e); }
+
+   private:
+    // keys below the last popped one (rounding of the bounds of goal
+    // directed searches) are queued as that one
+    void insert(KeyT k, entries_t& e)
+    {
+      uint64_t key = std::max(radix_key(e[k].distance), _last);
+      _buckets[bucket(key)].push_back(item_t(key, k));
+    }
+
+    size_t bucket(uint64_t key) const {
+      return key == _last ? 0 : 64 - __builtin_clzll(key ^ _last); }
+
+    // copies of popped keys are dropped, the copies a decrease left
+    // behind have larger keys than the current one and never surface
+    // before it
+    static bool live(const item_t& x, const entries_t& e) {
+      return e[x.second].queue_pos != search_queue_npos; }
+
+    void refill(const entries_t& e) const
+    {
+      for (;;)
+      {
+        auto& b0 = _buckets[0];
+        while (!b0.empty() && !live(b0.back(), e))
+          b0.pop_back();
+        if (!b0.empty())
+          return;
+
+        size_t i = 1;
+        while (_buckets[i].empty())
+          ++i;
+        auto& bi = _buckets[i];
+        uint64_t m = std::numeric_limits<uint64_t>::max();
+        bool     found = false;
+        for (auto& x : bi)
+          if (live(x, e) && x.first <= m) {
+            m     = x.first;
+            found = true;
+          }
+        if (found)
+        {
+          _last = m;
+          for (auto& x : bi)
+            if (live(x, e))
+              _buckets[bucket(x.first)].push_back(x);
+        }
+        bi.clear();
+      }
+    }
+
+    mutable std::vector<
+      std::vector<item_t> >           _buckets;
+    mutable uint64_t                  _last;
+    size_t                            _size;
+  };
+};
+
+// Picked on point-to-point and one-to-all searches of a road model,
+// vertex and edge-based (src/test/search_queue_benchmark.cc): the
+// policies are within a few percent of each other there, the 4-ary
+// heap has no requirement on the key order.
+typedef dary_heap_queue<4> default_search_queue;
+
+} // namespace gol
+
+#endif // GOL_GRAPH_SEARCH_QUEUE_H_
@@ -0,0 +1,215 @@
+// This file is part of Sii-Mobility - Algorithms Optimized Delivering.
+//
+// Copyright (C) 2017 GOL Lab http://webgol.dinfo.unifi.it/ - University of Florence
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with This program.  If not, see <http://www.gnu.org/licenses/>.
+
+#ifndef GOL_GRAPH_SEARCH_WORKSPACE_H_
+#define GOL_GRAPH_SEARCH_WORKSPACE_H_
+
+// std
+#include <vector>
+#include <limits>
+#include <algorithm>
+#include <stdint.h>
+// boost
+#include <boost/graph/properties.hpp>
+#include <boost/property_map/property_map.hpp>
+
+#include "graph_search_queue.h"
+
+namespace gol {
+
+// Label-setting search state reused by the queries of one thread.
+// Keys are vertices or edge indexes of a search. An entry is valid only
+// when stamped with the current generation: a new search bumps the
+// generation instead of clearing the arrays, unreached keys read as
+// (infinite distance, parent to itself, white). A search costs its
+// search space only.
+//
+// The workspace also holds the priority queue of the search, ordered
+// by distance; QueueT is one of the policies of graph_search_queue.h.
+template <
+  typename KeyT, 
+  typename DistanceT, 
+  typename QueueT = default_search_queue>
+class search_workspace
+{
+  typedef boost::default_color_type                 color_type;
+  typedef boost::color_traits<color_type>           Color;
+  typedef search_entry<KeyT, DistanceT>             entry_t;
+  typedef typename QueueT::template 
+    queue<KeyT, DistanceT>                          queue_t;
+
+  static const uint32_t npos = search_queue_npos;
+
+ public:
+  typedef KeyT      key_type;
+  typedef DistanceT distance_type;
+  typedef QueueT    queue_policy;
+
+  search_workspace(): _entries(), _touched(), _queue(), _generation(0) {}
+
+  // starts a search over keys [0, n)
+  void reset(size_t n)
+  {
+    if (_entries.size() < n)
+      _entries.resize(n, entry_t{0, npos, KeyT(), DistanceT(), Color::white()});
+    if (++_generation == 0)
+    {
+      // wrapped, stamps of past searches would look current
+      for (auto& e : _entries)
+        e.stamp = 0;
+      _generation = 1;
+    }
+    _touched.clear();
+    _queue.clear();
+  }
+
+  bool reached(KeyT k) const {
+    return _entries[k].stamp == _generation; }
+
+  DistanceT distance(KeyT k) const {
+    return reached(k) ? _entries[k].distance
+                      : std::numeric_limits<DistanceT>::max(); }
+
+  KeyT parent(KeyT k) const {
+    return reached(k) ? _entries[k].parent : k; }
+
+  color_type color(KeyT k) const {
+    return reached(k) ? _entries[k].color : Color::white(); }
+
+  void set_distance(KeyT k, DistanceT d) { touch(k).distance = d; }
+  void set_parent(KeyT k, KeyT p)        { touch(k).parent   = p; }
+  void set_color(KeyT k, color_type c)   { touch(k).color    = c; }
+
+  // keys reached by the current search, in reach order
+  const std::vector<KeyT>& touched() const { return _touched; }
+
+  // priority queue
+  bool empty() const { return _queue.empty(); }
+  KeyT top()   const { return _queue.top(_entries); }
+
+  void push(KeyT k)
+  {
+    touch(k);
+    _queue.push(k, _entries);
+  }
+
+  void pop() { _queue.pop(_entries); }
+
+  // restores the queue once the distance of k decreased
+  void update(KeyT k)
+  {
+    if (reached(k) && _entries[k].queue_pos != npos)
+      _queue.update(k, _entries);
+  }
+
+  size_t memory_usage() const
+  {
+    return _entries.capacity() * sizeof(entry_t) +
+           _touched.capacity() * sizeof(KeyT)    +
+           _queue.memory_usage();
+  }
+
+ private:
+  entry_t& touch(KeyT k)
+  {
+    entry_t& e = _entries[k];
+    if (e.stamp != _generation)
+    {
+      e.stamp     = _generation;
+      e.queue_pos = npos;
+      e.parent    = k;
+      e.distance  = std::numeric_limits<DistanceT>::max();
+      e.color     = Color::white();
+      _touched.push_back(k);
+    }
+    return e;
+  }
+
+  std::vector<entry_t> _entries;
+  std::vector<KeyT>    _touched;
+  queue_t              _queue;
+  uint32_t             _generation;
+
+};
+
+// workspace of the calling thread, Tag tells apart workspaces used by
+// one search at the same time (e.g. forward and backward)
+template <
+  typename KeyT, 
+  typename DistanceT, 
+  typename Tag    = void, 
+  typename QueueT = default_search_queue>
+search_workspace<KeyT, DistanceT, QueueT>& thread_search_workspace()
+{
+  static thread_local search_workspace<KeyT, DistanceT, QueueT> ws;
+  return ws;
+}
+
+// read/write property maps over a workspace, for BGL style relax()
+template <typename Workspace>
+struct workspace_distance_map
+{
+  typedef typename Workspace::key_type      key_type;
+  typedef typename Workspace::distance_type value_type;
+  typedef value_type                        reference;
+  typedef boost::read_write_property_map_tag category;
+
+  explicit workspace_distance_map(Workspace& w): ws(&w) {}
+  Workspace* ws;
+};
+
+template <typename Workspace>
+inline typename Workspace::distance_type get(
+    const workspace_distance_map<Workspace>& m,
+    typename Workspace::key_type k) {
+  return m.ws->distance(k); }
+
+template <typename Workspace>
+inline void put(
+    const workspace_distance_map<Workspace>& m,
+    typename Workspace::key_type k,
+    typename Workspace::distance_type d) {
+  m.ws->set_distance(k, d); }
+
+template <typename Workspace>
+struct workspace_predecessor_map
+{
+  typedef typename Workspace::key_type      key_type;
+  typedef typename Workspace::key_type      value_type;
+  typedef value_type                        reference;
+  typedef boost::read_write_property_map_tag category;
+
+  explicit workspace_predecessor_map(Workspace& w): ws(&w) {}
+  Workspace* ws;
+};
+
+template <typename Workspace>
+inline typename Workspace::key_type get(
+    const workspace_predecessor_map<Workspace>& m,
+    typename Workspace::key_type k) {
+  return m.ws->parent(k); }
+
+template <typename Workspace>
+inline void put(
+    const workspace_predecessor_map<Workspace>& m,
+    typename Workspace::key_type k,
+    typename Workspace::key_type p) {
+  m.ws->set_parent(k, p); }
+
+} // namespace gol
+
+#endif // GOL_GRAPH_SEARCH_WORKSPACE_H_
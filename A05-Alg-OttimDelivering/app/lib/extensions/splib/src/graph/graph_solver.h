@@ -18,7 +18,6 @@
 #ifndef GOL_GRAPH_SOLVER_H_
 #define GOL_GRAPH_SOLVER_H_
 
-#include "graph_functionPt_property_map.h"
 #include "graph_weight_function.h"
 #include "graph_heuristic.h"
 #include "graph_model_edge_weight.h"
@@ -44,8 +43,10 @@ class graph_solver
   typedef std::list<std::pair<WeightT, path_t> > graph_solver_result;
  
  public:
+  virtual ~graph_solver() {} 
+
   virtual void solve(
-    WeightFunctionT   weight_functor,
+    WeightFunctionT   weight_function,
     IndexMap          edge_index_map, 
     StoppingCriteriaT stopping_criteria) = 0;
 
@@ -54,13 +55,13 @@ class graph_solver
 
  protected:
   graph_solver(GraphT& g) : _g(g), _stats() {}
-  ~graph_solver() {} 
   
   GraphT&        _g;
   struct stats_t _stats; 
  
  public:
-  optimized_routes get_optimized_routes()
+  // names: string table the edge descs index into
+  optimized_routes get_optimized_routes(const string_table& names)
   {
     optimized_routes opt;
     for (auto length_path_KV : get_result())
@@ -71,12 +72,12 @@ class graph_solver
       {
         route.add_route_edge(
           edge_weight_adaptor<WeightT>::to_length(_g[e].weight),
-          _g[e].properties.highway_value,
-          _g[e].properties.desc,
-          _g[boost::source(e,_g)].id,
+          to_highway_value(_g[e].properties.highway),
+          names[_g[e].properties.desc],
+          std::to_string(_g[boost::source(e,_g)].id),
           _g[boost::source(e,_g)].geo.lon, 
           _g[boost::source(e,_g)].geo.lat,
-          _g[boost::target(e,_g)].id,
+          std::to_string(_g[boost::target(e,_g)].id),
           _g[boost::target(e,_g)].geo.lon, 
           _g[boost::target(e,_g)].geo.lat);
 
@@ -99,9 +100,16 @@ class graph_solver
 } // namespace gol
 
 #include "graph_solver/single_source_single_target_solver.h"
+#include "graph_solver/pruning_single_source_single_target_solver.h"
 #include "graph_solver/single_source_multi_target_solver.h"
 #include "graph_solver/bicriterion_single_source_single_target_solver.h"
 #include "graph_solver/arc_based_single_source_single_target_solver.h"
+#include "graph_solver/bidirectional_single_source_single_target_solver.h"
+#include "graph_solver/arc_based_bidirectional_single_source_single_target_solver.h"
+#include "graph_solver/contraction_hierarchy_solver.h"
+#include "graph_solver/arc_based_contraction_hierarchy_solver.h"
+#include "graph_solver/customizable_route_planning_solver.h"
+#include "graph_solver/alt_solver.h"
 
 
 #endif // GOL_GRAPH_SOLVER_H_
\ No newline at end of file
@@ -0,0 +1,140 @@
+// This file is part of Sii-Mobility - Algorithms Optimized Delivering.
+//
+// Copyright (C) 2017 GOL Lab http://webgol.dinfo.unifi.it/ - University of Florence
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with This program.  If not, see <http://www.gnu.org/licenses/>.
+
+#ifndef GOL_GRAPH_ALT_SOLVER_H_
+#define GOL_GRAPH_ALT_SOLVER_H_
+
+namespace gol {
+
+struct alt_distance_search {};
+struct alt_queue_search {};
+
+/**
+*  GraphT is a landmark graph, the weight function is the one its 
+*  landmark distances were computed with
+*/ 
+template <typename GraphT, 
+          typename WeightT,
+          typename IndexMap,
+          typename SPAlgorithm, 
+          typename WeightFunctionT, 
+          typename StoppingCriteriaT>
+class alt_gsolver :
+  public graph_solver<
+    GraphT, 
+    WeightT,
+    IndexMap, 
+    WeightFunctionT, 
+    StoppingCriteriaT> 
+{
+  typedef graph_solver<
+    GraphT, 
+    WeightT,
+    IndexMap, 
+    WeightFunctionT, 
+    StoppingCriteriaT>                       Base; 
+  typedef boost::graph_traits<GraphT>        Traits;
+  typedef typename Traits::vertex_descriptor vertex_descriptor;
+  typedef typename Traits::edge_descriptor   edge_descriptor; 
+  typedef search_workspace<uint32_t, WeightT> workspace_t;
+  
+  // a type where we will hold shortest path as lists of edges 
+  typedef std::list<edge_descriptor>             path_t;
+  typedef std::list<std::pair<WeightT, path_t> > graph_solver_result;
+
+ public:
+  alt_gsolver( 
+    GraphT&           g,
+    vertex_descriptor source, 
+    vertex_descriptor target):
+        graph_solver<
+            GraphT, 
+            WeightT,
+            IndexMap, 
+            WeightFunctionT, 
+            StoppingCriteriaT>(g),
+        _s(source), 
+        _t(target), 
+        _distance(nullptr),
+        _weight(),
+        _found(false) {}
+  ~alt_gsolver() {}
+    
+  virtual void solve(
+      WeightFunctionT   weight_function,
+      IndexMap          /*edge_index_map,*/, 
+      StoppingCriteriaT stopping_criteria) override 
+  {   
+    _distance = &thread_search_workspace<
+      uint32_t, WeightT, alt_distance_search>();
+    workspace_t& queue = thread_search_workspace<
+      uint32_t, WeightT, alt_queue_search>();
+    _distance->reset(num_vertices(Base::_g));
+    queue.reset(num_vertices(Base::_g));
+    _weight = weight_function;
+
+    landmark_heuristic<
+      typename std::decay<decltype(Base::_g.base())>::type, 
+      WeightT> h(Base::_g.landmarks(), _s, _t, ALT_ACTIVE_LANDMARKS);
+
+    stopping_criteria.stats_initialization( &(Base::_stats) );          
+    _found = SPAlgorithm::compute(
+      Base::_g.base(), _s, _t, h, *_distance, queue, _weight, Base::_stats);
+  }
+    
+  virtual graph_solver_result get_result() override 
+  {
+    if (!_found || _s == _t) {
+      throw solver_exception(
+        "get_result(): Not path to target");
+    }
+
+    // the edge the distance of v came through, among parallel ones
+    path_t path;
+    for (vertex_descriptor v = _t; _distance->parent(v) != v; v = _distance->parent(v)) 
+    {
+      vertex_descriptor u = _distance->parent(v);
+      auto r = boost::out_edges(u, Base::_g.base());
+      auto it = r.first;
+      for (; it != r.second; ++it)
+        if (boost::target(*it, Base::_g.base()) == v &&
+            _distance->distance(u) + get(_weight, *it) == _distance->distance(v))
+          break;
+      if (it == r.second) {
+        throw solver_exception(
+          "get_result(): Edge not found");
+      }
+      path.push_front(*it);
+    }
+
+    graph_solver_result res = {
+      std::make_pair(_distance->distance(_t), path)};
+    return res;
+  }
+    
+ private:
+  vertex_descriptor  _s;
+  vertex_descriptor  _t;
+  workspace_t*       _distance;
+  WeightFunctionT    _weight;
+  bool               _found;
+
+};	
+
+} // namespace gol
+
+#endif // GOL_GRAPH_ALT_SOLVER_H_
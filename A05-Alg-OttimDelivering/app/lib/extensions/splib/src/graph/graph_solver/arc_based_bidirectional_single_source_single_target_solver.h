@@ -0,0 +1,124 @@
+// This file is part of Sii-Mobility - Algorithms Optimized Delivering.
+//
+// Copyright (C) 2017 GOL Lab http://webgol.dinfo.unifi.it/ - University of Florence
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with This program.  If not, see <http://www.gnu.org/licenses/>.
+
+#ifndef GOL_GRAPH_ARCB_BID_SOLVER_H_
+#define GOL_GRAPH_ARCB_BID_SOLVER_H_
+
+namespace gol {
+
+/**
+*  labels are edge indexes, see arc_based_gsolver
+*/ 
+template <typename GraphT, 
+          typename WeightT,
+          typename IndexMap,
+          typename SPAlgorithm, 
+          typename WeightFunctionT, 
+          typename StoppingCriteriaT>
+class arc_based_bidirectional_gsolver :
+  public graph_solver<
+    GraphT, 
+    WeightT,
+    IndexMap, 
+    WeightFunctionT, 
+    StoppingCriteriaT> 
+{
+  typedef graph_solver<
+    GraphT, 
+    WeightT,
+    IndexMap, 
+    WeightFunctionT, 
+    StoppingCriteriaT>                       Base; 
+  typedef boost::graph_traits<GraphT>        Traits;
+  typedef typename Traits::vertex_descriptor vertex_descriptor;
+  typedef typename Traits::edge_descriptor   edge_descriptor; 
+  typedef search_workspace<
+    edge_index_t, WeightT>                   workspace_t;
+  
+  // a type where we will hold shortest path as lists of edges 
+  typedef std::list<edge_descriptor>             path_t;
+  typedef std::list<std::pair<WeightT, path_t> > graph_solver_result;
+
+ public:
+  arc_based_bidirectional_gsolver( 
+    GraphT&           g,
+    vertex_descriptor source, 
+    vertex_descriptor target):
+        graph_solver<
+            GraphT, 
+            WeightT,
+            IndexMap, 
+            WeightFunctionT, 
+            StoppingCriteriaT>(g),
+        _s(source), 
+        _t(target), 
+        _forward(nullptr),
+        _backward(nullptr),
+        _meet(std::numeric_limits<edge_index_t>::max()),
+        _distance(std::numeric_limits<WeightT>::max()) {}
+  ~arc_based_bidirectional_gsolver() {}
+    
+  virtual void solve(
+      WeightFunctionT   weight_function,
+      IndexMap          /*edge_index_map,*/, 
+      StoppingCriteriaT stopping_criteria) override 
+  {   
+    _forward  = &thread_search_workspace<
+      edge_index_t, WeightT, bidirectional_forward_search>();
+    _backward = &thread_search_workspace<
+      edge_index_t, WeightT, bidirectional_backward_search>();
+    _forward->reset(boost::num_edges(Base::_g));
+    _backward->reset(boost::num_edges(Base::_g));
+
+    stopping_criteria.stats_initialization( &(Base::_stats) );          
+    std::tie(_meet, _distance) = SPAlgorithm::compute(
+      Base::_g, _s, _t, *_forward, *_backward, weight_function, Base::_stats);
+  }
+    
+  virtual graph_solver_result get_result() override 
+  {
+    if (_meet == std::numeric_limits<edge_index_t>::max()) {
+      throw solver_exception(
+        "get_result(): Not path to target");
+    }
+
+    // out-edge of s -> meet -> in-edge of t
+    path_t path;
+    edge_index_t idx = _meet;
+    path.push_front(edge_at(idx, Base::_g));
+    for (; _forward->parent(idx) != idx; idx = _forward->parent(idx))
+      path.push_front(edge_at(_forward->parent(idx), Base::_g));
+    for (idx = _meet; _backward->parent(idx) != idx; idx = _backward->parent(idx))
+      path.push_back(edge_at(_backward->parent(idx), Base::_g));
+
+    graph_solver_result res = {std::make_pair(_distance, path)};
+    return res;
+  }
+    
+ private:
+  vertex_descriptor  _s;
+  vertex_descriptor  _t;
+  workspace_t*       _forward;
+  workspace_t*       _backward;
+  edge_index_t       _meet;
+  WeightT            _distance;
+
+};	
+
+} // namespace gol
+
+#endif // GOL_GRAPH_ARCB_BID_SOLVER_H_
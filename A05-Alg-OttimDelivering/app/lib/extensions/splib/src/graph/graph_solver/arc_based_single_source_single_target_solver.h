@@ -46,11 +46,6 @@ class arc_based_gsolver :
   typedef boost::graph_traits<GraphT>        Traits;
   typedef typename Traits::vertex_descriptor vertex_descriptor;
   typedef typename Traits::edge_descriptor   edge_descriptor; 
-  typedef typename Traits::edge_iterator     edge_iterator;  
-  
-  //typedef uint32_t edge_index_t;
-  typedef std::map<edge_index_t, edge_descriptor
-    > EdgeMap;  
   
   // a type where we will hold shortest path as lists of edges 
   typedef std::list<edge_descriptor>             path_t;
@@ -59,7 +54,6 @@ class arc_based_gsolver :
  public:
   arc_based_gsolver( 
     GraphT&           g,
-    EdgeMap&          edgmap, 
     vertex_descriptor source, 
     vertex_descriptor target):
         graph_solver<
@@ -68,36 +62,26 @@ class arc_based_gsolver :
             IndexMap, 
             WeightFunctionT, 
             StoppingCriteriaT>(g),
-        _edgmap(edgmap),    
         _s(source), 
         _t(target), 
-      	_pred_map(), 
-        _distance_map() {}
+      	_ws(nullptr) {}
   ~arc_based_gsolver() {}
     
   virtual void solve(
-      WeightFunctionT   weight_functor,
-      IndexMap          edge_index_map, 
+      WeightFunctionT   weight_function,
+      IndexMap          /*edge_index_map,*/, 
       StoppingCriteriaT stopping_criteria) override 
   {   
-    _pred_map.resize(boost::num_edges(Base::_g));
-    _distance_map.resize(boost::num_edges(Base::_g));    
+    _ws = &thread_search_workspace<edge_index_t, WeightT>();
+    _ws->reset(boost::num_edges(Base::_g));
 
-    typedef typename remove_pointer<WeightFunctionT>::type FunctionT;
-    boost::functionPt_property_map<
-        FunctionT, 
-        edge_descriptor, 
-        WeightT> 
-      weight_function(weight_functor);
     stopping_criteria.stats_initialization( &(Base::_stats) );          
     try 
     {
       SPAlgorithm::compute(
         Base::_g, _s, _t, // h, 
-        _pred_map, 
-        _distance_map,
+        *_ws,
         weight_function,
-        edge_index_map,
         stopping_criteria,
         Base::_stats);
     } 
@@ -119,12 +103,12 @@ class arc_based_gsolver :
     bool            found = false;
 
     in_edge_iterator iei, iei_end;
-    for (tie(iei, iei_end) = boost::in_edges(_t, Base::_g); iei != iei_end; ++iei) {     
-      if (   (_pred_map[Base::_g[*iei].edge_index] != Base::_g[*iei].edge_index) 
+    for (boost::tie(iei, iei_end) = boost::in_edges(_t, Base::_g); iei != iei_end; ++iei) {     
+      if (   (_ws->parent(Base::_g[*iei].edge_index) != Base::_g[*iei].edge_index) 
            && 
-             (_distance_map[Base::_g[*iei].edge_index] < d_t) ) {
+             (_ws->distance(Base::_g[*iei].edge_index) < d_t) ) {
         ie_t  = *iei;
-        d_t   = _distance_map[Base::_g[ie_t].edge_index];  
+        d_t   = _ws->distance(Base::_g[ie_t].edge_index);  
         found = true;
       }
     }
@@ -133,20 +117,17 @@ class arc_based_gsolver :
         "get_result(): Not path to target");
     }
     for ( edge_descriptor e = ie_t; 
-          _pred_map[Base::_g[e].edge_index] != Base::_g[e].edge_index; 
-          e = _edgmap[_pred_map[Base::_g[e].edge_index]] ) 
+          _ws->parent(Base::_g[e].edge_index) != Base::_g[e].edge_index; 
+          e = edge_at(_ws->parent(Base::_g[e].edge_index), Base::_g) ) 
       path.push_front(e);  
 
     // add first edge 
     if (found)
       path.push_front(
-        _edgmap[_pred_map[Base::_g[path.front()].edge_index]]);      
+        edge_at(_ws->parent(Base::_g[path.front()].edge_index), Base::_g));      
     
     graph_solver_result res = 
-        {std::make_pair(_distance_map[Base::_g[ie_t].edge_index], path)};
-
-    _pred_map.clear();
-    _distance_map.clear();
+        {std::make_pair(_ws->distance(Base::_g[ie_t].edge_index), path)};
             
     return res;
   }
@@ -154,9 +135,8 @@ class arc_based_gsolver :
  private:
   vertex_descriptor              _s;
   vertex_descriptor              _t;
-  std::vector<edge_index_t>      _pred_map;
-  std::vector<WeightT>           _distance_map;
-  EdgeMap&                       _edgmap;
+  search_workspace<
+    edge_index_t, WeightT>*       _ws;
 
 };	
 
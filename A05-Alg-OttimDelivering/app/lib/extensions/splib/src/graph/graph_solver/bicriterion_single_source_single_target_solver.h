@@ -70,21 +70,19 @@ class BSP_gsolver:
   ~BSP_gsolver() {}
     
   virtual void solve(
-      WeightFunctionT   weight_functor,
+      WeightFunctionT   weight_function,
       IndexMap          /*edge_index_map,*/,        
       StoppingCriteriaT /*stopping_criteria*/) override 
   {
-    typedef typename remove_pointer<WeightFunctionT>::type FunctionT;   
-    boost::functionPt_property_map<
-        FunctionT,
-        edge_descriptor, 
-        WeightT> 
-      weight_function(weight_functor);
-    heuristic<GraphT, WeightT>* h = new null_heuristic<GraphT, WeightT>(); 
     try
     {  
+      // per query: the ellipse around s and t, less the vertices not 
+      // reaching t within it, and the bounds of both criteria to t
+      ellipse_region<GraphT> region(Base::_g, _s, _t);
+      bicriterion_bound_heuristic<GraphT, WeightT> h(
+        Base::_g, _t, weight_function, region);
       BiSPAlgorithm::compute(
-        Base::_g, _s, _t, *h, 
+        Base::_g, _s, _t, region, h, 
         _pareto_set,
         weight_function,
         Base::_stats);
@@ -93,7 +91,6 @@ class BSP_gsolver:
        //   << left("[solver]", 14)
        //   << e.what(); 
     }     
-    delete h;
 
   }
 
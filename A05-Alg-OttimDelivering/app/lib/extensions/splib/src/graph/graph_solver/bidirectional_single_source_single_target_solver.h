@@ -0,0 +1,146 @@
+// This file is part of Sii-Mobility - Algorithms Optimized Delivering.
+//
+// Copyright (C) 2017 GOL Lab http://webgol.dinfo.unifi.it/ - University of Florence
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with This program.  If not, see <http://www.gnu.org/licenses/>.
+
+#ifndef GOL_GRAPH_BID_SSST_SOLVER_H_
+#define GOL_GRAPH_BID_SSST_SOLVER_H_
+
+namespace gol {
+
+struct bidirectional_forward_search {};
+struct bidirectional_backward_search {};
+
+/**
+*  
+*/ 
+template <typename GraphT, 
+          typename WeightT,
+          typename IndexMap,
+          typename SPAlgorithm, 
+          typename WeightFunctionT, 
+          typename StoppingCriteriaT>
+class bidirectional_gsolver : 
+  public graph_solver<
+    GraphT, 
+    WeightT,
+    IndexMap, 
+    WeightFunctionT, 
+    StoppingCriteriaT> 
+{
+  typedef graph_solver<
+    GraphT, 
+    WeightT,
+    IndexMap, 
+    WeightFunctionT, 
+    StoppingCriteriaT>                       Base; 
+  typedef boost::graph_traits<GraphT>        Traits;
+  typedef typename Traits::vertex_descriptor vertex_descriptor;
+  typedef typename Traits::edge_descriptor   edge_descriptor;
+  typedef search_workspace<
+    vertex_descriptor, WeightT>              workspace_t;
+  
+  // a type where we will hold shortest path as lists of edges 
+  typedef std::list<edge_descriptor>             path_t;
+  typedef std::list<std::pair<WeightT, path_t> > graph_solver_result;
+
+ public:
+  bidirectional_gsolver( 
+    GraphT& g, 
+    vertex_descriptor source, 
+    vertex_descriptor target):
+        graph_solver<
+            GraphT, 
+            WeightT,
+            IndexMap, 
+            WeightFunctionT, 
+            StoppingCriteriaT>(g),
+        _s(source), 
+        _t(target), 
+        _forward(nullptr),
+        _backward(nullptr),
+        _weight(),
+        _meet(GraphT::null_vertex()),
+        _distance(std::numeric_limits<WeightT>::max()) {}
+  ~bidirectional_gsolver() {}
+    
+  virtual void solve(
+      WeightFunctionT   weight_function,
+      IndexMap          /*edge_index_map,*/, 
+      StoppingCriteriaT stopping_criteria) override 
+  {   
+    _forward  = &thread_search_workspace<
+      vertex_descriptor, WeightT, bidirectional_forward_search>();
+    _backward = &thread_search_workspace<
+      vertex_descriptor, WeightT, bidirectional_backward_search>();
+    _forward->reset(boost::num_vertices(Base::_g));
+    _backward->reset(boost::num_vertices(Base::_g));
+    _weight = weight_function;
+
+    stopping_criteria.stats_initialization( &(Base::_stats) );          
+    std::tie(_meet, _distance) = SPAlgorithm::compute(
+      Base::_g, _s, _t, *_forward, *_backward, _weight, Base::_stats);
+  }
+    
+  virtual graph_solver_result get_result() override 
+  {
+    if (_meet == GraphT::null_vertex() || _s == _t) {
+      throw solver_exception(
+        "get_result(): Not path to target");
+    }
+
+    path_t path;
+    for (vertex_descriptor v = _meet; _forward->parent(v) != v; v = _forward->parent(v)) 
+      path.push_front(tight_edge(*_forward, _forward->parent(v), v, false));
+    for (vertex_descriptor v = _meet; _backward->parent(v) != v; v = _backward->parent(v)) 
+      path.push_back(tight_edge(*_backward, _backward->parent(v), v, true));
+
+    graph_solver_result res = {std::make_pair(_distance, path)};
+    return res;
+  }
+    
+ private:
+  // the edge between v and its parent p the label of v came through,
+  // p -> v forward, v -> p backward
+  edge_descriptor tight_edge(
+      const workspace_t& ws, 
+      vertex_descriptor  p, 
+      vertex_descriptor  v, 
+      bool               backward) const
+  {
+    vertex_descriptor tail = backward ? v : p;
+    vertex_descriptor head = backward ? p : v;
+    auto r = boost::out_edges(tail, Base::_g);
+    for (auto it = r.first; it != r.second; ++it)
+      if (boost::target(*it, Base::_g) == head &&
+          ws.distance(p) + get(_weight, *it) == ws.distance(v))
+        return *it;
+    throw solver_exception(
+      "get_result(): Edge not found");
+  }
+
+  vertex_descriptor  _s;
+  vertex_descriptor  _t;
+  workspace_t*       _forward;
+  workspace_t*       _backward;
+  WeightFunctionT    _weight;
+  vertex_descriptor  _meet;
+  WeightT            _distance;
+
+};	
+
+} // namespace gol
+
+#endif // GOL_GRAPH_BID_SSST_SOLVER_H_
@@ -0,0 +1,129 @@
+// This file is part of Sii-Mobility - Algorithms Optimized Delivering.
+//
+// Copyright (C) 2017 GOL Lab http://webgol.dinfo.unifi.it/ - University of Florence
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with This program.  If not, see <http://www.gnu.org/licenses/>.
+
+#ifndef GOL_GRAPH_CH_SOLVER_H_
+#define GOL_GRAPH_CH_SOLVER_H_
+
+namespace gol {
+
+struct ch_forward_search {};
+struct ch_backward_search {};
+
+/**
+*  GraphT is a contraction hierarchy, the weight function and the 
+*  stopping criteria are the ones it was contracted with
+*/ 
+template <typename GraphT, 
+          typename WeightT,
+          typename IndexMap,
+          typename SPAlgorithm, 
+          typename WeightFunctionT, 
+          typename StoppingCriteriaT>
+class ch_gsolver :
+  public graph_solver<
+    GraphT, 
+    WeightT,
+    IndexMap, 
+    WeightFunctionT, 
+    StoppingCriteriaT> 
+{
+  typedef graph_solver<
+    GraphT, 
+    WeightT,
+    IndexMap, 
+    WeightFunctionT, 
+    StoppingCriteriaT>                       Base; 
+  typedef boost::graph_traits<GraphT>        Traits;
+  typedef typename Traits::vertex_descriptor vertex_descriptor;
+  typedef typename Traits::edge_descriptor   edge_descriptor; 
+  typedef search_workspace<uint32_t, WeightT> workspace_t;
+  
+  // a type where we will hold shortest path as lists of edges 
+  typedef std::list<edge_descriptor>             path_t;
+  typedef std::list<std::pair<WeightT, path_t> > graph_solver_result;
+
+ public:
+  ch_gsolver( 
+    GraphT&           g,
+    vertex_descriptor source, 
+    vertex_descriptor target):
+        graph_solver<
+            GraphT, 
+            WeightT,
+            IndexMap, 
+            WeightFunctionT, 
+            StoppingCriteriaT>(g),
+        _s(source), 
+        _t(target), 
+        _forward(nullptr),
+        _backward(nullptr),
+        _meet(GraphT::arc_t::none),
+        _distance(std::numeric_limits<WeightT>::max()) {}
+  ~ch_gsolver() {}
+    
+  virtual void solve(
+      WeightFunctionT   /*weight_function*/,
+      IndexMap          /*edge_index_map,*/, 
+      StoppingCriteriaT stopping_criteria) override 
+  {   
+    _forward  = &thread_search_workspace<
+      uint32_t, WeightT, ch_forward_search>();
+    _backward = &thread_search_workspace<
+      uint32_t, WeightT, ch_backward_search>();
+
+    stopping_criteria.stats_initialization( &(Base::_stats) );          
+    std::tie(_meet, _distance) = SPAlgorithm::compute(
+      Base::_g, 
+      {std::make_pair(_s, WeightT())}, 
+      {std::make_pair(_t, WeightT())},
+      *_forward,
+      *_backward,
+      Base::_stats);
+  }
+    
+  virtual graph_solver_result get_result() override 
+  {
+    std::vector<edge_index_t> slots;
+    if (_meet != GraphT::arc_t::none)
+      SPAlgorithm::unpack_path(
+        Base::_g, _meet, *_forward, *_backward, std::back_inserter(slots));
+    if (slots.empty()) {
+      throw solver_exception(
+        "get_result(): Not path to target");
+    }
+
+    path_t path;
+    for (edge_index_t idx : slots) 
+      path.push_back(edge_at(idx, Base::_g.base()));
+
+    graph_solver_result res = {std::make_pair(_distance, path)};
+    return res;
+  }
+    
+ private:
+  vertex_descriptor  _s;
+  vertex_descriptor  _t;
+  workspace_t*       _forward;
+  workspace_t*       _backward;
+  uint32_t           _meet;
+  WeightT            _distance;
+
+};	
+
+} // namespace gol
+
+#endif // GOL_GRAPH_CH_SOLVER_H_
@@ -0,0 +1,134 @@
+// This file is part of Sii-Mobility - Algorithms Optimized Delivering.
+//
+// Copyright (C) 2017 GOL Lab http://webgol.dinfo.unifi.it/ - University of Florence
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with This program.  If not, see <http://www.gnu.org/licenses/>.
+
+#ifndef GOL_GRAPH_PRUNING_SSST_SOLVER_H_
+#define GOL_GRAPH_PRUNING_SSST_SOLVER_H_
+
+namespace gol {
+
+/**
+*  Single source single target search skipping the edges rejected by
+*  the Pruning predicate, see graph_pruning.h
+*/ 
+template <typename GraphT, 
+          typename WeightT,
+          typename IndexMap,
+          typename SPAlgorithm, 
+          typename Pruning, 
+          typename WeightFunctionT, 
+          typename StoppingCriteriaT>
+class pruning_gsolver : 
+  public graph_solver<
+    GraphT, 
+    WeightT,
+    IndexMap, 
+    WeightFunctionT, 
+    StoppingCriteriaT> 
+{
+  typedef graph_solver<
+    GraphT, 
+    WeightT,
+    IndexMap, 
+    WeightFunctionT, 
+    StoppingCriteriaT>                       Base; 
+  typedef boost::graph_traits<GraphT>        Traits;
+  typedef typename Traits::vertex_descriptor vertex_descriptor;
+  typedef typename Traits::edge_descriptor   edge_descriptor;
+  
+  // a type where we will hold shortest path as lists of edges 
+  typedef std::list<edge_descriptor>             path_t;
+  typedef std::list<std::pair<WeightT, path_t> > graph_solver_result;
+
+ public:
+  pruning_gsolver( 
+    GraphT& g, 
+    vertex_descriptor source, 
+    vertex_descriptor target):
+        graph_solver<
+            GraphT, 
+            WeightT,
+            IndexMap, 
+            WeightFunctionT, 
+            StoppingCriteriaT>(g),
+        _s(source), 
+        _t(target), 
+      	_ws(nullptr) {}
+  ~pruning_gsolver() {}
+    
+  virtual void solve(
+      WeightFunctionT   weight_function,
+      IndexMap          /*edge_index_map,*/, 
+      StoppingCriteriaT stopping_criteria) override 
+  {   
+    _ws = &thread_search_workspace<vertex_descriptor, WeightT>();
+    _ws->reset(boost::num_vertices(Base::_g));
+
+    Pruning pruning(Base::_g, _s, _t);
+    stopping_criteria.stats_initialization( &(Base::_stats) );          
+    try 
+    {
+      SPAlgorithm::compute(
+        Base::_g, _s, _t, // h, 
+        *_ws,
+        weight_function,
+        pruning,
+        stopping_criteria,
+        Base::_stats);
+    } 
+    catch (std::exception& e) {
+       // logger(logWARNING)
+       //   << left("[solver]", 14)
+       //   << e.what(); 
+    }    
+
+  }
+    
+  virtual graph_solver_result get_result() override 
+  {
+    path_t path;
+    if (_ws->parent(_t) == _t) {
+      throw solver_exception(
+        "get_result(): Not path to target");
+    }
+    for (vertex_descriptor v = _t; _ws->parent(v) != v; v = _ws->parent(v)) 
+    {
+      edge_descriptor e; bool found;
+      boost::tie(e, found) = boost::edge(_ws->parent(v), v, (Base::_g));
+      if (found) {
+        path.push_front(e);      
+      } else {
+        throw solver_exception(
+          "get_result(): Edge not found");
+      }
+    }
+    graph_solver_result res = 
+        {std::make_pair(_ws->distance(_t), path)};
+
+    return res;
+  }
+    
+ private:
+  vertex_descriptor              _s;
+  vertex_descriptor              _t;
+  search_workspace<
+    vertex_descriptor, WeightT>*  _ws;
+
+};	
+
+} // namespace gol
+
+#endif // GOL_GRAPH_PRUNING_SSST_SOLVER_H_
\ No newline at end of file
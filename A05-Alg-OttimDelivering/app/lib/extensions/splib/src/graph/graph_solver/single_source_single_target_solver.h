@@ -64,31 +64,23 @@ class SSST_gsolver :
             StoppingCriteriaT>(g),
         _s(source), 
         _t(target), 
-      	_pred_map(), 
-        _distance_map() {}
+      	_ws(nullptr) {}
   ~SSST_gsolver() {}
     
   virtual void solve(
-      WeightFunctionT   weight_functor,
+      WeightFunctionT   weight_function,
       IndexMap          /*edge_index_map,*/, 
       StoppingCriteriaT stopping_criteria) override 
   {   
-    _pred_map.resize(boost::num_vertices(Base::_g));
-    _distance_map.resize(boost::num_vertices(Base::_g));
+    _ws = &thread_search_workspace<vertex_descriptor, WeightT>();
+    _ws->reset(boost::num_vertices(Base::_g));
 
-    typedef typename remove_pointer<WeightFunctionT>::type FunctionT;
-    boost::functionPt_property_map<
-        FunctionT, 
-        edge_descriptor, 
-        WeightT> 
-      weight_function(weight_functor);
     stopping_criteria.stats_initialization( &(Base::_stats) );          
     try 
     {
       SPAlgorithm::compute(
         Base::_g, _s, _t, // h, 
-        _pred_map, 
-        _distance_map,
+        *_ws,
         weight_function,
         stopping_criteria,
         Base::_stats);
@@ -104,14 +96,14 @@ class SSST_gsolver :
   virtual graph_solver_result get_result() override 
   {
     path_t path;
-    if (_pred_map[_t] == _t) {
+    if (_ws->parent(_t) == _t) {
       throw solver_exception(
         "get_result(): Not path to target");
     }
-    for (vertex_descriptor v = _t; _pred_map[v] != v; v = _pred_map[v]) 
+    for (vertex_descriptor v = _t; _ws->parent(v) != v; v = _ws->parent(v)) 
     {
       edge_descriptor e; bool found;
-      boost::tie(e, found) = boost::edge(_pred_map[v], v, (Base::_g));
+      boost::tie(e, found) = boost::edge(_ws->parent(v), v, (Base::_g));
       if (found) {
         path.push_front(e);      
       } else {
@@ -120,10 +112,7 @@ class SSST_gsolver :
       }
     }
     graph_solver_result res = 
-        {std::make_pair(_distance_map[_t], path)};
-
-    _pred_map.clear();
-    _distance_map.clear();
+        {std::make_pair(_ws->distance(_t), path)};
 
     return res;
   }
@@ -131,8 +120,8 @@ class SSST_gsolver :
  private:
   vertex_descriptor              _s;
   vertex_descriptor              _t;
-  std::vector<vertex_descriptor> _pred_map;
-  std::vector<WeightT>           _distance_map; 
+  search_workspace<
+    vertex_descriptor, WeightT>*  _ws;
 
 };	
 
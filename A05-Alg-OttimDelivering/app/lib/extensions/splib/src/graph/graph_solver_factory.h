@@ -25,6 +25,10 @@
 #include <boost/graph/graph_traits.hpp>
 
 #include "graph_edge_weight_traits.h" 
+#include "graph_contraction_hierarchy.h"
+#include "graph_overlay.h"
+#include "graph_landmarks.h"
+#include "graph_pruning.h"
 #include "../algorithm.h"
 #include "graph_solver.h" 
 
@@ -40,11 +44,6 @@ class gsolver_creator
   typedef boost::graph_traits<GraphT> Traits;
   typedef typename Traits::vertex_descriptor 
     vertex_descriptor;
-  typedef typename Traits::edge_descriptor 
-    edge_descriptor;
-  typedef typename Traits::edge_iterator  edge_iterator;  
-  typedef std::map<edge_index_t, edge_descriptor
-  > EdgeMap;            
  public:
 
   virtual graph_solver<
@@ -68,18 +67,6 @@ class gsolver_creator
       std::string algorithm, 
       vertex_descriptor s, 
       std::vector<vertex_descriptor> tvec) { return nullptr; }
-
-  virtual graph_solver<
-    GraphT, 
-    WeightT,
-    IndexMap, 
-    WeightFunctionT, 
-    StoppingCriteriaT>* make_solver(
-      GraphT& g,
-      std::string algorithm,
-      EdgeMap& edgmap, 
-      vertex_descriptor s, 
-      vertex_descriptor t) { return nullptr; }    
   
   virtual ~gsolver_creator() {}
 
@@ -130,6 +117,35 @@ class SSST_gsolver_creator :
         WeightFunctionT, 
         StoppingCriteriaT>(g, s, t);
     }    
+    else if (algorithm == "bidirectional_dijkstra")
+    { 
+      logger(logINFO) 
+        << left("[solver] ", 14) 
+        << "Bidirectional Dijkstra algorithm [ s = " 
+        << g[s].id << ", t = " << g[t].id << " ]";   
+      return new bidirectional_gsolver<
+        GraphT, 
+        WeightT,
+        IndexMap, 
+        bidirectional_dijkstra_algorithm, 
+        WeightFunctionT, 
+        StoppingCriteriaT>(g, s, t);
+    }    
+    else if (algorithm == "ellipse_dijkstra")
+    { 
+      logger(logINFO) 
+        << left("[solver] ", 14) 
+        << "Ellipse Pruning Dijkstra algorithm [ s = " 
+        << g[s].id << ", t = " << g[t].id << " ]";   
+      return new pruning_gsolver<
+        GraphT, 
+        WeightT,
+        IndexMap, 
+        pruning_based_dijkstra_algorithm, 
+        ellipse_pruning<GraphT>, 
+        WeightFunctionT, 
+        StoppingCriteriaT>(g, s, t);
+    }    
     else
       throw solver_exception();  
   }
@@ -152,11 +168,6 @@ class arc_based_gsolver_creator :
   typedef boost::graph_traits<GraphT> Traits;
   typedef typename Traits::vertex_descriptor 
     vertex_descriptor;
-  typedef typename Traits::edge_descriptor 
-    edge_descriptor;
-  typedef typename Traits::edge_iterator  edge_iterator; 
-  typedef std::map<edge_index_t, edge_descriptor
-  > EdgeMap;          
  public:
 
   arc_based_gsolver_creator() {}
@@ -169,8 +180,7 @@ class arc_based_gsolver_creator :
     WeightFunctionT, 
     StoppingCriteriaT>* make_solver(
       GraphT& g,
-      std::string algorithm,
-      EdgeMap& edgmap, 
+      std::string algorithm, 
       vertex_descriptor s, 
       vertex_descriptor t) override 
   {
@@ -186,7 +196,229 @@ class arc_based_gsolver_creator :
         IndexMap, 
         compact_graph_dijkstra_algorithm, 
         WeightFunctionT, 
-        StoppingCriteriaT>(g, edgmap, s, t);
+        StoppingCriteriaT>(g, s, t);
+    }   
+    else if (algorithm == "compact_bidirectional_dijkstra")
+    { 
+      logger(logINFO) 
+        << left("[solver] ", 14) 
+        << "Arc-Based Bidirectional Dijkstra algorithm [ s = " 
+        << g[s].id << ", t = " << g[t].id << " ]";   
+      return new arc_based_bidirectional_gsolver<
+        GraphT, 
+        WeightT,
+        IndexMap, 
+        compact_graph_bidirectional_dijkstra_algorithm, 
+        WeightFunctionT, 
+        StoppingCriteriaT>(g, s, t);
+    }   
+    else
+      throw solver_exception();  
+  }
+
+};
+
+template <typename GraphT, 
+          typename WeightT,
+          typename IndexMap,  
+          typename WeightFunctionT, 
+          typename StoppingCriteriaT>
+class ch_gsolver_creator : 
+  public gsolver_creator<
+    GraphT, 
+    WeightT,
+    IndexMap, 
+    WeightFunctionT, 
+    StoppingCriteriaT>
+{
+  typedef boost::graph_traits<GraphT> Traits;
+  typedef typename Traits::vertex_descriptor 
+    vertex_descriptor;
+ public:
+
+  ch_gsolver_creator() {}
+  ~ch_gsolver_creator() {}
+ 
+  virtual graph_solver<
+    GraphT, 
+    WeightT,
+    IndexMap, 
+    WeightFunctionT, 
+    StoppingCriteriaT>* make_solver(
+      GraphT& g,
+      std::string algorithm, 
+      vertex_descriptor s, 
+      vertex_descriptor t) override 
+  {
+    if (algorithm == "ch")
+    { 
+      logger(logINFO) 
+        << left("[solver] ", 14) 
+        << "Contraction Hierarchy algorithm [ s = " 
+        << g[s].id << ", t = " << g[t].id << " ]";   
+      return new ch_gsolver<
+        GraphT, 
+        WeightT,
+        IndexMap, 
+        contraction_hierarchy_algorithm, 
+        WeightFunctionT, 
+        StoppingCriteriaT>(g, s, t);
+    }   
+    else
+      throw solver_exception();  
+  }
+
+};
+
+template <typename GraphT, 
+          typename WeightT,
+          typename IndexMap,  
+          typename WeightFunctionT, 
+          typename StoppingCriteriaT>
+class arc_based_ch_gsolver_creator : 
+  public gsolver_creator<
+    GraphT, 
+    WeightT,
+    IndexMap, 
+    WeightFunctionT, 
+    StoppingCriteriaT>
+{
+  typedef boost::graph_traits<GraphT> Traits;
+  typedef typename Traits::vertex_descriptor 
+    vertex_descriptor;
+ public:
+
+  arc_based_ch_gsolver_creator() {}
+  ~arc_based_ch_gsolver_creator() {}
+ 
+  virtual graph_solver<
+    GraphT, 
+    WeightT,
+    IndexMap, 
+    WeightFunctionT, 
+    StoppingCriteriaT>* make_solver(
+      GraphT& g,
+      std::string algorithm, 
+      vertex_descriptor s, 
+      vertex_descriptor t) override 
+  {
+    if (algorithm == "compact_ch")
+    { 
+      logger(logINFO) 
+        << left("[solver] ", 14) 
+        << "Arc-Based Contraction Hierarchy algorithm [ s = " 
+        << g[s].id << ", t = " << g[t].id << " ]";   
+      return new arc_based_ch_gsolver<
+        GraphT, 
+        WeightT,
+        IndexMap, 
+        contraction_hierarchy_algorithm, 
+        WeightFunctionT, 
+        StoppingCriteriaT>(g, s, t);
+    }   
+    else
+      throw solver_exception();  
+  }
+
+};
+
+template <typename GraphT, 
+          typename WeightT,
+          typename IndexMap,  
+          typename WeightFunctionT, 
+          typename StoppingCriteriaT>
+class crp_gsolver_creator : 
+  public gsolver_creator<
+    GraphT, 
+    WeightT,
+    IndexMap, 
+    WeightFunctionT, 
+    StoppingCriteriaT>
+{
+  typedef boost::graph_traits<GraphT> Traits;
+  typedef typename Traits::vertex_descriptor 
+    vertex_descriptor;
+ public:
+
+  crp_gsolver_creator() {}
+  ~crp_gsolver_creator() {}
+ 
+  virtual graph_solver<
+    GraphT, 
+    WeightT,
+    IndexMap, 
+    WeightFunctionT, 
+    StoppingCriteriaT>* make_solver(
+      GraphT& g,
+      std::string algorithm, 
+      vertex_descriptor s, 
+      vertex_descriptor t) override 
+  {
+    if (algorithm == "crp")
+    { 
+      logger(logINFO) 
+        << left("[solver] ", 14) 
+        << "Customizable Route Planning algorithm [ s = " 
+        << g[s].id << ", t = " << g[t].id << " ]";   
+      return new crp_gsolver<
+        GraphT, 
+        WeightT,
+        IndexMap, 
+        customizable_route_planning_algorithm, 
+        WeightFunctionT, 
+        StoppingCriteriaT>(g, s, t);
+    }   
+    else
+      throw solver_exception();  
+  }
+
+};
+
+template <typename GraphT, 
+          typename WeightT,
+          typename IndexMap,  
+          typename WeightFunctionT, 
+          typename StoppingCriteriaT>
+class alt_gsolver_creator : 
+  public gsolver_creator<
+    GraphT, 
+    WeightT,
+    IndexMap, 
+    WeightFunctionT, 
+    StoppingCriteriaT>
+{
+  typedef boost::graph_traits<GraphT> Traits;
+  typedef typename Traits::vertex_descriptor 
+    vertex_descriptor;
+ public:
+
+  alt_gsolver_creator() {}
+  ~alt_gsolver_creator() {}
+ 
+  virtual graph_solver<
+    GraphT, 
+    WeightT,
+    IndexMap, 
+    WeightFunctionT, 
+    StoppingCriteriaT>* make_solver(
+      GraphT& g,
+      std::string algorithm, 
+      vertex_descriptor s, 
+      vertex_descriptor t) override 
+  {
+    if (algorithm == "alt")
+    { 
+      logger(logINFO) 
+        << left("[solver] ", 14) 
+        << "ALT algorithm [ s = " 
+        << g[s].id << ", t = " << g[t].id << " ]";   
+      return new alt_gsolver<
+        GraphT, 
+        WeightT,
+        IndexMap, 
+        alt_algorithm, 
+        WeightFunctionT, 
+        StoppingCriteriaT>(g, s, t);
     }   
     else
       throw solver_exception();  
@@ -308,11 +540,6 @@ class gsolver_factory
   typedef boost::graph_traits<GraphT> Traits;
   typedef typename Traits::vertex_descriptor 
     vertex_descriptor;
-  typedef typename Traits::edge_descriptor 
-    edge_descriptor;
-  typedef typename Traits::edge_iterator  edge_iterator;  
-  typedef std::map<edge_index_t, edge_descriptor
-  > EdgeMap;   
 
   typedef std::unordered_map< 
     std::string, 
@@ -378,31 +605,6 @@ class gsolver_factory
     return (c->make_solver(g, algorithm, s, tvec));
   }
 
-   graph_solver<
-    GraphT, 
-    WeightT,
-    IndexMap, 
-    WeightFunctionT, 
-    StoppingCriteriaT>* get_solver_for(
-      GraphT&            g,
-      std::string        algorithm,
-      EdgeMap&           edgmap, 
-      vertex_descriptor  s, 
-      vertex_descriptor  t) 
-  {       
-    auto it = _registry.find(algorithm);
-    if (it == _registry.end()) {
-      throw solver_exception("unrecognized solver");
-    }    
-    gsolver_creator<
-      GraphT, 
-      WeightT,
-      IndexMap, 
-      WeightFunctionT, 
-      StoppingCriteriaT>* c = it->second;
-    return (c->make_solver(g, algorithm, edgmap, s, t));
-  } 
-
   void register_creator(
        const std::string& algorithm, 
        gsolver_creator<GraphT, WeightT, IndexMap, WeightFunctionT, StoppingCriteriaT>* ptr)
@@ -446,7 +648,10 @@ template <typename GraphT,
 struct gsolver_registry<GraphT, WeightT, IndexMap, WeightFunctionT, StoppingCriteriaT,
   typename std::enable_if< 
       !(is_tuple_edge_weight<WeightT>::value) && 
-      !(is_pair_edge_weight<WeightT >::value) >::type 
+      !(is_pair_edge_weight<WeightT >::value) &&
+      !(is_contraction_hierarchy<GraphT>::value) &&
+      !(is_overlay_graph<GraphT>::value) &&
+      !(is_landmark_graph<GraphT>::value) >::type 
       >
 { 
   static void register_compatible_solvers(
@@ -466,6 +671,27 @@ struct gsolver_registry<GraphT, WeightT, IndexMap, WeightFunctionT, StoppingCrit
         IndexMap, 
         WeightFunctionT, 
         StoppingCriteriaT>());             
+    f->register_creator("bidirectional_dijkstra", 
+      new SSST_gsolver_creator<
+        GraphT, 
+        WeightT,
+        IndexMap, 
+        WeightFunctionT, 
+        StoppingCriteriaT>());
+    f->register_creator("compact_bidirectional_dijkstra", 
+      new arc_based_gsolver_creator<
+        GraphT, 
+        WeightT,
+        IndexMap, 
+        WeightFunctionT, 
+        StoppingCriteriaT>());
+    f->register_creator("ellipse_dijkstra", 
+      new SSST_gsolver_creator<
+        GraphT, 
+        WeightT,
+        IndexMap, 
+        WeightFunctionT, 
+        StoppingCriteriaT>());
 /*    f->register_creator("turn_restriction_dijkstra", 
       new SSST_gsolver_creator<
         GraphT, 
@@ -482,6 +708,93 @@ struct gsolver_registry<GraphT, WeightT, IndexMap, WeightFunctionT, StoppingCrit
   }
 };
 
+template <typename GraphT, 
+          typename WeightT,
+          typename IndexMap,  
+          typename WeightFunctionT, 
+          typename StoppingCriteriaT>
+struct gsolver_registry<GraphT, WeightT, IndexMap, WeightFunctionT, StoppingCriteriaT,
+  typename std::enable_if< 
+      is_contraction_hierarchy<GraphT>::value &&
+      !(is_edge_based_hierarchy<GraphT>::value) >::type 
+      >
+{ 
+  static void register_compatible_solvers(
+      gsolver_factory<GraphT, WeightT, IndexMap, WeightFunctionT, StoppingCriteriaT>* f)
+  {  
+    f->register_creator("ch", 
+      new ch_gsolver_creator<
+        GraphT, 
+        WeightT,
+        IndexMap, 
+        WeightFunctionT, 
+        StoppingCriteriaT>());
+  }
+};
+
+template <typename GraphT, 
+          typename WeightT,
+          typename IndexMap,  
+          typename WeightFunctionT, 
+          typename StoppingCriteriaT>
+struct gsolver_registry<GraphT, WeightT, IndexMap, WeightFunctionT, StoppingCriteriaT,
+  typename std::enable_if<is_edge_based_hierarchy<GraphT>::value>::type >
+{ 
+  static void register_compatible_solvers(
+      gsolver_factory<GraphT, WeightT, IndexMap, WeightFunctionT, StoppingCriteriaT>* f)
+  {  
+    f->register_creator("compact_ch", 
+      new arc_based_ch_gsolver_creator<
+        GraphT, 
+        WeightT,
+        IndexMap, 
+        WeightFunctionT, 
+        StoppingCriteriaT>());
+  }
+};
+
+template <typename GraphT, 
+          typename WeightT,
+          typename IndexMap,  
+          typename WeightFunctionT, 
+          typename StoppingCriteriaT>
+struct gsolver_registry<GraphT, WeightT, IndexMap, WeightFunctionT, StoppingCriteriaT,
+  typename std::enable_if<is_overlay_graph<GraphT>::value>::type >
+{ 
+  static void register_compatible_solvers(
+      gsolver_factory<GraphT, WeightT, IndexMap, WeightFunctionT, StoppingCriteriaT>* f)
+  {  
+    f->register_creator("crp", 
+      new crp_gsolver_creator<
+        GraphT, 
+        WeightT,
+        IndexMap, 
+        WeightFunctionT, 
+        StoppingCriteriaT>());
+  }
+};
+
+template <typename GraphT, 
+          typename WeightT,
+          typename IndexMap,  
+          typename WeightFunctionT, 
+          typename StoppingCriteriaT>
+struct gsolver_registry<GraphT, WeightT, IndexMap, WeightFunctionT, StoppingCriteriaT,
+  typename std::enable_if<is_landmark_graph<GraphT>::value>::type >
+{ 
+  static void register_compatible_solvers(
+      gsolver_factory<GraphT, WeightT, IndexMap, WeightFunctionT, StoppingCriteriaT>* f)
+  {  
+    f->register_creator("alt", 
+      new alt_gsolver_creator<
+        GraphT, 
+        WeightT,
+        IndexMap, 
+        WeightFunctionT, 
+        StoppingCriteriaT>());
+  }
+};
+
 template <typename GraphT, 
           typename WeightT,
           typename IndexMap,  
@@ -0,0 +1,320 @@
+// This file is part of Sii-Mobility - Algorithms Optimized Delivering.
+//
+// Copyright (C) 2017 GOL Lab http://webgol.dinfo.unifi.it/ - University of Florence
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with This program.  If not, see <http://www.gnu.org/licenses/>.
+#ifndef GOL_GRAPH_SPATIAL_INDEX_H_
+#define GOL_GRAPH_SPATIAL_INDEX_H_
+
+// std
+#include <vector>
+#include <limits>
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <stdint.h>
+// boost
+#include <boost/graph/graph_traits.hpp>
+
+#include "../geo.h"
+#include "../exception.h"
+#include "graph_flat_array.h"
+#include "graph_image.h"
+
+namespace gol {
+
+// Uniform grid over the edges of a frozen graph, to snap coordinates
+// onto it; every vertex a route can reach is the end of an edge.
+// Coordinates are projected to metres around the centre of the graph,
+// equirectangular: over the extent of a model the error is far below
+// the side of a cell. A cell lists the edges crossing it, in compressed
+// sparse row arrays. A query scans rings of cells around the coordinate
+// until no cell of the next ring can hold a nearer edge.
+class spatial_index_t
+{
+  // metres per degree of latitude
+  static constexpr double meridian_degree = 111320.0;
+
+ public:
+  // extent of the grid, the south-west corner is the origin
+  struct grid_t
+  {
+    double   lon0;
+    double   lat0;
+    double   mx;        // metres per degree of longitude
+    double   my;        // metres per degree of latitude
+    double   cell;      // side of a cell (m)
+    uint32_t columns;
+    uint32_t rows;
+  };
+
+  // the point of an edge nearest to a coordinate, at ratio of the
+  // edge from its source
+  struct edge_hit
+  {
+    edge_index_t edge;
+    double       ratio;
+    double       lon;
+    double       lat;
+    double       distance;  // m
+  };
+
+  spatial_index_t():
+      _grid(),
+      _edge_offsets(),
+      _edges() { std::memset(&_grid, 0, sizeof(_grid)); }
+
+  // cells of cell_size (m), coarsened until they are at most about
+  // twice the vertices
+  template <typename GraphT>
+  void build(const GraphT& g, double cell_size)
+  {
+    typedef typename boost::graph_traits<GraphT>::edge_descriptor Edge;
+
+    const uint32_t n = boost::num_vertices(g);
+    const size_t   m = boost::num_edges(g);
+    grid_t grid;
+    std::memset(&grid, 0, sizeof(grid));
+    double lon1 = 0, lat1 = 0;
+    if (n > 0)
+    {
+      grid.lon0 = lon1 = g[0].geo.lon;
+      grid.lat0 = lat1 = g[0].geo.lat;
+    }
+    for (uint32_t v = 1; v < n; ++v)
+    {
+      grid.lon0 = std::min(grid.lon0, g[v].geo.lon);
+      grid.lat0 = std::min(grid.lat0, g[v].geo.lat);
+      lon1      = std::max(lon1, g[v].geo.lon);
+      lat1      = std::max(lat1, g[v].geo.lat);
+    }
+    grid.my   = meridian_degree;
+    grid.mx   = meridian_degree * 
+      std::max(0.01, std::cos(rad((grid.lat0 + lat1) / 2)));
+    grid.cell = cell_size;
+    const double width  = (lon1 - grid.lon0) * grid.mx;
+    const double height = (lat1 - grid.lat0) * grid.my;
+    while ((width / grid.cell + 1) * (height / grid.cell + 1) > 
+           2.0 * n + 1024)
+      grid.cell *= 2;
+    grid.columns = uint32_t(width  / grid.cell) + 1;
+    grid.rows    = uint32_t(height / grid.cell) + 1;
+    _grid = grid;
+
+    // two passes over the cells crossed by every edge, counting them
+    // then filling them
+    const size_t cells = size_t(grid.columns) * grid.rows;
+    std::vector<uint32_t>     edge_offsets(cells + 1, 0);
+    std::vector<edge_index_t> edges;
+    for (int pass = 0; pass < 2; ++pass)
+    {
+      std::vector<uint32_t> next(
+        edge_offsets.begin(), edge_offsets.end() - 1);
+      for (edge_index_t idx = 0; idx < m; ++idx)
+      {
+        Edge e = edge_at(idx, g);
+        const auto& a = g[boost::source(e, g)].geo;
+        const auto& b = g[boost::target(e, g)].geo;
+        crossed_cells(x(a.lon), y(a.lat), x(b.lon), y(b.lat),
+          [&](size_t c) {
+            if (pass == 0) ++edge_offsets[c + 1];
+            else           edges[next[c]++] = idx;
+          });
+      }
+      if (pass == 0)
+      {
+        for (size_t c = 0; c < cells; ++c)
+          edge_offsets[c + 1] += edge_offsets[c];
+        edges.resize(edge_offsets.back());
+      }
+    }
+
+    _edge_offsets = flat_array<uint32_t>(std::move(edge_offsets));
+    _edges        = flat_array<edge_index_t>(std::move(edges));
+  }
+
+  // nearest point of an edge of g accepted by filter(edge index),
+  // within max_distance (m) of (lon, lat), false when there is none
+  template <typename GraphT, typename Filter>
+  bool nearest_edge(
+      const GraphT& g, 
+      double        lon, 
+      double        lat, 
+      double        max_distance,
+      Filter        filter,
+      edge_hit&     hit) const
+  {
+    typedef typename boost::graph_traits<GraphT>::edge_descriptor Edge;
+
+    const double px = x(lon), py = y(lat);
+    double best = max_distance;
+    bool   found = false;
+    scan(px, py, max_distance, best, [&](size_t c) {
+      for (uint32_t i = _edge_offsets[c]; i < _edge_offsets[c + 1]; ++i)
+      {
+        edge_index_t idx = _edges[i];
+        if (!filter(idx))
+          continue;
+        Edge e = edge_at(idx, g);
+        const auto& a = g[boost::source(e, g)].geo;
+        const auto& b = g[boost::target(e, g)].geo;
+        double ax = x(a.lon), ay = y(a.lat);
+        double dx = x(b.lon) - ax, dy = y(b.lat) - ay;
+        double l2 = dx * dx + dy * dy;
+        double t  = l2 > 0 ? 
+          std::min(1.0, std::max(0.0, ((px - ax) * dx + (py - ay) * dy) / l2)) : 0;
+        double d  = std::hypot(ax + t * dx - px, ay + t * dy - py);
+        if (d < best || (d == best && !found)) {
+          best  = d;
+          found = true;
+          hit.edge     = idx;
+          hit.ratio    = t;
+          hit.lon      = a.lon + t * (b.lon - a.lon);
+          hit.lat      = a.lat + t * (b.lat - a.lat);
+          hit.distance = d;
+        }
+      }
+    });
+    return found;
+  }
+
+  template <typename GraphT>
+  bool nearest_edge(
+      const GraphT& g, 
+      double        lon, 
+      double        lat, 
+      double        max_distance,
+      edge_hit&     hit) const
+  {
+    return nearest_edge(
+      g, lon, lat, max_distance, [](edge_index_t) { return true; }, hit);
+  }
+
+  void save(graph_image_writer& w, std::string prefix) const
+  {
+    w.add(prefix + ".grid",         &_grid, 1);
+    w.add(prefix + ".edge_offsets", _edge_offsets);
+    w.add(prefix + ".edges",        _edges);
+  }
+
+  void map(const graph_image& img, std::string prefix)
+  {
+    spatial_index_t s;
+    flat_array<grid_t> grid = img.section<grid_t>(prefix + ".grid");
+    if (grid.size() != 1)
+      throw data_exception(
+        "spatial_index_t::map(): inconsistent image " + prefix);
+    s._grid         = grid[0];
+    s._edge_offsets = img.section<uint32_t>(prefix + ".edge_offsets");
+    s._edges        = img.section<edge_index_t>(prefix + ".edges");
+    const size_t cells = size_t(s._grid.columns) * s._grid.rows;
+    if (s._edge_offsets.size() != cells + 1 ||
+        s._edge_offsets[cells] != s._edges.size())
+      throw data_exception(
+        "spatial_index_t::map(): inconsistent image " + prefix);
+    *this = std::move(s);
+  }
+
+  const grid_t& grid() const { return _grid; }
+
+  size_t memory_usage() const
+  {
+    return _edge_offsets.memory_usage() + _edges.memory_usage();
+  }
+
+ private:
+  double x(double lon) const { return (lon - _grid.lon0) * _grid.mx; }
+  double y(double lat) const { return (lat - _grid.lat0) * _grid.my; }
+
+  // cells of the box of the segment that the segment crosses, by
+  // clipping it to each of them (Liang-Barsky)
+  template <typename F>
+  void crossed_cells(double ax, double ay, double bx, double by, F f) const
+  {
+    const double c = _grid.cell;
+    auto column = [&](double v) { 
+      return int64_t(std::min<double>(_grid.columns - 1, std::max(0.0, v / c))); };
+    auto row    = [&](double v) { 
+      return int64_t(std::min<double>(_grid.rows - 1,    std::max(0.0, v / c))); };
+    const int64_t x0 = column(std::min(ax, bx)), x1 = column(std::max(ax, bx));
+    const int64_t y0 = row(std::min(ay, by)),    y1 = row(std::max(ay, by));
+    const double  dx = bx - ax, dy = by - ay;
+    for (int64_t cy = y0; cy <= y1; ++cy)
+      for (int64_t cx = x0; cx <= x1; ++cx)
+      {
+        if (x0 == x1 || y0 == y1) {   // the segment crosses them all
+          f(size_t(cy) * _grid.columns + cx);
+          continue;
+        }
+        double t0 = 0, t1 = 1;
+        auto clip = [&](double p, double q) {
+          if (p == 0) return q >= 0;
+          double r = q / p;
+          if (p < 0) t0 = std::max(t0, r); else t1 = std::min(t1, r);
+          return t0 <= t1;
+        };
+        if (clip(-dx, ax - cx * c) && clip(dx, (cx + 1) * c - ax) &&
+            clip(-dy, ay - cy * c) && clip(dy, (cy + 1) * c - ay))
+          f(size_t(cy) * _grid.columns + cx);
+      }
+  }
+
+  // visits the cells by rings of growing radius around (px, py), until
+  // best (m) is within the rings visited: a cell r rings away is at 
+  // least r - 1 cells away
+  template <typename F>
+  void scan(double px, double py, double max_distance, 
+            const double& best, F visit) const
+  {
+    if (_grid.columns == 0)
+      return;
+    const double  c  = _grid.cell;
+    const int64_t cx = int64_t(std::floor(px / c));
+    const int64_t cy = int64_t(std::floor(py / c));
+    const int64_t w  = _grid.columns, h = _grid.rows;
+    // rings short of the grid are empty
+    int64_t r = std::max(
+      std::max<int64_t>(0, std::max(-cx, cx - w + 1)),
+      std::max<int64_t>(0, std::max(-cy, cy - h + 1)));
+    const int64_t last = int64_t(std::ceil(max_distance / c)) + 1;
+    for (; r <= last; ++r)
+    {
+      auto cell = [&](int64_t x, int64_t y) {
+        if (x >= 0 && x < w && y >= 0 && y < h)
+          visit(size_t(y) * w + x);
+      };
+      if (r == 0)
+        cell(cx, cy);
+      for (int64_t x = cx - r; r > 0 && x <= cx + r; ++x) {
+        cell(x, cy - r);
+        cell(x, cy + r);
+      }
+      for (int64_t y = cy - r + 1; r > 0 && y < cy + r; ++y) {
+        cell(cx - r, y);
+        cell(cx + r, y);
+      }
+      if (best <= r * c)
+        break;
+    }
+  }
+
+  grid_t                   _grid;
+  flat_array<uint32_t>     _edge_offsets;  // cells + 1
+  flat_array<edge_index_t> _edges;         // edge slots, by cell crossed
+
+};
+
+}  // namespace gol
+
+#endif // GOL_GRAPH_SPATIAL_INDEX_H_
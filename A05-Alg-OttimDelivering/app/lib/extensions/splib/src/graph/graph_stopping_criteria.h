@@ -26,6 +26,16 @@
 
 namespace gol {
 
+// Stopping criteria are Dijkstra visitors whose examine_vertex tells the
+// search loop whether to go on; a loop returns as soon as it gets 
+// stop_search, the labels set so far are left in its workspace. Other
+// events are plain visitor callbacks.
+enum search_control 
+{
+  continue_search = 0,
+  stop_search     = 1
+};
+
 template<typename GraphT>
 class null_stopping_criteria: 
   public boost::default_dijkstra_visitor 
@@ -36,9 +46,9 @@ class null_stopping_criteria:
 
   void stats_initialization(stats_t* pt) {}  
 
-  void examine_vertex(
+  search_control examine_vertex(
       const typename Traits::vertex_descriptor v, 
-      const GraphT& g) {}
+      const GraphT& g) { return continue_search; }
     
 };
 
@@ -61,16 +71,14 @@ class target_dijkstra_stopping_criteria:
       _stats->visited_nodes = 0; 
   }
 
-  void examine_vertex(
+  search_control examine_vertex(
       const typename Traits::vertex_descriptor v, 
       const GraphT& g) 
   {
     if (_stats != nullptr)
     _stats->visited_nodes++;
 
-    if (v == _target) {
-      throw target_found();
-    }
+    return v == _target ? stop_search : continue_search;
   }
 
  private:
@@ -101,7 +109,7 @@ class multi_target_dijkstra_stopping_criteria:
       _stats->visited_nodes = 0; 
   }
     
-  void examine_vertex(
+  search_control examine_vertex(
       const typename Traits::vertex_descriptor v, 
       const GraphT& g) 
   {
@@ -116,11 +124,12 @@ class multi_target_dijkstra_stopping_criteria:
         _targets_found++;
         _targets.erase(_targets.begin() + i);
         if (_targets_found ==_n_targets)
-            throw all_targets_found();
+            return stop_search;
         found = true;
       }
       else i++;
     }
+    return continue_search;
   } 
 
  private:
@@ -133,6 +142,48 @@ class multi_target_dijkstra_stopping_criteria:
     
 };
 
+// visitor that terminates when the search goes beyond a radius, the
+// vertices settled so far are all those within it
+template<typename GraphT, typename Workspace>
+class radius_dijkstra_stopping_criteria: 
+  public boost::default_dijkstra_visitor 
+{
+  typedef boost::graph_traits<GraphT>       Traits;
+  typedef typename Workspace::distance_type Distance;
+ public:
+  radius_dijkstra_stopping_criteria(
+      const Workspace& workspace, 
+      Distance         radius): 
+        _workspace(workspace), 
+        _radius(radius),
+        _stats(nullptr) {}
+  
+  void stats_initialization(stats_t* pt) 
+  { 
+    _stats = pt;
+    if (_stats != nullptr)
+      _stats->visited_nodes = 0; 
+  }
+
+  search_control examine_vertex(
+      const typename Traits::vertex_descriptor v, 
+      const GraphT& /*g*/) 
+  {
+    if (_workspace.distance(v) > _radius)
+      return stop_search;
+
+    if (_stats != nullptr)
+    _stats->visited_nodes++;
+    return continue_search;
+  }
+
+ private:
+  const Workspace& _workspace;
+  Distance         _radius;
+  struct stats_t*  _stats;
+    
+};
+
 //// TODO
 template<typename GraphT, typename WeightT>
 class neighborhood_target_dijkstra_stopping_criteria: 
@@ -155,23 +206,23 @@ class neighborhood_target_dijkstra_stopping_criteria:
         _dmap(dmap),
         _stats() { _stats.visited_nodes = 0; }
     
-  void examine_vertex(
+  search_control examine_vertex(
       const typename boost::graph_traits<GraphT>::vertex_descriptor v, 
       const GraphT& g) 
   {
     _stats.visited_nodes++;
     
     if (_dmap[v] > _radius) 
-      throw target_found(); 
+      return stop_search; 
 
     // WARNING: is a performance problem?
-    auto it = _timetable.stopidx_map.find( g[v].id );
+    auto it = _timetable.stopidx_map.find( std::to_string(g[v].id) );
     if (it != _timetable.stopidx_map.end()) {
       _near_stops.push_back( 
          std::make_pair(
-           g[v].id, (_btime + (int)(_dmap[v] / AVERAGE_WALKING_SPEED)) ));
+           std::to_string(g[v].id), (_btime + (int)(_dmap[v] / AVERAGE_WALKING_SPEED)) ));
     } 
-
+    return continue_search;
   }
 
  private:
@@ -0,0 +1,109 @@
+// This file is part of Sii-Mobility - Algorithms Optimized Delivering.
+//
+// Copyright (C) 2017 GOL Lab http://webgol.dinfo.unifi.it/ - University of Florence
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with This program.  If not, see <http://www.gnu.org/licenses/>.
+
+#ifndef GOL_GRAPH_STRING_TABLE_H_
+#define GOL_GRAPH_STRING_TABLE_H_
+
+// std
+#include <string>
+#include <vector>
+#include <unordered_map>
+
+#include "../exception.h"
+#include "graph_flat_array.h"
+#include "graph_image.h"
+
+namespace gol {
+
+// Deduplicated strings shared by the edges of a graph, edges keep
+// the uint32_t index returned by intern(). Strings are stored back to
+// back in one character array, the lookup index is used only while
+// a model is built.
+class string_table
+{
+ public:
+  typedef uint32_t index_t;
+
+  string_table(): _offsets(1, 0), _chars(), _index() {}
+
+  index_t intern(const std::string& s)
+  {
+    auto it = _index.find(s);
+    if (it != _index.end())
+      return it->second;
+    if (_chars.mapped())
+      throw data_exception("string_table::intern(): mapped table");
+    index_t idx = size();
+    _chars.append(s.begin(), s.end());
+    _offsets.push_back(_chars.size());
+    _index.emplace(s, idx);
+    return idx;
+  }
+
+  std::string operator[](index_t idx) const {
+    return std::string(
+      _chars.data() + _offsets[idx], _offsets[idx + 1] - _offsets[idx]);
+  }
+
+  std::string at(index_t idx) const
+  {
+    if (idx >= size())
+      throw data_exception(
+        "string_table::at(): index out of range " + std::to_string(idx));
+    return (*this)[idx];
+  }
+
+  size_t size() const { return _offsets.size() - 1; }
+
+  void clear() {
+    *this = string_table();
+  }
+
+  // drops the build-time lookup index
+  void seal() {
+    std::unordered_map<std::string, index_t>().swap(_index);
+  }
+
+  size_t memory_usage() const {
+    return _offsets.memory_usage() + _chars.memory_usage();
+  }
+
+  void save(graph_image_writer& w, std::string prefix) const {
+    w.add(prefix + ".offsets", _offsets);
+    w.add(prefix + ".chars",   _chars);
+  }
+
+  void map(const graph_image& img, std::string prefix)
+  {
+    string_table t;
+    t._offsets = img.section<uint32_t>(prefix + ".offsets");
+    t._chars   = img.section<char>(prefix + ".chars");
+    if (t._offsets.empty() || t._offsets[t.size()] != t._chars.size())
+      throw data_exception("string_table::map(): inconsistent image " + prefix);
+    *this = std::move(t);
+  }
+
+ private:
+  flat_array<uint32_t>                     _offsets;
+  flat_array<char>                         _chars;
+  std::unordered_map<std::string, index_t> _index;
+
+};
+
+} // namespace gol
+
+#endif // GOL_GRAPH_STRING_TABLE_H_
@@ -0,0 +1,117 @@
+// This file is part of Sii-Mobility - Algorithms Optimized Delivering.
+//
+// Copyright (C) 2017 GOL Lab http://webgol.dinfo.unifi.it/ - University of Florence
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with This program.  If not, see <http://www.gnu.org/licenses/>.
+
+#ifndef GOL_GRAPH_VERTEX_MAP_H_
+#define GOL_GRAPH_VERTEX_MAP_H_
+
+// std
+#include <vector>
+#include <string>
+#include <algorithm>
+
+#include "../utility.h"
+#include "../exception.h"
+#include "graph_flat_array.h"
+#include "graph_image.h"
+
+namespace gol {
+
+// OSM node id -> vertex index, a sorted array searched by bisection.
+// Builders append junctions with insert() and call sort() once all
+// the junctions are added, lookups are valid only on a sorted map.
+template <typename VertexT>
+class vertex_id_map
+{
+ public:
+  struct value_type
+  {
+    osm_id_t first;
+    VertexT  second;
+  };
+  typedef typename flat_array<value_type>::const_iterator const_iterator;
+
+  vertex_id_map(): _entries() {}
+
+  void insert(osm_id_t id, VertexT v) {
+    _entries.push_back(value_type{id, v});
+  }
+
+  // sorts by id, on duplicated ids the first inserted vertex wins
+  void sort()
+  {
+    std::vector<value_type> entries(_entries.begin(), _entries.end());
+    std::stable_sort(entries.begin(), entries.end(),
+      [](const value_type& a, const value_type& b) {
+        return a.first < b.first; });
+    entries.erase(
+      std::unique(entries.begin(), entries.end(),
+        [](const value_type& a, const value_type& b) {
+          return a.first == b.first; }),
+      entries.end());
+    entries.shrink_to_fit();
+    _entries = flat_array<value_type>(std::move(entries));
+  }
+
+  const_iterator find(osm_id_t id) const
+  {
+    const_iterator it = std::lower_bound(
+      _entries.begin(), _entries.end(), id,
+      [](const value_type& a, osm_id_t k) {
+        return a.first < k; });
+    if (it != _entries.end() && it->first == id)
+      return it;
+    return _entries.end();
+  }
+
+  bool contains(osm_id_t id) const {
+    return find(id) != _entries.end();
+  }
+
+  // vertex of id, throws data_exception for unknown ids
+  VertexT at(osm_id_t id) const
+  {
+    const_iterator it = find(id);
+    if (it == _entries.end())
+      throw data_exception(
+        "vertex_id_map::at(): unknown node " + std::to_string(id));
+    return it->second;
+  }
+
+  const_iterator begin() const { return _entries.begin(); }
+  const_iterator end()   const { return _entries.end(); }
+
+  size_t size() const { return _entries.size(); }
+  void clear() { _entries.clear(); }
+
+  size_t memory_usage() const { return _entries.memory_usage(); }
+
+  void save(graph_image_writer& w, std::string prefix) const {
+    w.add(prefix + ".entries", _entries);
+  }
+
+  void map(const graph_image& img, std::string prefix) {
+    _entries = img.section<value_type>(prefix + ".entries");
+  }
+
+ private:
+  flat_array<value_type> _entries;
+
+};
+
+} // namespace gol
+
+#endif // GOL_GRAPH_VERTEX_MAP_H_
@@ -20,8 +20,10 @@
 
 //std
 #include <functional>
+#include <vector>
 
 #include "graph_edge_weight_adaptor.h"
+#include "../data_extraction/OSM.h"
 
 namespace gol {
 
@@ -42,6 +44,8 @@ public std::unary_function<
   explicit
     generic_weight_functor(GraphT& g, VertexMap& vtxmap): 
         _g(g), _vtxmap(vtxmap) {}     
+  // functors are deleted through this base, see weight_profiles
+  virtual ~generic_weight_functor() {}
 
   virtual 
   WeightT operator()(const edge_descriptor edge) const {
@@ -101,6 +105,56 @@ class weight_function_factory
     return new identity_weight_functor<
         GraphT, VertexMap, WeightT>(g, vtxmap);
   }
+
+  // strategies precomputed into weight profiles when a model is
+  // frozen, the shortest weight function is the model weight itself
+  static
+  std::vector<std::string>
+  get_strategies_for(std::string model)
+  {
+    if (model.find("pedestrian_") != std::string::npos)
+      return {"quietest_pedestrian_weight_function"};
+    if (model.find("road_") != std::string::npos)
+      return {"fastest_road_weight_function"};
+    if (model.find("bicycle_") != std::string::npos)
+      return {"safest_fastest_bicycle_weight_function"};
+    return {};
+  }
+
+  // strategies a contraction hierarchy is built for, among the ones
+  // above and the shortest weight function
+  static
+  std::vector<std::string>
+  get_contracted_strategies_for(std::string model)
+  {
+    if (model.find("pedestrian_") != std::string::npos)
+      return {"shortest_weight_function", "quietest_pedestrian_weight_function"};
+    return {};
+  }
+
+  // strategies an edge-based (turn-aware) contraction hierarchy is
+  // built for, models with turn tables
+  static
+  std::vector<std::string>
+  get_turn_contracted_strategies_for(std::string model)
+  {
+    if (model.find("road_") != std::string::npos)
+      return {"shortest_weight_function", "fastest_road_weight_function"};
+    return {};
+  }
+
+  // strategies landmark distances are computed for, the goal-directed
+  // searches of models whose profiles change too often to contract
+  static
+  std::vector<std::string>
+  get_landmark_strategies_for(std::string model)
+  {
+    if (model.find("pedestrian_") != std::string::npos)
+      return {"shortest_weight_function", "quietest_pedestrian_weight_function"};
+    if (model.find("road_") != std::string::npos)
+      return {"shortest_weight_function", "fastest_road_weight_function"};
+    return {};
+  }
  
  private:
   // always declare assignment operator and default and copy constructor
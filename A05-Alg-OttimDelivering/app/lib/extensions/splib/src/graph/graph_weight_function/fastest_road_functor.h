@@ -72,30 +72,32 @@ public generic_weight_functor<
 
   virtual double operator()(const edge_descriptor edge) const 
   {   
-    std::string hval = 
-      (Base::_g)[edge].properties.highway_value;    
-
     double max_speed = 45; // Km/h
-    
-    if (hval == "motorway"         || 
-        hval == "motorway_link" )
-      max_speed = 130;     
-    if (hval == "trunk"            || 
-        hval == "trunk_link" )
-      max_speed = 90; 
-    if (hval == "primary"          || 
-        hval == "primary_link")
-      max_speed = 70;
-    if (hval == "secondary"        || 
-        hval == "secondary_link")
-      max_speed = 55;         
-    if (hval == "residential"      ||
-        hval == "residential_link" ||
-        hval == "living_street")       // Pedestrians friendly      
-      max_speed = 35;
-    if (hval == "pedestrian"       ||
-        hval == "footway")             
-      max_speed = 15;    
+
+    switch ((Base::_g)[edge].properties.highway)
+    {
+      case highway_motorway:
+      case highway_motorway_link:
+        max_speed = 130; break;
+      case highway_trunk:
+      case highway_trunk_link:
+        max_speed = 90;  break;
+      case highway_primary:
+      case highway_primary_link:
+        max_speed = 70;  break;
+      case highway_secondary:
+      case highway_secondary_link:
+        max_speed = 55;  break;
+      case highway_residential:
+      case highway_residential_link:
+      case highway_living_street:      // Pedestrians friendly
+        max_speed = 35;  break;
+      case highway_pedestrian:
+      case highway_footway:
+        max_speed = 15;  break;
+      default:
+        break;
+    }
 
     return (Base::_g)[edge].weight / (max_speed / 3.6);    
   }
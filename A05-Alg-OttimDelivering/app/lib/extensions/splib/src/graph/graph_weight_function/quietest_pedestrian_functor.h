@@ -43,36 +43,39 @@ public generic_weight_functor<
 
   virtual WeightT operator()(const edge_descriptor edge) const 
   {
-    std::string hval = 
-      (Base::_g)[edge].properties.highway_value;
-
     double priority = 25;
-    //if (hval == "trunk"         || 
-    //    hval == "trunk_link" )
-    //  priority = 50; 
-    if (hval == "primary"       || 
-        hval == "primary_link" )
-      priority = 40;
-    if (hval == "secondary"     || 
-        hval == "secondary_link" )
-      priority = 30;
-    if (hval == "cycleway"      ||
-        hval == "steps"         ||  // Steps on footways
-        hval == "track"         ||  // Dirt roads for mostly agricultural or forestry uses
-        hval == "bridleway"     || 
-        hval == "path"          || 
-        hval == "viaduct"       ||
-        hval == "private"       ||  
-        hval == "via_ferrata")      // For traversing a mountainside   
-      priority = 15;          
-    if (hval == "residential"   ||
-        hval == "living_street" ||  // Pedestrians friendly
-        hval == "residential_link")
-      priority = 10;
-    if (hval == "pedestrian"    ||  // Reserved for pedestrian-only use
-        hval == "footway"       ||  // Used mainly by pedestrians (also allowed for bicycles)
-        hval == "corridor")         // Maps hallway inside of a building 
-      priority = 5;
+
+    switch ((Base::_g)[edge].properties.highway)
+    {
+      //case highway_trunk:
+      //case highway_trunk_link:
+      //  priority = 50; break;
+      case highway_primary:
+      case highway_primary_link:
+        priority = 40; break;
+      case highway_secondary:
+      case highway_secondary_link:
+        priority = 30; break;
+      case highway_cycleway:
+      case highway_steps:          // Steps on footways
+      case highway_track:          // Dirt roads for mostly agricultural or forestry uses
+      case highway_bridleway:
+      case highway_path:
+      case highway_viaduct:
+      case highway_private:
+      case highway_via_ferrata:    // For traversing a mountainside
+        priority = 15; break;
+      case highway_residential:
+      case highway_living_street:  // Pedestrians friendly
+      case highway_residential_link:
+        priority = 10; break;
+      case highway_pedestrian:     // Reserved for pedestrian-only use
+      case highway_footway:        // Used mainly by pedestrians (also allowed for bicycles)
+      case highway_corridor:       // Maps hallway inside of a building
+        priority = 5;  break;
+      default:
+        break;
+    }
 
     return ((Base::_g)[edge].weight) * 
       ( 0.5 + (priority/100) ); // penalty coeff in interval [0.5, 1] 
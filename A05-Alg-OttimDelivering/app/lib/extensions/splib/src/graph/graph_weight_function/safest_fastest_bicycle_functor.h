@@ -109,25 +109,28 @@ public generic_weight_functor<
       ((AVERAGE_BICYCLE_SPEED/3.6) * downhill_speed_multiplier) 
     );
     
-    std::string hval = 
-      (Base::_g)[edge].properties.highway_value;
-
     double priority = 25;
-    //if (hval == "trunk"         || 
-    //    hval == "trunk_link" )
-    //  priority = 50; 
-    if (hval == "primary"       || 
-        hval == "primary_link" )
-      priority = 45;
-    if (hval == "secondary"       || 
-        hval == "secondary_link" )
-      priority = 35;    
-    if (hval == "pedestrian"    ||  // Reserved for pedestrian-only use
-        hval == "steps"         ||  // Steps on footways
-        hval == "corridor"      ||  // Maps hallway inside of a building
-        hval == "trail"         ||  // For cross-country trails
-        hval == "via_ferrata")      // For traversing a mountainside   
-      priority = 30;
+
+    switch ((Base::_g)[edge].properties.highway)
+    {
+      //case highway_trunk:
+      //case highway_trunk_link:
+      //  priority = 50; break;
+      case highway_primary:
+      case highway_primary_link:
+        priority = 45; break;
+      case highway_secondary:
+      case highway_secondary_link:
+        priority = 35; break;
+      case highway_pedestrian:     // Reserved for pedestrian-only use
+      case highway_steps:          // Steps on footways
+      case highway_corridor:       // Maps hallway inside of a building
+      case highway_trail:          // For cross-country trails
+      case highway_via_ferrata:    // For traversing a mountainside
+        priority = 30; break;
+      default:
+        break;
+    }
 
     return std::make_pair(
       std::ceil(travel_time * ( 0.5 + (priority/100))), 
@@ -0,0 +1,133 @@
+// This file is part of Sii-Mobility - Algorithms Optimized Delivering.
+//
+// Copyright (C) 2017 GOL Lab http://webgol.dinfo.unifi.it/ - University of Florence
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with This program.  If not, see <http://www.gnu.org/licenses/>.
+
+#ifndef GOL_GRAPH_WEIGHT_PROFILE_H_
+#define GOL_GRAPH_WEIGHT_PROFILE_H_
+
+// std
+#include <map>
+#include <string>
+#include <vector>
+// boost
+#include <boost/property_map/property_map.hpp>
+
+#include "graph_weight_function.h"
+#include "graph_flat_array.h"
+#include "graph_image.h"
+
+namespace gol {
+
+// A weight profile is the weight function of a strategy evaluated
+// once per edge of a frozen graph and stored by edge index, solvers
+// read it through a plain iterator_property_map.
+template <
+    typename GraphT,
+    typename VertexMap,
+    typename WeightT,
+    typename IndexMap>
+class weight_profiles
+{
+  typedef boost::graph_traits<GraphT>        Traits;
+  typedef typename Traits::edge_iterator     edge_iterator;
+
+ public:
+  typedef boost::iterator_property_map<
+      const WeightT*,
+      IndexMap,
+      WeightT,
+      const WeightT& > weight_map;
+
+  weight_profiles(): _profiles(), _weights() {}
+
+  // profile sharing an existing weight array, e.g. the model weights
+  void alias(std::string strategy, const WeightT* weights) {
+    _profiles[strategy] = weights;
+  }
+
+  void materialize(std::string strategy, GraphT& g, VertexMap& vtxmap)
+  {
+    generic_weight_functor<GraphT, VertexMap, WeightT>* functor =
+      weight_function_factory<GraphT, VertexMap, WeightT>::get_functor_for(
+        strategy, g, vtxmap);
+
+    std::vector<WeightT> w(boost::num_edges(g));
+
+    IndexMap index = boost::get(boost::edge_index, g);
+    edge_iterator ei, ei_end;
+    for (boost::tie(ei, ei_end) = boost::edges(g); ei != ei_end; ++ei)
+      w[boost::get(index, *ei)] = (*functor)(*ei);
+    delete functor;
+
+    _weights[strategy] = flat_array<WeightT>(std::move(w));
+    _profiles[strategy] = _weights[strategy].data();
+  }
+
+  // profile replaced by weights given by edge index, e.g. live traffic
+  void assign(std::string strategy, std::vector<WeightT> weights)
+  {
+    _weights[strategy] = flat_array<WeightT>(std::move(weights));
+    _profiles[strategy] = _weights[strategy].data();
+  }
+
+  // materialized profiles only, aliases are not written
+  void save(graph_image_writer& w, std::string prefix) const {
+    for (auto& kv : _weights)
+      w.add(prefix + "." + kv.first, kv.second);
+  }
+
+  void map(const graph_image& img, std::string prefix, std::string strategy)
+  {
+    _weights[strategy] = 
+      img.section<WeightT>(prefix + "." + strategy);
+    _profiles[strategy] = _weights[strategy].data();
+  }
+
+  bool contains(std::string strategy) const {
+    return _profiles.find(strategy) != _profiles.end();
+  }
+
+  weight_map get(std::string strategy, const GraphT& g) const
+  {
+    auto it = _profiles.find(strategy);
+    if (it == _profiles.end())
+      throw solver_exception(
+        "weight_profiles::get(): unknown profile " + strategy);
+    return weight_map(it->second, boost::get(boost::edge_index, g));
+  }
+
+  void clear() {
+    _profiles.clear();
+    _weights.clear();
+  }
+
+  size_t memory_usage() const
+  {
+    size_t bytes = 0;
+    for (auto& kv : _weights)
+      bytes += kv.second.memory_usage();
+    return bytes;
+  }
+
+ private:
+  std::map<std::string, const WeightT*>       _profiles;
+  std::map<std::string, flat_array<WeightT> > _weights;
+
+};
+
+} // namespace gol
+
+#endif // GOL_GRAPH_WEIGHT_PROFILE_H_
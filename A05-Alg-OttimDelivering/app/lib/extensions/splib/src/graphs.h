@@ -20,7 +20,9 @@
 
 namespace gol {
 
-// TODO: optimizing space memory
+// Edge attributes are dictionary encoded: the highway class is a
+// highway_Kt and the street name an index into the string table of
+// the graph, see generic_edge_weighted_graph_t::_names.
 
 struct extra_vertex_properties 
 {
@@ -34,15 +36,15 @@ struct extra_vertex_properties
 
 struct extra_edge_properties 
 {
-  std::string highway_value;
-  std::string desc;
+  highway_Kt            highway = highway_nd;
+  string_table::index_t desc    = 0;
 
   friend class boost::serialization::access;
     template<class Archive>
     void serialize(Archive & ar, const unsigned int version) 
     {
       ar & 
-        BOOST_SERIALIZATION_NVP(highway_value) &
+        BOOST_SERIALIZATION_NVP(highway) &
         BOOST_SERIALIZATION_NVP(desc);
     }   
 };  	
@@ -61,15 +63,15 @@ struct pedestrian_extra_vertex_properties
 
 struct pedestrian_extra_edge_properties 
 {
-  std::string highway_value;
-  std::string desc;
+  highway_Kt            highway = highway_nd;
+  string_table::index_t desc    = 0;
 
   friend class boost::serialization::access;
     template<class Archive>
     void serialize(Archive & ar, const unsigned int version) 
     {
       ar & 
-        BOOST_SERIALIZATION_NVP(highway_value) &
+        BOOST_SERIALIZATION_NVP(highway) &
         BOOST_SERIALIZATION_NVP(desc);
     }   
 };  
@@ -94,15 +96,15 @@ struct road_extra_vertex_properties
 
 struct road_extra_edge_properties 
 {
-  std::string highway_value;
-  std::string desc;
+  highway_Kt            highway = highway_nd;
+  string_table::index_t desc    = 0;
 
   friend class boost::serialization::access;
     template<class Archive>
     void serialize(Archive & ar, const unsigned int version) 
     {
-      ar &       
-        BOOST_SERIALIZATION_NVP(highway_value) &
+      ar & 
+        BOOST_SERIALIZATION_NVP(highway) &
         BOOST_SERIALIZATION_NVP(desc);
     }   
 };
@@ -113,6 +115,14 @@ typedef generic_edge_weighted_graph_t <
       double 
 > road_graphT; 
 
+// Bicycle graph, two criteria by edge: see bicriterion_bicycle_model
+
+typedef generic_edge_weighted_graph_t <
+      extra_vertex_properties,
+      extra_edge_properties,
+      int, int 
+> bicycle_graphT; 
+
 } // namespace gol
 
 #endif // GOL_GRAPHS_H_
\ No newline at end of file
@@ -232,11 +232,13 @@ struct label_Rt
 
 struct data_Rt 
 {
-  uint8_t   n_rounds;
-  time_Rt*  minimun_arrival_times;            // the best arrival times
-  label_Rt* round_earliest_arrival_times;     // all raptor states
-  bitset_t* marked_stops;                     // used to track which routes might have changed during each round
+  uint8_t   n_rounds                     = 0;
+  uint32_t  n_stops                      = 0; // stops the state blocks were allocated for
+  time_Rt*  minimun_arrival_times        = nullptr; // the best arrival times
+  label_Rt* round_earliest_arrival_times = nullptr; // all raptor states
+  bitset_t* marked_stops                 = nullptr; // used to track which routes might have changed during each round
    
+  std::vector<uint32_t>        reached;       // stops whose states were written by the last query
   std::vector<uint32_t>        sources;       // stops were reached from road-origin
   std::vector<uint32_t>        targets;       // stops were reached from road-destination          
   std::map<uint32_t,/*ridx*/ 
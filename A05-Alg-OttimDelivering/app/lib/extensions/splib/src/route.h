@@ -127,6 +127,10 @@ class Route
 
   std::list<route_edge> get_edges() {return _edges;}
 
+  // appends the edges of r, e.g. the next leg of a tour
+  void append(const Route& r) {
+    _edges.insert(_edges.end(), r._edges.begin(), r._edges.end()); }
+
   std::string get_begin_id()
   {
     std::string id;
@@ -269,6 +273,90 @@ private:
 
 };
 
+// travel costs from origins (rows) to destinations (columns), row-major:
+// weight by the strategy of the request, length (m) and duration (s)
+// of the path of least weight; infinite when unreachable. The weight
+// counts every edge of the path, compact_ch and compact_dijkstra leave
+// the first edge free: on models with turn tables a cell may weigh more
+// than the cost of their route, and follow another path
+struct distance_matrix
+{
+  std::vector<osm_id_t> sources;
+  std::vector<osm_id_t> targets;
+  std::vector<double>   weights;
+  std::vector<double>   lengths;
+  std::vector<double>   durations;
+
+  size_t at(size_t i, size_t j) const { 
+    return i * targets.size() + j; }
+};
+
+// a route query of a batch: the model and weight function are named as
+// in engine_t, algorithm as in route_optimize; a job with an error 
+// could not be read and fails with it
+struct route_job
+{
+  osm_id_t    source;
+  osm_id_t    target;
+  std::string model;
+  std::string strategy;
+  std::string algorithm;
+  std::string error;
+};
+
+// outcome of a route_job, error holds the reason of a failure
+struct route_result
+{
+  enum status_t 
+  {
+    found      = 0,
+    not_found  = 1,   // no path, or source or target unknown
+    failed     = 2
+  };
+
+  status_t                  status;
+  std::string               error;
+  optimized_routes_solution sol;
+};
+
+// cell of an isochrone grid: south-west corner and least cost at which
+// a point of the cell was reached
+struct isochrone_cell
+{
+  double lon;
+  double lat;
+  double cost;
+};
+
+// area reachable from a source within limit, as the cells of a grid of
+// cell_size (m) holding a reached vertex or a reached stretch of edge.
+// rings outline the union of the cells as closed lon/lat rings, 
+// exteriors counter-clockwise and holes clockwise
+struct isochrone
+{
+  osm_id_t                    source;
+  double                      limit;
+  double                      cell_size;
+  std::vector<isochrone_cell> cells;
+  std::vector<
+    std::vector<std::pair<double, double> > > rings;
+};
+
+// a coordinate snapped onto a model: the point (lon, lat) of the
+// nearest edge, from source to target at ratio of its length, and
+// node, the end of the edge nearer to that point. distance (m) is
+// from the coordinate to the point
+struct snapped_point
+{
+  osm_id_t node;
+  osm_id_t source;
+  osm_id_t target;
+  double   lon;
+  double   lat;
+  double   ratio;
+  double   distance;
+};
+
 
 } // namespace gol
 
@@ -33,8 +33,8 @@ namespace gol {
 class route_planner {
     typedef boost::filesystem::path sys_path;
  public:
-  route_planner(bool updateDB) : 
-    _SPengine(DEFAULT_PBF_OSMFILE, updateDB) {}
+  route_planner(bool updateDB, bool shared = false) : 
+    _SPengine(DEFAULT_PBF_OSMFILE, updateDB, shared) {}
   ~route_planner() {}  
 
   void 
@@ -52,6 +52,10 @@ class route_planner {
     log_policy::get_instance().umtx();
 #endif  
 
+    // OSM node ids, plain or "n" prefixed
+    osm_id_t sid = to_osm_id(source);
+    osm_id_t tid = to_osm_id(target);
+
     optimized_routes_solution* sol =
       new optimized_routes_solution(); 
 
@@ -76,9 +80,9 @@ class route_planner {
         << strategy;
 
       _SPengine.dijkstra_based(
-        "dijkstra",
-        source, 
-        target, 
+        "ch",
+        sid, 
+        tid, 
         request_time,
         model,
         strategy, 
@@ -105,9 +109,9 @@ class route_planner {
         << strategy;
 
       _SPengine.dijkstra_based(
-        "compact_dijkstra",
-        source, 
-        target, 
+        "compact_ch",
+        sid, 
+        tid, 
         request_time,
         model,
         strategy, 
@@ -128,9 +132,10 @@ class route_planner {
       if (optimization.find("safest_fastest_") != std::string::npos)
         strategy = "safest_fastest_bicycle_weight_function";
 
-      engine_t::bicriterion_epsMOA_star(
-        source, 
-        target, 
+      _SPengine.multicriteria_based(
+        "bicriterion_epsMOA_star",
+        sid, 
+        tid, 
         request_time,
         model,
         strategy,          
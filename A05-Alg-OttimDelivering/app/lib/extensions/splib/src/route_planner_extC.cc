@@ -24,23 +24,7 @@ namespace gol {
       std::string mode,
       std::string highway)
   {
-    if (mode == "foot")
-      return (AVERAGE_WALKING_SPEED/(3.6));
-    if (mode == "bike")
-      return (AVERAGE_BICYCLE_SPEED/(3.6));
-    if (mode == "car")
-    {
-      if (highway == "motorway"      ||
-          highway == "motorway_link" )
-        return (MOTORWAY_AVERAGE_CAR_SPEED/(3.6));
-      if (highway == "trunk"         ||
-          highway == "trunk_link"    ||
-          highway == "primary"       ||
-          highway == "primary_link" )
-        return (COUNTRY_AVERAGE_CAR_SPEED/(3.6));
-      //else
-      return (CITY_AVERAGE_CAR_SPEED/(3.6));
-    }
+    return average_speed(mode, to_highway_kind(highway));
   }
 
   Rice::Array
@@ -122,117 +106,544 @@ namespace gol {
     log_policy::get_instance().umtx();
 #endif
 
+    // OSM node ids, plain or "n" prefixed
+    osm_id_t sid = to_osm_id(source);
+    osm_id_t tid = to_osm_id(target);
+
     optimized_routes_solution* sol =
       new optimized_routes_solution();
 
-    if (optimization.find("foot_optimization") != std::string::npos)
-    {
-      logger(logINFO)
-        << left("[*]", 14)
-        << "Foot Optimization >> [s = "
-        << source << ", t = " << target <<"]";
+    // the search touches no Ruby object, the GVL is released and
+    // other Ruby threads run meanwhile
+    without_gvl([&]() {
+      if (optimization.find("foot_optimization") != std::string::npos)
+      {
+        logger(logINFO)
+          << left("[*]", 14)
+          << "Foot Optimization >> [s = "
+          << source << ", t = " << target <<"]";
+
+        std::string model("pedestrian_simplified_model");
+
+        std::string strategy("shortest_weight_function");
+        if (optimization.find("shortest_") != std::string::npos)
+          strategy = "shortest_weight_function";
+        if (optimization.find("quietest_") != std::string::npos)
+          strategy = "quietest_pedestrian_weight_function";
+
+        logger(logINFO)
+          << left("[*]", 14)
+          << "Weight Function: "
+          << strategy;
+
+        _SPengine.dijkstra_based(
+          "ch",
+          sid,
+          tid,
+          request_time,
+          model,
+          strategy,
+          data_graph_path,
+          data_timetable_path,
+          sol);
+      }
+      else if (optimization.find("car_optimization") != std::string::npos)
+      {
+        logger(logINFO)
+          << left("[*]", 14)
+          << "Car Optimization >> [s = "
+          << source << ", t = " << target <<"]";
+
+        std::string model("road_compact_representation_model");
+
+        std::string strategy("shortest_weight_function");
+        if (optimization.find("fastest_") != std::string::npos)
+          strategy = "fastest_road_weight_function";
+
+        logger(logINFO)
+          << left("[*]", 14)
+          << "Weight Function: "
+          << strategy;
+
+        _SPengine.dijkstra_based(
+          "compact_ch",
+          sid,
+          tid,
+          request_time,
+          model,
+          strategy,
+          data_graph_path,
+          data_timetable_path,
+          sol);
+      }
+      else if (optimization.find("bike_optimization") != std::string::npos)
+      {
+        logger(logINFO)
+          << left("[*]", 14)
+          << "Bicycle Optimization >> [s = "
+          << source << ", t = " << target <<"]";
+
+        std::string model("bicriterion_bicycle_model");
+
+        std::string strategy("shortest_weight_function");
+        if (optimization.find("safest_fastest_") != std::string::npos)
+          strategy = "safest_fastest_bicycle_weight_function";
+
+        logger(logINFO)
+          << left("[*]", 14)
+          << "Weight Function: "
+          << strategy;
+
+        _SPengine.multicriteria_based(
+          "bicriterion_epsMOA_star",
+          sid,
+          tid,
+          request_time,
+          model,
+          strategy,
+          data_graph_path,
+          data_timetable_path,
+          sol);
+      }
+  /*    else if (optimization == "public_transit_optimization")
+      {
+        logger(logINFO)
+          << left("[*]", 14)
+          << "Public Transit Optimization >>"
+          << source << ", t = " << target <<"]";
+        engine::dijkstra_raptor(
+          source,
+          target,
+          request_time,
+          data_graph_path,
+          data_timetable_path,
+          500, // source radius
+          500, // target radius
+          sol);
+      }*/
+    });
 
-      std::string model("pedestrian_simplified_model");
+    Rice::Array ret =
+      to_rice(sol, to_rtime(request_time, get_today()), optimization);
+    delete sol;
 
-      std::string strategy("shortest_weight_function");
-      if (optimization.find("shortest_") != std::string::npos)
-        strategy = "shortest_weight_function";
-      if (optimization.find("quietest_") != std::string::npos)
-        strategy = "quietest_pedestrian_weight_function";
+    return ret;
 
-      logger(logINFO)
-        << left("[*]", 14)
-        << "Weight Function: "
-        << strategy;
+  }
 
-      _SPengine.dijkstra_based(
-        "dijkstra",
-        source,
-        target,
-        request_time,
-        model,
-        strategy,
-        data_graph_path,
-        data_timetable_path,
-        sol);
+
+  void
+  route_planner::select_model(
+      std::string  optimization,
+      std::string& model,
+      std::string& strategy)
+  {
+    strategy = "shortest_weight_function";
+    if (optimization.find("foot_optimization") != std::string::npos)
+    {
+      model = "pedestrian_simplified_model";
+      if (optimization.find("quietest_") != std::string::npos)
+        strategy = "quietest_pedestrian_weight_function";
     }
     else if (optimization.find("car_optimization") != std::string::npos)
     {
-      logger(logINFO)
-        << left("[*]", 14)
-        << "Car Optimization >> [s = "
-        << source << ", t = " << target <<"]";
-
-      std::string model("road_compact_representation_model");
-
-      std::string strategy("shortest_weight_function");
+      model = "road_compact_representation_model";
       if (optimization.find("fastest_") != std::string::npos)
         strategy = "fastest_road_weight_function";
+    }
+    else if (optimization.find("bike_optimization") != std::string::npos)
+    {
+      model = "bicriterion_bicycle_model";
+      if (optimization.find("safest_fastest_") != std::string::npos)
+        strategy = "safest_fastest_bicycle_weight_function";
+    }
+    else
+      throw runtime_exception("select_model(): Optimization unknown");
+  }
+
+  std::string
+  route_planner::select_algorithm(
+      std::string model)
+  {
+    if (model.find("road_") != std::string::npos)
+      return "compact_ch";
+    if (model.find("bicycle_") != std::string::npos)
+      return "bicriterion_epsMOA_star";
+    return "ch";
+  }
 
-      logger(logINFO)
-        << left("[*]", 14)
-        << "Weight Function: "
-        << strategy;
+  Rice::Array
+  route_planner::route_optimization_by_coordinates(
+      std::string optimization,
+      double      source_lon,
+      double      source_lat,
+      double      target_lon,
+      double      target_lat,
+      std::string request_time)
+  {
 
+#ifndef NLOG
+    log_policy::get_instance().umtx();
+#endif
+
+    // source and target are snapped onto the model in the engine, the
+    // algorithms are those of route_optimization
+    std::string model, strategy;
+    select_model(optimization, model, strategy);
+    std::string algorithm = select_algorithm(model);
+
+    logger(logINFO)
+      << left("[*]", 14)
+      << "Coordinates Optimization >> [s = "
+      << source_lon << " " << source_lat << ", t = "
+      << target_lon << " " << target_lat << "], "
+      << "Weight Function: "
+      << strategy;
+
+    optimized_routes_solution sol;
+    without_gvl([&]() {
       _SPengine.dijkstra_based(
-        "compact_dijkstra",
-        source,
-        target,
-        request_time,
-        model,
-        strategy,
-        data_graph_path,
-        data_timetable_path,
-        sol);
+        algorithm, source_lon, source_lat, target_lon, target_lat,
+        model, strategy, &sol);
+    });
+
+    return to_rice(&sol, to_rtime(request_time, get_today()), optimization);
+
+  }
+
+  Rice::Object
+  route_planner::nearest(
+      double      lon,
+      double      lat,
+      std::string model)
+  {
+    // model is a model name or an optimization as route_optimization
+    if (model.find("_optimization") != std::string::npos)
+    {
+      std::string strategy;
+      select_model(model, model, strategy);
     }
-/*    else if (optimization.find("bike_optimization") != std::string::npos)
+
+    snapped_point p;
+    bool found = false;
+    without_gvl([&]() {
+      found = _SPengine.nearest(lon, lat, model, &p);
+    });
+    if (!found)
+      return Rice::Nil;
+
+    // node_id is the end of the nearest edge a route from (lon, lat)
+    // leaves from, lon and lat the point of the edge nearest to it
+    Rice::Hash _nearest = Rice::Hash();
+    _nearest[Rice::String("node_id")]             = Rice::String(std::to_string(p.node));
+    _nearest[Rice::String("source_node_id")]      = Rice::String(std::to_string(p.source));
+    _nearest[Rice::String("destination_node_id")] = Rice::String(std::to_string(p.target));
+    _nearest[Rice::String("lon")]                 = to_ruby(p.lon);
+    _nearest[Rice::String("lat")]                 = to_ruby(p.lat);
+    _nearest[Rice::String("ratio")]               = to_ruby(p.ratio);
+    _nearest[Rice::String("distance")]            = to_ruby(p.distance);
+    return _nearest;
+
+  }
+
+  Rice::Array
+  route_planner::route_batch(
+      Rice::Array jobs,
+      std::string request_time)
+  {
+
+#ifndef NLOG
+    log_policy::get_instance().umtx();
+#endif
+
+    // jobs are hashes with an optimization, a source and a target as 
+    // in route_optimization
+    std::vector<route_job> rjobs;
+    for (auto it = jobs.begin(); it != jobs.end(); ++it)
     {
-      logger(logINFO)
-        << left("[*]", 14)
-        << "Safest Bicycle Optimization >>"
-        << source << ", t = " << target <<"]";
+      Rice::Hash _j(*it);
+      route_job  j = route_job();
+      std::string optimization = 
+        Rice::Object(_j[Rice::String("optimization")]).to_s().str();
+      // a bad id or optimization fails its own job only
+      try {
+        j.source = to_osm_id(
+          Rice::Object(_j[Rice::String("source")]).to_s().str());
+        j.target = to_osm_id(
+          Rice::Object(_j[Rice::String("target")]).to_s().str());
+        select_model(optimization, j.model, j.strategy);
+      } catch (std::exception& e) {
+        j.error = e.what();
+      }
+      j.algorithm = select_algorithm(j.model);
+      rjobs.push_back(j);
+    }
 
-      std::string model("bicriterion_bicycle_model");
+    logger(logINFO)
+      << left("[*]", 14)
+      << "Route Batch >> [" << rjobs.size() << " jobs]";
 
-      std::string strategy("shortest_weight_function");
-      if (optimization.find("safest_fastest_") != std::string::npos)
-        strategy = "safest_fastest_bicycle_weight_function";
+    std::vector<route_result> results;
+    without_gvl([&]() {
+      _SPengine.route_batch(rjobs, &results);
+    });
 
-      engine_t::bicriterion_epsMOA_star(
-        source,
-        target,
-        request_time,
-        model,
-        strategy,
-        data_graph_path,
-        data_timetable_path,
-        sol);
+    // a hash per job, in job order: status, error and the routes as
+    // route_optimization returns them
+    static const char* status[] = {"found", "not_found", "failed"};
+    Rice::Array _results = Rice::Array();
+    for (size_t i = 0; i < results.size(); ++i)
+    {
+      Rice::Hash  _j(Rice::Object(jobs[i]));
+      std::string optimization = 
+        Rice::Object(_j[Rice::String("optimization")]).to_s().str();
+
+      Rice::Hash _r = Rice::Hash();
+      _r[Rice::String("status")] = Rice::String(status[results[i].status]);
+      if (results[i].error.empty())
+        _r[Rice::String("error")] = Rice::Nil;
+      else
+        _r[Rice::String("error")] = Rice::String(results[i].error);
+      _r[Rice::String("routes")] = to_rice(
+        &results[i].sol, to_rtime(request_time, get_today()), optimization);
+      _results.push(_r);
     }
-/*    else if (optimization == "public_transit_optimization")
+    return _results;
+
+  }
+
+  Rice::Hash
+  route_planner::distance_matrix(
+      std::string optimization,
+      Rice::Array sources,
+      Rice::Array targets)
+  {
+
+#ifndef NLOG
+    log_policy::get_instance().umtx();
+#endif
+
+    // OSM node ids, plain or "n" prefixed
+    std::vector<osm_id_t> sids, tids;
+    for (auto it = sources.begin(); it != sources.end(); ++it)
+      sids.push_back(to_osm_id(Rice::Object(*it).to_s().str()));
+    for (auto it = targets.begin(); it != targets.end(); ++it)
+      tids.push_back(to_osm_id(Rice::Object(*it).to_s().str()));
+
+    std::string model, strategy;
+    select_model(optimization, model, strategy);
+
+    logger(logINFO)
+      << left("[*]", 14)
+      << "Distance Matrix >> [" 
+      << sids.size() << " x " << tids.size() << "], "
+      << "Weight Function: "
+      << strategy;
+
+    gol::distance_matrix dm;
+    without_gvl([&]() {
+      _SPengine.many_to_many(sids, tids, model, strategy, &dm);
+    });
+
+    // distances in km as route_optimization, durations in seconds,
+    // nil when unreachable
+    Rice::Array _distances = Rice::Array();
+    Rice::Array _durations = Rice::Array();
+    for (size_t i = 0; i < sids.size(); ++i)
     {
-      logger(logINFO)
-        << left("[*]", 14)
-        << "Public Transit Optimization >>"
-        << source << ", t = " << target <<"]";
-      engine::dijkstra_raptor(
-        source,
-        target,
-        request_time,
-        data_graph_path,
-        data_timetable_path,
-        500, // source radius
-        500, // target radius
-        sol);
-    }*/
+      Rice::Array _d = Rice::Array();
+      Rice::Array _t = Rice::Array();
+      for (size_t j = 0; j < tids.size(); ++j)
+      {
+        size_t c = dm.at(i, j);
+        if (std::isinf(dm.lengths[c])) {
+          _d.push(Rice::Nil);
+          _t.push(Rice::Nil);
+        } else {
+          _d.push(to_ruby(dm.lengths[c]/1000));
+          _t.push(to_ruby(dm.durations[c]));
+        }
+      }
+      _distances.push(_d);
+      _durations.push(_t);
+    }
 
-    Rice::Array ret =
-      to_rice(sol, to_rtime(request_time, get_today()), optimization);
-    delete sol;
+    Rice::Hash _matrix = Rice::Hash();
+    _matrix[Rice::String("sources")]   = sources;
+    _matrix[Rice::String("targets")]   = targets;
+    _matrix[Rice::String("distances")] = _distances;
+    _matrix[Rice::String("durations")] = _durations;
+    return _matrix;
 
-    return ret;
+  }
+
+  Rice::Array
+  route_planner::isochrones(
+      std::string optimization,
+      Rice::Array sources,
+      double      minutes,
+      double      cell_size)
+  {
+
+#ifndef NLOG
+    log_policy::get_instance().umtx();
+#endif
+
+    std::vector<osm_id_t> sids;
+    for (auto it = sources.begin(); it != sources.end(); ++it)
+      sids.push_back(to_osm_id(Rice::Object(*it).to_s().str()));
+
+    // reach is by time: cars on the fastest weights (s), pedestrians 
+    // on lengths (m) at walking speed
+    std::string model, strategy;
+    select_model(optimization, model, strategy);
+    double per_second = 1;
+    if (model.find("road_") != std::string::npos)
+      strategy = "fastest_road_weight_function";
+    else {
+      strategy   = "shortest_weight_function";
+      per_second = AVERAGE_WALKING_SPEED / 3.6;
+    }
+
+    logger(logINFO)
+      << left("[*]", 14)
+      << "Isochrones >> [" 
+      << sids.size() << " sources, " << minutes << " min], "
+      << "Weight Function: "
+      << strategy;
+
+    std::vector<isochrone> isos;
+    without_gvl([&]() {
+      _SPengine.isochrones(
+        sids, minutes * 60 * per_second, model, strategy, cell_size, &isos);
+    });
+
+    // a hash per source: cells as [lon, lat, minutes] of their 
+    // south-west corner, rings as arrays of [lon, lat]
+    Rice::Array _isochrones = Rice::Array();
+    for (size_t i = 0; i < isos.size(); ++i)
+    {
+      Rice::Array _cells = Rice::Array();
+      for (const isochrone_cell& c : isos[i].cells)
+      {
+        Rice::Array _c = Rice::Array();
+        _c.push(to_ruby(c.lon));
+        _c.push(to_ruby(c.lat));
+        _c.push(to_ruby(c.cost / per_second / 60));
+        _cells.push(_c);
+      }
+      Rice::Array _rings = Rice::Array();
+      for (auto& ring : isos[i].rings)
+      {
+        Rice::Array _ring = Rice::Array();
+        for (auto& p : ring)
+        {
+          Rice::Array _p = Rice::Array();
+          _p.push(to_ruby(p.first));
+          _p.push(to_ruby(p.second));
+          _ring.push(_p);
+        }
+        _rings.push(_ring);
+      }
+
+      Rice::Hash _iso = Rice::Hash();
+      _iso[Rice::String("source")]    = Rice::Object(sources[i]);
+      _iso[Rice::String("minutes")]   = to_ruby(minutes);
+      _iso[Rice::String("cell_size")] = to_ruby(cell_size);
+      _iso[Rice::String("cells")]     = _cells;
+      _iso[Rice::String("rings")]     = _rings;
+      _isochrones.push(_iso);
+    }
+    return _isochrones;
 
   }
 
+  Rice::Hash
+  route_planner::tour_optimization(
+      std::string optimization,
+      std::string depot,
+      Rice::Array stops,
+      unsigned    vehicles,
+      double      capacity,
+      std::string request_time,
+      double      time_budget)
+  {
+
+#ifndef NLOG
+    log_policy::get_instance().umtx();
+#endif
+
+    // stops are hashes with a node_id and optionally demand and
+    // service, ready and due times in seconds from the departure
+    std::vector<tour_stop> tstops;
+    for (auto it = stops.begin(); it != stops.end(); ++it)
+    {
+      Rice::Hash  _s(*it);
+      tour_stop   s;
+      Rice::Object v = _s[Rice::String("node_id")];
+      s.node = to_osm_id(v.to_s().str());
+      v = _s[Rice::String("demand")];
+      if (!v.is_nil()) s.demand       = from_ruby<double>(v);
+      v = _s[Rice::String("service_time")];
+      if (!v.is_nil()) s.service_time = from_ruby<double>(v);
+      v = _s[Rice::String("ready_time")];
+      if (!v.is_nil()) s.ready_time   = from_ruby<double>(v);
+      v = _s[Rice::String("due_time")];
+      if (!v.is_nil()) s.due_time     = from_ruby<double>(v);
+      tstops.push_back(s);
+    }
+
+    std::string model, strategy;
+    select_model(optimization, model, strategy);
+
+    logger(logINFO)
+      << left("[*]", 14)
+      << "Tour Optimization >> [depot = " << depot << ", "
+      << tstops.size() << " stops, " 
+      << vehicles << " vehicles], "
+      << "Weight Function: "
+      << strategy;
+
+    tour_solution tour;
+    optimized_routes_solution sol;
+    without_gvl([&]() {
+      _SPengine.tour_optimization(
+        to_osm_id(depot), tstops, vehicles, capacity, time_budget,
+        model, strategy, &tour, &sol);
+    });
+
+    // a hash per tour with its stops and its route as in
+    // route_optimization, tours start at request_time
+    Rice::Array _tours = Rice::Array();
+    std::list<Route> routes = sol.get_routes();
+    auto rit = routes.begin();
+    for (size_t k = 0; k < tour.tours.size(); ++k, ++rit)
+    {
+      Rice::Array _stops = Rice::Array();
+      for (uint32_t i : tour.tours[k])
+        _stops.push(Rice::Object(stops[i]));
+
+      optimized_routes_solution leg;
+      leg.insert_route(*rit);
+      Rice::Array _route = 
+        to_rice(&leg, to_rtime(request_time, get_today()), optimization);
+
+      Rice::Hash _tour = Rice::Hash();
+      _tour[Rice::String("stops")] = _stops;
+      _tour[Rice::String("route")] = Rice::Object(_route[0]);
+      _tours.push(_tour);
+    }
+    Rice::Array _unassigned = Rice::Array();
+    for (uint32_t i : tour.unassigned)
+      _unassigned.push(Rice::Object(stops[i]));
+
+    Rice::Hash _solution = Rice::Hash();
+    _solution[Rice::String("tours")]      = _tours;
+    _solution[Rice::String("unassigned")] = _unassigned;
+    _solution[Rice::String("cost")]       = to_ruby(tour.cost);
+    return _solution;
+
+  }
 
 } // namespace gol
 
@@ -240,7 +651,21 @@ extern "C"
 void Init_splib() {
     Rice::Class rb_cRoutePlanner =
       Rice::define_class<gol::route_planner>("RoutePlanner")
-          .define_constructor(Rice::Constructor<gol::route_planner, bool>())
+          .define_constructor(
+             Rice::Constructor<gol::route_planner, bool, bool>(),
+             (Rice::Arg("updateDB"), Rice::Arg("shared") = false))
           //.define_constructor(Rice::Constructor<gol::route_planner, std::string>())
-          .define_method("route_optimization", &gol::route_planner::route_optimization);
+          .define_method("route_optimization", &gol::route_planner::route_optimization)
+          .define_method("route_optimization_by_coordinates", 
+             &gol::route_planner::route_optimization_by_coordinates)
+          .define_method("nearest", &gol::route_planner::nearest)
+          .define_method("route_batch", &gol::route_planner::route_batch)
+          .define_method("distance_matrix", &gol::route_planner::distance_matrix)
+          .define_method("isochrones", &gol::route_planner::isochrones,
+             (Rice::Arg("optimization"), Rice::Arg("sources"), Rice::Arg("minutes"),
+              Rice::Arg("cell_size") = ISOCHRONE_CELL_SIZE))
+          .define_method("tour_optimization", &gol::route_planner::tour_optimization,
+             (Rice::Arg("optimization"), Rice::Arg("depot"), Rice::Arg("stops"),
+              Rice::Arg("vehicles"), Rice::Arg("capacity"), Rice::Arg("request_time"),
+              Rice::Arg("time_budget") = TOUR_TIME_BUDGET));
 }
@@ -21,9 +21,14 @@
 // rice gem
 #include <rice/Class.hpp>
 #include <rice/Constructor.hpp>
+#include <rice/Arg.hpp>
 #include <rice/String.hpp>
 #include <rice/Array.hpp>
 #include <rice/Hash.hpp>
+// ruby
+#include <ruby/thread.h>
+// std
+#include <exception>
 //boost
 #include <boost/filesystem.hpp>
 
@@ -33,14 +38,42 @@
 
 namespace gol {
 
+// Runs f without holding the Ruby global VM lock, f must not touch
+// Ruby objects. Exceptions are carried back and rethrown once the lock
+// is held again.
+template <typename F>
+void without_gvl(F f)
+{
+  struct call_t 
+  {
+    F&                 f;
+    std::exception_ptr error;
+
+    static void* run(void* p) 
+    {
+      call_t* c = static_cast<call_t*>(p);
+      try {
+        c->f();
+      } catch (...) {
+        c->error = std::current_exception();
+      }
+      return nullptr;
+    }
+  } call = { f, nullptr };
+
+  rb_thread_call_without_gvl(&call_t::run, &call, NULL, NULL);
+  if (call.error)
+    std::rethrow_exception(call.error);
+}
+
 /**
 * Route Planner
 */
 class route_planner {
   typedef boost::filesystem::path sys_path;
  public:
-  route_planner(bool updateDB) : 
-    _SPengine(DEFAULT_PBF_OSMFILE, updateDB) {}
+  route_planner(bool updateDB, bool shared = false) : 
+    _SPengine(DEFAULT_PBF_OSMFILE, updateDB, shared) {}
   
   ~route_planner() {}
 
@@ -62,7 +95,60 @@ class route_planner {
       std::string data_graph_path,
       std::string data_timetable_path);
 
+  Rice::Array
+  route_optimization_by_coordinates(
+      std::string optimization,
+      double      source_lon,
+      double      source_lat,
+      double      target_lon,
+      double      target_lat,
+      std::string request_time);
+
+  Rice::Object
+  nearest(
+      double      lon,
+      double      lat,
+      std::string model);
+
+  Rice::Array
+  route_batch(
+      Rice::Array jobs,
+      std::string request_time);
+
+  Rice::Hash
+  distance_matrix(
+      std::string optimization,
+      Rice::Array sources,
+      Rice::Array targets);
+
+  Rice::Array
+  isochrones(
+      std::string optimization,
+      Rice::Array sources,
+      double      minutes,
+      double      cell_size);
+
+  Rice::Hash
+  tour_optimization(
+      std::string optimization,
+      std::string depot,
+      Rice::Array stops,
+      unsigned    vehicles,
+      double      capacity,
+      std::string request_time,
+      double      time_budget);
+
  private:
+  // model and weight function of a foot, car or bike optimization
+  void select_model(
+      std::string  optimization,
+      std::string& model,
+      std::string& strategy);
+
+  // route_optimize algorithm of the model, as in route_optimization
+  std::string select_algorithm(
+      std::string  model);
+
   engine_t _SPengine;
 
 };
@@ -0,0 +1,143 @@
+
+#include <cmath>
+#include <iostream>
+#include <random>
+
+#include "../engine.h"
+
+namespace gol {
+
+// compares the route lengths of a contraction hierarchy and of the
+// Dijkstra it replaces on random OD pairs of a model: compact_ch and
+// compact_dijkstra on the road model, turn restrictions included, ch
+// and dijkstra on the pedestrian model. The end points are snapped
+// from random coordinates of a bounding box. On the shortest weight
+// function the turns cost nothing or are forbidden, so the length of
+// a route is its cost
+template <typename GraphT>
+class ch_validator {
+ public:
+  ch_validator(
+    std::string input,
+    std::string model,
+    std::string ch,
+    std::string dijkstra,
+    double      min_lon,
+    double      min_lat,
+    double      max_lon,
+    double      max_lat):
+      _ch(ch),
+      _dijkstra(dijkstra),
+      _min_lon(min_lon),
+      _min_lat(min_lat),
+      _max_lon(max_lon),
+      _max_lat(max_lat),
+      _g(),
+      _found(0),
+      _mismatches(0)
+  {
+    _g.create_model(model, input);
+  }
+  ~ch_validator() {}
+
+  // the number of pairs the two solvers disagree on: random pairs of
+  // nodes, and the ends of the edge the first point snaps onto, so 
+  // that pairs joined by one edge are covered too
+  size_t validate(size_t pairs, unsigned seed = 42)
+  {
+    std::mt19937 rng(seed);
+    std::uniform_real_distribution<double> lon(_min_lon, _max_lon);
+    std::uniform_real_distribution<double> lat(_min_lat, _max_lat);
+
+    size_t checked = 0, adjacent = 0;
+    _found = _mismatches = 0;
+    while (checked < pairs)
+    {
+      snapped_point s, t;
+      if (!_g.snap(lon(rng), lat(rng), s) ||
+          !_g.snap(lon(rng), lat(rng), t) || s.node == t.node)
+        continue;
+      checked++;
+      compare(s.node, t.node);
+      if (s.source != s.target) {
+        adjacent++;
+        compare(s.source, s.target);
+      }
+    }
+
+    std::cout << _ch << " / " << _dijkstra
+              << " #pairs = " << checked
+              << " #adjacent pairs = " << adjacent
+              << " #routes = " << _found
+              << " #mismatches = " << _mismatches
+              << std::endl;
+    return _mismatches;
+  }
+
+ private:
+  void compare(osm_id_t s, osm_id_t t)
+  {
+    const std::string strategy = "shortest_weight_function";
+    double ch  = length(_g.route_optimize(_ch, s, t, strategy));
+    double dij = length(_g.route_optimize(_dijkstra, s, t, strategy));
+    if (dij >= 0)
+      _found++;
+    if ((ch < 0) != (dij < 0) ||
+        std::abs(ch - dij) > 1e-6 * (1 + std::abs(dij)))
+    {
+      _mismatches++;
+      std::cout << s << " -> " << t
+                << ": " << _ch << " " << ch
+                << ", " << _dijkstra << " " << dij << std::endl;
+    }
+  }
+
+  // the length of the first route, -1 when there is none
+  static double length(optimized_routes routes)
+  {
+    if (routes.empty())
+      return -1;
+    double l = 0;
+    for (auto& e : routes.front().get_edges())
+      l += e.length;
+    return l;
+  }
+
+  std::string _ch;
+  std::string _dijkstra;
+  double      _min_lon;
+  double      _min_lat;
+  double      _max_lon;
+  double      _max_lat;
+  GraphT      _g;
+  size_t      _found;
+  size_t      _mismatches;
+
+};
+
+} // namespace gol
+
+int main(int argc, char* argv[]) {
+
+  if (argc < 6) {
+    std::cerr << "usage: " << argv[0]
+              << " file.pbf min_lon min_lat max_lon max_lat [pairs]"
+              << std::endl;
+    return 2;
+  }
+
+  double min_lon = atof(argv[2]), min_lat = atof(argv[3]);
+  double max_lon = atof(argv[4]), max_lat = atof(argv[5]);
+  size_t pairs   = argc > 6 ? atoi(argv[6]) : 500;
+
+  gol::ch_validator<gol::road_graphT> road(argv[1],
+    "road_compact_representation_model", "compact_ch", "compact_dijkstra",
+    min_lon, min_lat, max_lon, max_lat);
+  gol::ch_validator<gol::pedestrian_graphT> pedestrian(argv[1],
+    "pedestrian_simplified_model", "ch", "dijkstra",
+    min_lon, min_lat, max_lon, max_lat);
+  size_t mismatches = road.validate(pairs) + pedestrian.validate(pairs);
+
+  return mismatches == 0 ? 0 : 1;
+
+}
@@ -0,0 +1,198 @@
+
+#include <algorithm>
+#include <iomanip>
+#include <iostream>
+#include <queue>
+#include <random>
+
+#include "../engine.h"
+
+namespace gol {
+
+// compares the Pareto fronts of epsMOA* with epsilon 0 on random OD
+// pairs of the bicycle model, trips up to 1.5, 4 and 9 km in turn:
+// - the search pruned by the bounds of bicriterion_bound_heuristic,
+//   as BSP_gsolver runs it,
+// - the search with null_heuristic, as it ran before the bounds,
+// - a textbook label-setting search with no pruning but the ellipse.
+// The three fronts must be the same, and each path must add up to its
+// cost. The times of the ellipse, of the bounds and of the two epsMOA*
+// searches are printed apart
+class epsmoa_validator {
+  typedef typename std::decay<decltype(
+    std::declval<bicycle_graphT>().frozen_graph())>::type graph_t;
+  typedef decltype(
+    std::declval<bicycle_graphT>().weight_map(""))        weight_map_t;
+  typedef typename weight_map_t::value_type               weight_t;
+  typedef graph_t::vertex_descriptor                      vertex_t;
+  typedef graph_t::edge_descriptor                        edge_t;
+  typedef ellipse_region<graph_t>                         region_t;
+  typedef std::list<std::pair<weight_t, std::list<edge_t> > > pareto_set_t;
+
+ public:
+  epsmoa_validator(std::string input): _g()
+  {
+    _g.create_model("bicriterion_bicycle_model", input);
+  }
+  ~epsmoa_validator() {}
+
+  // the number of pairs with differing fronts or broken paths
+  size_t validate(size_t pairs, unsigned seed = 3)
+  {
+    const std::string strategy = "safest_fastest_bicycle_weight_function";
+    const graph_t& fg = _g.frozen_graph();
+    const uint32_t n  = boost::num_vertices(fg);
+    const double   trips[] = {1500, 4000, 9000};
+    weight_map_t weight_map = _g.weight_map(strategy);
+    std::mt19937 rng(seed);
+
+    size_t labels = 0, mismatches = 0;
+    double time[4] = {0, 0, 0, 0};
+    for (size_t k = 0; k < pairs; ++k)
+    {
+      vertex_t s = rng() % n, t;
+      do {
+        t = rng() % n;
+      } while (t == s || distance(fg[s].geo.lon, fg[s].geo.lat,
+                                  fg[t].geo.lon, fg[t].geo.lat) > trips[k % 3]);
+
+      stopwatch chrono;
+      region_t region(fg, s, t);
+      chrono.lap();
+      time[0] += chrono.lap_wall_time();
+      bicriterion_bound_heuristic<graph_t, weight_t> bound(
+        fg, t, weight_map, region);
+      chrono.lap();
+      time[1] += chrono.lap_wall_time();
+
+      pareto_set_t bounded, plain;
+      stats_t      stats;
+      chrono.lap();
+      bicriterion_epsMOA_star_algorithm::compute(
+        fg, s, t, region, bound, bounded, weight_map, stats, 0);
+      chrono.lap();
+      time[2] += chrono.lap_wall_time();
+
+      region_t                              ellipse(fg, s, t);
+      null_heuristic<graph_t, weight_t>     none;
+      chrono.lap();
+      bicriterion_epsMOA_star_algorithm::compute(
+        fg, s, t, ellipse, none, plain, weight_map, stats, 0);
+      chrono.lap();
+      time[3] += chrono.lap_wall_time();
+
+      std::vector<weight_t> exact = label_setting(s, t, ellipse, weight_map);
+      labels += exact.size();
+      if (front(s, t, bounded, weight_map) != exact ||
+          front(s, t, plain, weight_map) != exact)
+      {
+        mismatches++;
+        std::cout << s << " -> " << t << ": fronts of " << bounded.size()
+                  << ", " << plain.size() << " and " << exact.size()
+                  << " labels differ" << std::endl;
+      }
+    }
+
+    std::cout << "#pairs = " << pairs
+              << " #labels = " << labels
+              << " #mismatches = " << mismatches << std::endl
+              << std::fixed << std::setprecision(3)
+              << "ellipse " << 1000 * time[0] / pairs << " ms"
+              << " | bounds " << 1000 * time[1] / pairs << " ms"
+              << " | search with bounds " << 1000 * time[2] / pairs << " ms"
+              << " | without " << 1000 * time[3] / pairs << " ms"
+              << std::endl;
+    return mismatches;
+  }
+
+ private:
+  // the sorted costs of a front, none when a path is not a path from
+  // s to t of that cost
+  std::vector<weight_t> front(
+      vertex_t            s,
+      vertex_t            t,
+      const pareto_set_t& pareto_set,
+      weight_map_t        weight_map) const
+  {
+    const graph_t& fg = _g.frozen_graph();
+    std::vector<weight_t> costs;
+    for (auto& label : pareto_set)
+    {
+      weight_t cost = weight_t();
+      vertex_t v    = s;
+      for (edge_t e : label.second) {
+        if (boost::source(e, fg) != v)
+          return {};
+        cost = cost + get(weight_map, e);
+        v    = boost::target(e, fg);
+      }
+      if (v != t || cost != label.first)
+        return {};
+      costs.push_back(cost);
+    }
+    std::sort(costs.begin(), costs.end());
+    return costs;
+  }
+
+  // the sorted costs of the exact Pareto front within region: labels
+  // are settled by increasing cost, lexicographically, so that one is
+  // dominated iff its vertex has a settled label of no greater second
+  // criterion, and so is a label not better than those of t
+  std::vector<weight_t> label_setting(
+      vertex_t        s,
+      vertex_t        t,
+      const region_t& region,
+      weight_map_t    weight_map) const
+  {
+    typedef std::pair<weight_t, vertex_t> label_t;
+    const graph_t& fg = _g.frozen_graph();
+    const auto     none = std::numeric_limits<
+      typename weight_t::second_type>::max();
+    std::vector<typename weight_t::second_type>
+      settled(boost::num_vertices(fg), none);
+    std::priority_queue<
+      label_t, std::vector<label_t>, std::greater<label_t> > queue;
+    std::vector<weight_t> costs;
+
+    queue.push(label_t(weight_t(), s));
+    while (!queue.empty())
+    {
+      label_t l = queue.top(); queue.pop();
+      vertex_t u = l.second;
+      if (settled[u] <= l.first.second || settled[t] <= l.first.second)
+        continue;
+      settled[u] = l.first.second;
+      if (u == t) {
+        costs.push_back(l.first);
+        continue;
+      }
+      BGL_FORALL_OUTEDGES_T(u, e, fg, graph_t)
+      {
+        vertex_t v    = boost::target(e, fg);
+        weight_t cost = l.first + get(weight_map, e);
+        if (region.contains(v) && settled[v] > cost.second)
+          queue.push(label_t(cost, v));
+      }
+    }
+    return costs;
+  }
+
+  bicycle_graphT _g;
+
+};
+
+} // namespace gol
+
+int main(int argc, char* argv[]) {
+
+  if (argc < 2) {
+    std::cerr << "usage: " << argv[0] << " file.pbf [pairs]" << std::endl;
+    return 2;
+  }
+
+  gol::epsmoa_validator validator(argv[1]);
+  size_t pairs = argc > 2 ? atoi(argv[2]) : 30;
+
+  return validator.validate(pairs) == 0 ? 0 : 1;
+
+}
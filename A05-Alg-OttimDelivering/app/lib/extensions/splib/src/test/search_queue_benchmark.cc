@@ -0,0 +1,135 @@
+
+#include <iostream>
+#include <iomanip>
+#include <random>
+
+#include "../engine.h"
+
+namespace gol {
+
+// times the queue policies of graph_search_queue.h on random queries of
+// the road model: vertex and edge-based bidirectional Dijkstra and a
+// one-to-all Dijkstra every fourth query. The sums of the distances
+// must be the same for every policy; see default_search_queue
+class search_queue_benchmark {
+  typedef typename std::decay<decltype(
+    std::declval<road_graphT>().frozen_graph())>::type graph_t;
+  typedef decltype(
+    std::declval<road_graphT>().weight_map(""))        weight_map_t;
+  typedef graph_t::vertex_descriptor                   vertex_t;
+
+ public:
+  search_queue_benchmark(std::string input): _g()
+  {
+    _g.create_model("road_compact_representation_model", input);
+  }
+  ~search_queue_benchmark() {}
+
+  void run(std::string strategy, size_t queries, size_t runs = 2)
+  {
+    const graph_t& fg = _g.frozen_graph();
+    std::cout << strategy
+              << " |V| = " << boost::num_vertices(fg)
+              << " |E| = " << boost::num_edges(fg)
+              << std::endl;
+    weight_map_t weight_map = _g.weight_map(strategy);
+    for (size_t r = 0; r < runs; ++r)
+    {
+      bench<dary_heap_queue<2> >("2-ary", weight_map, queries);
+      bench<dary_heap_queue<4> >("4-ary", weight_map, queries);
+      bench<dary_heap_queue<8> >("8-ary", weight_map, queries);
+      bench<lazy_binary_heap_queue>("lazy", weight_map, queries);
+      bench<radix_heap_queue>("radix", weight_map, queries);
+    }
+  }
+
+ private:
+  template <typename QueueT>
+  void bench(std::string name, weight_map_t weight_map, size_t queries)
+  {
+    typedef double                                            distance_t;
+    typedef search_workspace<vertex_t, distance_t, QueueT>    vertex_ws_t;
+    typedef search_workspace<edge_index_t, distance_t, QueueT> edge_ws_t;
+
+    const graph_t& fg = _g.frozen_graph();
+    const uint32_t n  = boost::num_vertices(fg);
+    const uint32_t m  = boost::num_edges(fg);
+    const distance_t infinity = std::numeric_limits<distance_t>::max();
+    vertex_ws_t forward, backward, all;
+    edge_ws_t   eforward, ebackward;
+    std::mt19937 rng(11);
+
+    double sum[3]  = {0, 0, 0};
+    double time[3] = {0, 0, 0};
+    for (size_t q = 0; q < queries; ++q)
+    {
+      vertex_t s = rng() % n, t = rng() % n;
+      stats_t  stats;
+
+      stopwatch chrono;
+      forward.reset(n);
+      backward.reset(n);
+      auto r = bidirectional_dijkstra_algorithm::compute(
+        fg, s, t, forward, backward, weight_map, stats);
+      chrono.lap();
+      time[0] += chrono.lap_wall_time();
+      if (r.second < infinity)
+        sum[0] += r.second;
+
+      chrono.lap();
+      eforward.reset(m);
+      ebackward.reset(m);
+      auto er = compact_graph_bidirectional_dijkstra_algorithm::compute(
+        fg, s, t, eforward, ebackward, weight_map, stats);
+      chrono.lap();
+      time[1] += chrono.lap_wall_time();
+      if (er.second < infinity)
+        sum[1] += er.second;
+
+      if (q % 4 == 0)
+      {
+        null_stopping_criteria<graph_t> vis;
+        chrono.lap();
+        all.reset(n);
+        dijkstra_algorithm::search(fg, s, all, weight_map, vis);
+        chrono.lap();
+        time[2] += chrono.lap_wall_time();
+        for (vertex_t v : all.touched())
+          sum[2] += all.distance(v);
+      }
+    }
+
+    std::cout << std::setw(8) << std::left << name << std::fixed
+              << " bidirectional " << std::setprecision(3)
+              << 1000 * time[0] / queries << " ms ("
+              << std::setprecision(1) << sum[0] << ")"
+              << " | arc bidirectional " << std::setprecision(3)
+              << 1000 * time[1] / queries << " ms ("
+              << std::setprecision(1) << sum[1] << ")"
+              << " | one-to-all " << std::setprecision(3)
+              << 4000 * time[2] / queries << " ms ("
+              << std::setprecision(1) << sum[2] << ")"
+              << std::endl;
+  }
+
+  road_graphT _g;
+
+};
+
+} // namespace gol
+
+int main(int argc, char* argv[]) {
+
+  if (argc < 2) {
+    std::cerr << "usage: " << argv[0] << " file.pbf [queries]" << std::endl;
+    return 2;
+  }
+
+  gol::search_queue_benchmark benchmark(argv[1]);
+  size_t queries = argc > 2 ? atoi(argv[2]) : 200;
+  benchmark.run("shortest_weight_function",     queries);
+  benchmark.run("fastest_road_weight_function", queries);
+
+  return 0;
+
+}
@@ -0,0 +1,402 @@
+// This file is part of Sii-Mobility - Algorithms Optimized Delivering.
+//
+// Copyright (C) 2017 GOL Lab http://webgol.dinfo.unifi.it/ - University of Florence
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with This program.  If not, see <http://www.gnu.org/licenses/>.
+
+#ifndef GOL_TOUR_OPTIMIZER_H_
+#define GOL_TOUR_OPTIMIZER_H_
+
+// std
+#include <vector>
+#include <limits>
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <mutex>
+#include <random>
+#include <stdint.h>
+
+#include "../common.h"
+#include "../utils/work_stealing_pool.h"
+
+namespace gol {
+
+// a stop of a delivery tour, times are seconds from the departure of 
+// the vehicles from the depot
+struct tour_stop
+{
+  osm_id_t node;
+  double   demand       = 0;
+  double   service_time = 0;
+  double   ready_time   = 0;    // service starts no earlier
+  double   due_time     =       // nor later
+    std::numeric_limits<double>::infinity();
+};
+
+// stops of every vehicle in visiting order, as indexes into the stops
+// of the problem; stops no vehicle can serve in time are unassigned
+struct tour_solution
+{
+  std::vector<std::vector<uint32_t> > tours;
+  std::vector<uint32_t>               unassigned;
+  double                              cost = 0;
+};
+
+// Vehicle routing with time windows and capacity on travel matrices.
+// Locations are the depot (0) and the stops (1..n); cost and time are
+// row-major over them: cost is minimized, time checks the windows. 
+// Tours are built by cheapest feasible insertion and taken to a local
+// optimum by relocate, or-opt and 2-opt. Then every worker of the pool
+// runs an iterated local search from that optimum until the time 
+// budget: some stops are taken out at random, by a seed of its own, 
+// and inserted again. The best solution of all the searches is kept.
+class tour_optimizer_t
+{
+  typedef std::vector<uint32_t>            tour_t;  // locations, no depot
+  typedef std::chrono::steady_clock        clock_t;
+
+  struct state_t
+  {
+    std::vector<tour_t>   tours;
+    std::vector<double>   loads;
+    std::vector<uint32_t> unassigned;  // locations
+    double                cost;
+
+    // fewer unassigned stops first, then cheaper
+    bool better_than(const state_t& o) const {
+      return unassigned.size() != o.unassigned.size() ?
+        unassigned.size() < o.unassigned.size() : cost < o.cost - 1e-9;
+    }
+  };
+
+ public:
+  tour_optimizer_t(
+      const std::vector<tour_stop>& stops,
+      const std::vector<double>&    cost,
+      const std::vector<double>&    time,
+      unsigned                      vehicles,
+      double                        capacity):
+    _stops(stops),
+    _cost(cost),
+    _time(time),
+    _n(stops.size() + 1),
+    _vehicles(std::max(1u, vehicles)),
+    _capacity(capacity) 
+  {
+    if (_cost.size() != _n * _n || _time.size() != _n * _n)
+      throw solver_exception(
+        "tour_optimizer_t(): matrices do not match the stops");
+  }
+
+  tour_solution solve(double time_budget = TOUR_TIME_BUDGET) const
+  {
+    const clock_t::time_point deadline = clock_t::now() + 
+      std::chrono::duration_cast<clock_t::duration>(
+        std::chrono::duration<double>(time_budget));
+
+    const state_t optimum = local_search(construct(), deadline);
+    state_t       best    = optimum;
+    std::mutex    best_mtx;
+
+    work_stealing_pool& pool = work_stealing_pool::instance();
+    pool.parallel_for(pool.size(), [&](unsigned /*w*/, size_t i) {
+      std::mt19937 rng(i);
+      state_t local_best = optimum;
+      // a few stops are left at their local optimum
+      while (_n > 4 && clock_t::now() < deadline)
+      {
+        state_t s = local_best;
+        perturb(s, rng);
+        s = local_search(s, deadline);
+        if (s.better_than(local_best))
+          local_best = s;
+      }
+      std::lock_guard<std::mutex> lock(best_mtx);
+      if (local_best.better_than(best))
+        best = local_best;
+    });
+
+    tour_solution sol;
+    for (const tour_t& t : best.tours)
+    {
+      if (t.empty())
+        continue;
+      sol.tours.push_back(tour_t());
+      for (uint32_t x : t)
+        sol.tours.back().push_back(x - 1);
+    }
+    for (uint32_t x : best.unassigned)
+      sol.unassigned.push_back(x - 1);
+    sol.cost = best.cost;
+    return sol;
+  }
+
+ private:
+  double c(uint32_t a, uint32_t b) const { return _cost[a * _n + b]; }
+  double t(uint32_t a, uint32_t b) const { return _time[a * _n + b]; }
+
+  double demand(uint32_t x) const { return _stops[x - 1].demand; }
+
+  // location at position i of a tour with the depot at both ends
+  static uint32_t at(const tour_t& r, size_t i) {
+    return (i == 0 || i > r.size()) ? 0 : r[i - 1]; }
+
+  double tour_cost(const tour_t& r) const
+  {
+    double sum = 0;
+    for (size_t i = 0; i <= r.size(); ++i)
+      sum += c(at(r, i), at(r, i + 1));
+    return sum;
+  }
+
+  // every stop is served within its time window
+  bool on_time(const tour_t& r) const
+  {
+    double clock = 0;
+    for (size_t i = 0; i < r.size(); ++i)
+    {
+      const tour_stop& s = _stops[r[i] - 1];
+      clock += t(at(r, i), r[i]);
+      if (!std::isfinite(clock) || clock > s.due_time)
+        return false;
+      clock = std::max(clock, s.ready_time) + s.service_time;
+    }
+    return std::isfinite(clock + t(at(r, r.size()), 0));
+  }
+
+  // cheapest feasible insertion of location x, false if none
+  bool insert(state_t& s, uint32_t x) const
+  {
+    struct candidate { double delta; size_t tour; size_t pos; };
+    std::vector<candidate> cands;
+    bool empty_tried = false;
+    for (size_t k = 0; k < s.tours.size(); ++k)
+    {
+      const tour_t& r = s.tours[k];
+      if (s.loads[k] + demand(x) > _capacity)
+        continue;
+      // empty tours are alike, one is enough
+      if (r.empty() && empty_tried) 
+        continue;
+      empty_tried |= r.empty();
+      for (size_t i = 0; i <= r.size(); ++i)
+      {
+        uint32_t a = at(r, i), b = at(r, i + 1);
+        double delta = c(a, x) + c(x, b) - c(a, b);
+        if (std::isfinite(delta))
+          cands.push_back({delta, k, i});
+      }
+    }
+    std::sort(cands.begin(), cands.end(), 
+      [](const candidate& l, const candidate& r) { return l.delta < r.delta; });
+    for (const candidate& cd : cands)
+    {
+      tour_t r = s.tours[cd.tour];
+      r.insert(r.begin() + cd.pos, x);
+      if (on_time(r))
+      {
+        s.tours[cd.tour] = std::move(r);
+        s.loads[cd.tour] += demand(x);
+        s.cost += cd.delta;
+        return true;
+      }
+    }
+    return false;
+  }
+
+  // stops by due time, each at its cheapest feasible position
+  state_t construct() const
+  {
+    state_t s;
+    s.tours.assign(_vehicles, tour_t());
+    s.loads.assign(_vehicles, 0);
+    s.cost = 0;
+    std::vector<uint32_t> order;
+    for (uint32_t x = 1; x < _n; ++x)
+      order.push_back(x);
+    std::stable_sort(order.begin(), order.end(), 
+      [this](uint32_t a, uint32_t b) { 
+        return _stops[a - 1].due_time < _stops[b - 1].due_time; });
+    for (uint32_t x : order)
+      if (!insert(s, x))
+        s.unassigned.push_back(x);
+    return s;
+  }
+
+  // takes out some stops at random and inserts them again
+  void perturb(state_t& s, std::mt19937& rng) const
+  {
+    std::vector<uint32_t> out(s.unassigned);
+    s.unassigned.clear();
+    const size_t n_ruin = 
+      std::max<size_t>(2, (_n - 1) * TOUR_RUIN_PERCENT / 100);
+    for (size_t k = 0; k < n_ruin; ++k)
+    {
+      std::vector<size_t> used;
+      for (size_t r = 0; r < s.tours.size(); ++r)
+        if (!s.tours[r].empty())
+          used.push_back(r);
+      if (used.empty())
+        break;
+      size_t  r = used[rng() % used.size()];
+      tour_t& tr = s.tours[r];
+      size_t  i = rng() % tr.size();
+      out.push_back(tr[i]);
+      s.loads[r] -= demand(tr[i]);
+      tr.erase(tr.begin() + i);
+    }
+    std::shuffle(out.begin(), out.end(), rng);
+    s.cost = 0;
+    for (const tour_t& r : s.tours)
+      s.cost += tour_cost(r);
+    for (uint32_t x : out)
+      if (!insert(s, x))
+        s.unassigned.push_back(x);
+  }
+
+  // first improvements until none is left or the deadline
+  state_t local_search(state_t s, clock_t::time_point deadline) const
+  {
+    while (clock_t::now() < deadline)
+    {
+      bool improved = false;
+      for (size_t len = 1; len <= 3 && !improved; ++len)
+        improved = move_segment(s, len);
+      if (!improved)
+        improved = two_opt(s);
+      if (!improved)
+      {
+        // room made by the moves may fit unassigned stops
+        std::vector<uint32_t> out;
+        out.swap(s.unassigned);
+        for (uint32_t x : out)
+          if (insert(s, x))
+            improved = true;
+          else
+            s.unassigned.push_back(x);
+      }
+      if (!improved)
+        break;
+    }
+    return s;
+  }
+
+  // relocate (len 1) and or-opt (len 2, 3): a segment of a tour is
+  // moved to another place of the same or of another tour
+  bool move_segment(state_t& s, size_t len) const
+  {
+    for (size_t ka = 0; ka < s.tours.size(); ++ka)
+    {
+      const tour_t& ra = s.tours[ka];
+      for (size_t i = 0; i + len <= ra.size(); ++i)
+      {
+        uint32_t first = ra[i], last = ra[i + len - 1];
+        uint32_t p = at(ra, i), nx = at(ra, i + len + 1);
+        double load = 0;
+        for (size_t j = i; j < i + len; ++j)
+          load += demand(ra[j]);
+        double removal = c(p, first) + c(last, nx) - c(p, nx);
+
+        for (size_t kb = 0; kb < s.tours.size(); ++kb)
+        {
+          const tour_t& rb = s.tours[kb];
+          if (kb != ka && s.loads[kb] + load > _capacity)
+            continue;
+          for (size_t j = 0; j <= rb.size(); ++j)
+          {
+            // gaps next to or inside the segment leave it in place
+            if (kb == ka && j >= i && j <= i + len)
+              continue;
+            uint32_t a = at(rb, j), b = at(rb, j + 1);
+            double delta = c(a, first) + c(last, b) - c(a, b) - removal;
+            if (!(delta < -1e-9))
+              continue;
+
+            tour_t na = ra, nb;
+            tour_t seg(ra.begin() + i, ra.begin() + i + len);
+            na.erase(na.begin() + i, na.begin() + i + len);
+            if (kb == ka) 
+            {
+              size_t pos = j > i ? j - len : j;
+              na.insert(na.begin() + pos, seg.begin(), seg.end());
+              if (!on_time(na))
+                continue;
+            } 
+            else 
+            {
+              nb = rb;
+              nb.insert(nb.begin() + j, seg.begin(), seg.end());
+              if (!on_time(na) || !on_time(nb))
+                continue;
+              s.tours[kb] = std::move(nb);
+              s.loads[kb] += load;
+              s.loads[ka] -= load;
+            }
+            s.tours[ka] = std::move(na);
+            s.cost += delta;
+            return true;
+          }
+        }
+      }
+    }
+    return false;
+  }
+
+  // reverses a part of a tour, costs may be asymmetric: prefix sums of
+  // the tour walked forward and backward price a reversal in O(1)
+  bool two_opt(state_t& s) const
+  {
+    for (size_t k = 0; k < s.tours.size(); ++k)
+    {
+      const tour_t& r = s.tours[k];
+      const size_t  m = r.size() + 2;   // with the depots
+      std::vector<double> fwd(m, 0), bwd(m, 0);
+      for (size_t i = 1; i < m; ++i) {
+        fwd[i] = fwd[i - 1] + c(at(r, i - 1), at(r, i));
+        bwd[i] = bwd[i - 1] + c(at(r, i), at(r, i - 1));
+      }
+      for (size_t i = 1; i + 1 < m; ++i)
+        for (size_t j = i + 1; j + 1 < m; ++j)
+        {
+          uint32_t a = at(r, i - 1), b = at(r, j + 1);
+          double delta = 
+            c(a, at(r, j)) + (bwd[j] - bwd[i]) + c(at(r, i), b) -
+            c(a, at(r, i)) - (fwd[j] - fwd[i]) - c(at(r, j), b);
+          if (!(delta < -1e-9))
+            continue;
+          tour_t nr = r;
+          std::reverse(nr.begin() + i - 1, nr.begin() + j);
+          if (!on_time(nr))
+            continue;
+          s.tours[k] = std::move(nr);
+          s.cost += delta;
+          return true;
+        }
+    }
+    return false;
+  }
+
+  const std::vector<tour_stop>& _stops;
+  const std::vector<double>&    _cost;
+  const std::vector<double>&    _time;
+  const size_t                  _n;         // locations, depot included
+  const unsigned                _vehicles;
+  const double                  _capacity;
+
+};
+
+} // namespace gol
+
+#endif // GOL_TOUR_OPTIMIZER_H_
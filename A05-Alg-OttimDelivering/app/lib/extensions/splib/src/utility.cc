@@ -16,6 +16,7 @@
 // along with This program.  If not, see <http://www.gnu.org/licenses/>.
 
 #include "utility.h"
+#include "exception.h"
 
 namespace gol {
 
@@ -101,5 +102,13 @@ std::string to_osm_nd(const std::string& nd) {
   return s.substr(s.find("n", 0) + 1, s.length());
 }
 
+osm_id_t to_osm_id(const std::string& nd) {
+  try {
+    return std::stoll(to_osm_nd(nd));
+  } catch (std::exception& e) {
+    throw data_exception("to_osm_id(): invalid node " + nd);
+  }
+}
+
 
 }  // namespace gol
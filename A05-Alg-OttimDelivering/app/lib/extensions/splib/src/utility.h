@@ -34,6 +34,7 @@ XERCES_CPP_NAMESPACE_USE
 // time format 
 typedef int      time_Rt;
 typedef uint32_t edge_index_t;	// TODO: move
+typedef int64_t  osm_id_t;      // OSM node identifier
 
 std::string ch16tostr(const XMLCh* ch16);
 bool ch16strcmp(const XMLCh* ch16, std::string str);
@@ -44,6 +45,7 @@ time_Rt to_rtime(const std::string& str_time, const std::string& today);
 std::string to_string(const time_Rt time);
 
 std::string to_osm_nd(const std::string& nd);
+osm_id_t to_osm_id(const std::string& nd);
 
 }  // namespace gol
 
@@ -0,0 +1,232 @@
+// This file is part of Sii-Mobility - Algorithms Optimized Delivering.
+//
+// Copyright (C) 2017 GOL Lab http://webgol.dinfo.unifi.it/ - University of Florence
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with This program.  If not, see <http://www.gnu.org/licenses/>.
+
+#ifndef GOL_UTILS_WORK_STEALING_POOL_H_
+#define GOL_UTILS_WORK_STEALING_POOL_H_
+
+// std
+#include <algorithm>
+#include <condition_variable>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include <stdint.h>
+
+namespace gol {
+
+// Threads of the process, one per core, running the jobs of a loop.
+// Every worker starts on an equal share of the indexes and works it
+// from the front; once done it steals the back half of the share of
+// another worker, so jobs of uneven cost keep all cores busy. The
+// caller is worker 0. A loop started from within a job runs inline.
+class work_stealing_pool
+{
+ public:
+  typedef std::function<void(unsigned, size_t)> job_t;
+
+  static work_stealing_pool& instance()
+  {
+    static work_stealing_pool pool(
+      std::max(1u, std::thread::hardware_concurrency()));
+    return pool;
+  }
+
+  // workers, job indexes by worker are within [0, size())
+  unsigned size() const { return _shares.size(); }
+
+  // job(worker, i) for i in [0, count), returns once all are done;
+  // the first exception thrown by a job is rethrown here, the jobs
+  // not yet started are skipped
+  void parallel_for(size_t count, job_t job)
+  {
+    if (count == 0)
+      return;
+    if (in_job() || size() == 1 || count == 1)
+    {
+      for (size_t i = 0; i < count; ++i)
+        job(0, i);
+      return;
+    }
+
+    std::lock_guard<std::mutex> batch(_batch);
+    const unsigned n = size();
+    for (unsigned w = 0; w < n; ++w)
+    {
+      std::lock_guard<std::mutex> l(_shares[w]->lock);
+      _shares[w]->begin = count * w / n;
+      _shares[w]->end   = count * (w + 1) / n;
+    }
+    {
+      std::lock_guard<std::mutex> l(_lock);
+      _job    = &job;
+      _error  = nullptr;
+      _active = n - 1;
+      ++_generation;
+    }
+    _start.notify_all();
+
+    run(0);
+    std::unique_lock<std::mutex> l(_lock);
+    _done.wait(l, [this]() { return _active == 0; });
+    _job = nullptr;
+    if (_error)
+      std::rethrow_exception(_error);
+  }
+
+  ~work_stealing_pool()
+  {
+    {
+      std::lock_guard<std::mutex> l(_lock);
+      _stop = true;
+    }
+    _start.notify_all();
+    for (auto& t : _threads)
+      t.join();
+  }
+
+ private:
+  // indexes [begin, end) left to a worker
+  struct share_t
+  {
+    std::mutex lock;
+    size_t     begin = 0;
+    size_t     end   = 0;
+  };
+
+  explicit work_stealing_pool(unsigned n)
+      : _shares(),
+        _threads(),
+        _batch(),
+        _lock(),
+        _start(),
+        _done(),
+        _job(nullptr),
+        _error(nullptr),
+        _active(0),
+        _generation(0),
+        _stop(false)
+  {
+    for (unsigned w = 0; w < n; ++w)
+      _shares.emplace_back(new share_t());
+    for (unsigned w = 1; w < n; ++w)
+      _threads.emplace_back(&work_stealing_pool::loop, this, w);
+  }
+
+  work_stealing_pool(const work_stealing_pool&);
+  void operator=(const work_stealing_pool&);
+
+  static bool& in_job()
+  {
+    static thread_local bool flag = false;
+    return flag;
+  }
+
+  void loop(unsigned w)
+  {
+    uint64_t seen = 0;
+    while (true)
+    {
+      {
+        std::unique_lock<std::mutex> l(_lock);
+        _start.wait(l, [&]() { return _stop || _generation != seen; });
+        if (_stop)
+          return;
+        seen = _generation;
+      }
+      run(w);
+      {
+        std::lock_guard<std::mutex> l(_lock);
+        --_active;
+      }
+      _done.notify_one();
+    }
+  }
+
+  void run(unsigned w)
+  {
+    in_job() = true;
+    size_t i;
+    while (next(w, i))
+    {
+      try {
+        (*_job)(w, i);
+      } catch (...) {
+        std::lock_guard<std::mutex> l(_lock);
+        if (!_error)
+          _error = std::current_exception();
+        for (auto& s : _shares) {
+          std::lock_guard<std::mutex> sl(s->lock);
+          s->begin = s->end;
+        }
+      }
+    }
+    in_job() = false;
+  }
+
+  // next index of worker w, from its own share or stolen
+  bool next(unsigned w, size_t& i)
+  {
+    share_t& own = *_shares[w];
+    {
+      std::lock_guard<std::mutex> l(own.lock);
+      if (own.begin < own.end) {
+        i = own.begin++;
+        return true;
+      }
+    }
+    const unsigned n = size();
+    for (unsigned k = 1; k < n; ++k)
+    {
+      share_t& victim = *_shares[(w + k) % n];
+      size_t begin, end;
+      {
+        std::lock_guard<std::mutex> l(victim.lock);
+        if (victim.begin >= victim.end)
+          continue;
+        end   = victim.end;
+        begin = victim.begin + (victim.end - victim.begin) / 2;
+        victim.end = begin;
+      }
+      std::lock_guard<std::mutex> l(own.lock);
+      i         = begin;
+      own.begin = begin + 1;
+      own.end   = end;
+      return true;
+    }
+    return false;
+  }
+
+  std::vector<std::unique_ptr<share_t> > _shares;
+  std::vector<std::thread>               _threads;
+  std::mutex                             _batch;   // a loop at a time
+  std::mutex                             _lock;
+  std::condition_variable                _start;
+  std::condition_variable                _done;
+  const job_t*                           _job;
+  std::exception_ptr                     _error;
+  unsigned                               _active;
+  uint64_t                               _generation;
+  bool                                   _stop;
+
+};
+
+}  // namespace gol
+
+#endif // GOL_UTILS_WORK_STEALING_POOL_H_
@@ -0,0 +1,4 @@
+require_relative 'app/lib/extensions/sii_mobility_api'
+
+# builds the graph images shared read-only by the web workers
+routePlanner = RoutePlanner.new false
\ No newline at end of file
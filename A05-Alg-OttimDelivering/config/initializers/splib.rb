@@ -1,3 +1,4 @@
 require_relative '../../app/lib/extensions/sii_mobility_api'
 
-$routePlanner = RoutePlanner.new false
\ No newline at end of file
+# workers map the graph images built by build_models.rb or update_OSMdb.rb
+$routePlanner = RoutePlanner.new false, true
\ No newline at end of file